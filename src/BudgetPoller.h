@@ -0,0 +1,259 @@
+/**
+ * @file BudgetPoller.h
+ * @author Ed Ablan
+ * @version 1.0
+ * @date 10/17/2026
+ *
+ * @brief Checks the buttons of a large ButtonRegistry a few at a time, within
+ * a budget of micro secs per call
+ *
+ * @details With hundreds of buttons behind expanders or a matrix one
+ * poll_all() can take longer than the loop may block. poll() checks buttons
+ * until the budget is spent and the next call resumes where it stopped. The
+ * buttons that are mid-bounce or mid-sequence (ButtonSequence::is_active())
+ * are checked first, then the round robin sweep over every button continues.
+ * The sweep moves at least one button per call, so a budget spent on active
+ * buttons slows the idle ones down but never stops them. A button is checked
+ * at most once per call. The budget is checked after each button, a call
+ * overruns it by at most two checks: the one that spent it and, if that was
+ * an active button, the sweep check that is always made.
+ *
+ * Reported are the share of the buttons checked per call, the time of the
+ * last complete sweep, the longest call and the longest time any button went
+ * unchecked. Like ButtonRegistry everything is reserved in the poller,
+ * nothing is allocated
+ *
+ * @copyright Copyright (c) 2020 Particle Industries, Inc.  All rights reserved.
+ */
+#pragma once
+
+#include <string.h>
+
+#include "ButtonPrint.h"
+#include "ButtonRegistry.h"
+
+struct BudgetPollerStats {
+    uint32_t calls;
+    uint32_t checks;            //check_button() calls
+    uint32_t priority_checks;   //checks of active buttons ahead of the sweep
+    uint32_t sweeps;            //complete round robin passes
+    uint32_t sweep_us;          //duration of the last complete pass
+    uint32_t max_call_us;       //longest poll(), budget plus up to 2 checks
+    uint32_t max_revisit_us;    //longest time between two checks of a button
+};
+
+template <size_t N>
+class BudgetPoller {
+public:
+
+    /**
+     * @brief Constructor for class
+     *
+     * @param[in] registry - buttons to poll, buttons added later are picked
+     * up by the sweep
+     */
+    explicit BudgetPoller(ButtonRegistry<N>& registry)
+        : _registry(registry)
+        , _cursor(0)
+        , _active_cursor(0)
+        , _sweep_start(micros())
+        , _stats() {
+        memset(_last_check, 0, sizeof(_last_check));
+        memset(_checked, 0, sizeof(_checked));
+        memset(_active, 0, sizeof(_active));
+        memset(_priority, 0, sizeof(_priority));
+    }
+
+    BudgetPoller(const BudgetPoller&) = delete;
+    BudgetPoller& operator=(const BudgetPoller&) = delete;
+
+    /**
+     * @brief Check buttons until the budget is spent, call every loop
+     *
+     * @details Calls check_button() on the active buttons, then on the next
+     * buttons of the sweep, and on_sequence for every non zero result. At
+     * least one button of the sweep is checked even with a budget of 0
+     *
+     * @param[in] budget_us - micro secs the call may take
+     * @param[in] on_sequence - callable taking (size_t index, int sequence)
+     *
+     * @return number of sequences decoded
+     */
+    template <typename F>
+    int poll(uint32_t budget_us, F&& on_sequence) {
+        size_t count = _registry.size();
+        if(!count) {
+            return 0;
+        }
+        if(_cursor >= count) {_cursor = 0;}
+        if(_active_cursor >= count) {_active_cursor = 0;}
+
+        uint32_t start = micros();
+        uint32_t now = start;
+        bool spent = false;
+        int decoded = 0;
+        _stats.calls++;
+
+        //active buttons from where the last call stopped, each at most once
+        size_t first = _active_cursor;
+        size_t i = next_active(first, count);
+        bool wrapped = false;
+        while(!spent) {
+            if(i >= ((wrapped) ? first : count)) {
+                if(wrapped || !first) {
+                    break;
+                }
+                wrapped = true;
+                i = next_active(0, first);
+                continue;
+            }
+            decoded += check(i, now, on_sequence);
+            assign(_priority, i, true);
+            _stats.priority_checks++;
+            _active_cursor = i + 1;
+            now = micros();
+            spent = now - start >= budget_us;
+            i = next_active(i + 1, (wrapped) ? first : count);
+        }
+
+        //the sweep, at least one button so idle ones are never starved
+        bool moved = false;
+        for(size_t steps = 0; steps < count && (!spent || !moved); steps++) {
+            i = _cursor;
+            //checked by the active pass of this call
+            if(!is_set(_priority, i)) {
+                decoded += check(i, now, on_sequence);
+                moved = true;
+                now = micros();
+                spent = now - start >= budget_us;
+            }
+            _cursor = (i + 1 < count) ? i + 1 : 0;
+            if(!_cursor) {
+                _stats.sweeps++;
+                _stats.sweep_us = now - _sweep_start;
+                _sweep_start = now;
+            }
+        }
+        memset(_priority, 0, sizeof(_priority));
+
+        if(now - start > _stats.max_call_us) {
+            _stats.max_call_us = now - start;
+        }
+        return decoded;
+    }
+
+    /**
+     * @brief Get the counters since the last reset_stats()
+     *
+     * @return the counters
+     */
+    BudgetPollerStats stats() const {
+        return _stats;
+    }
+
+    /**
+     * @brief Get the share of the buttons checked per call since the last
+     * reset_stats()
+     *
+     * @return percent of the registry checked per call, on average
+     */
+    uint32_t coverage() const {
+        uint64_t possible = (uint64_t)_stats.calls * _registry.size();
+        return (possible) ? (uint64_t)_stats.checks * 100 / possible : 0;
+    }
+
+    /**
+     * @brief Print "POLL <buttons> <calls> <coverage %> <sweeps> <sweep us>
+     * <max call us> <max revisit us>"
+     *
+     * @param[in] out - where to print, e.g. Serial
+     */
+    void print(Print& out) const {
+        button_print_line(out, "POLL %u %lu %lu %lu %lu %lu %lu\r\n",
+                (unsigned)_registry.size(), (unsigned long)_stats.calls,
+                (unsigned long)coverage(), (unsigned long)_stats.sweeps,
+                (unsigned long)_stats.sweep_us,
+                (unsigned long)_stats.max_call_us,
+                (unsigned long)_stats.max_revisit_us);
+    }
+
+    /**
+     * @brief Zero the counters, the sweep in progress is timed from now
+     */
+    void reset_stats() {
+        _stats = BudgetPollerStats{};
+        _sweep_start = micros();
+    }
+
+private:
+    static constexpr size_t WORDS = (N + 31) / 32;
+
+    static bool is_set(const uint32_t* bits, size_t i) {
+        return (bits[i / 32] >> (i % 32)) & 1;
+    }
+
+    static void assign(uint32_t* bits, size_t i, bool value) {
+        uint32_t bit = 1UL << (i % 32);
+        bits[i / 32] = (value) ? (bits[i / 32] | bit) : (bits[i / 32] & ~bit);
+    }
+
+    /**
+     * @brief Find the next active button
+     *
+     * @param[in] from - first index to look at
+     * @param[in] end - index to stop at
+     *
+     * @return index of the button, end if none is active
+     */
+    size_t next_active(size_t from, size_t end) const {
+        for(size_t w = from / 32; w * 32 < end; w++) {
+            uint32_t bits = _active[w];
+            if(w == from / 32) {
+                bits &= 0xFFFFFFFF << (from % 32);
+            }
+            if(bits) {
+                size_t i = w * 32 + __builtin_ctz(bits);
+                return (i < end) ? i : end;
+            }
+        }
+        return end;
+    }
+
+    /**
+     * @brief Check one button and track its activity and revisit time
+     *
+     * @param[in] i - index of the button
+     * @param[in] now - micro sec time of the check
+     * @param[in] on_sequence - callable taking (size_t index, int sequence)
+     *
+     * @return 1 if a sequence was decoded, otherwise 0
+     */
+    template <typename F>
+    int check(size_t i, uint32_t now, F&& on_sequence) {
+        ButtonSequence* button = _registry.at(i);
+        if(is_set(_checked, i) && now - _last_check[i] > _stats.max_revisit_us) {
+            _stats.max_revisit_us = now - _last_check[i];
+        }
+        _last_check[i] = now;
+        assign(_checked, i, true);
+        _stats.checks++;
+
+        int sequence = button->check_button();
+        assign(_active, i, button->is_active());
+        if(sequence) {
+            on_sequence(i, sequence);
+            return 1;
+        }
+        return 0;
+    }
+
+    ButtonRegistry<N>& _registry;
+    size_t _cursor;                 //next button of the sweep
+    size_t _active_cursor;          //where the active pass resumes
+    uint32_t _sweep_start;
+    BudgetPollerStats _stats;
+    uint32_t _last_check[N];        //micro secs
+    uint32_t _checked[WORDS];       //checked at least once
+    uint32_t _active[WORDS];        //active after the last check
+    uint32_t _priority[WORDS];      //checked by the active pass of this call
+};
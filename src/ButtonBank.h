@@ -0,0 +1,270 @@
+/**
+ * @file ButtonBank.h
+ * @author Ed Ablan
+ * @version 1.0
+ * @date 10/17/2026
+ *
+ * @brief Sequence decoding for up to 32 buttons that are read together as
+ * one word, such as a shift register chain or an I/O expander port
+ *
+ * @details The word is debounced by one DebounceBank and bit i feeds button
+ * i, a ButtonSequence constructed in place for debounced input (see
+ * ButtonSequence::check_debounced()). A poll reads the hardware once for the
+ * whole bank and only the buttons whose debounced bit changed or that have a
+ * sequence in progress are checked. The bank keeps a summary of whether any
+ * bit is settling or any button has a deadline pending; while neither is
+ * true and the word equals the last debounced word, update() returns after
+ * that one compare. Like ButtonRegistry the storage of all N buttons is
+ * reserved in the bank, nothing is allocated
+ *
+ * @copyright Copyright (c) 2020 Particle Industries, Inc.  All rights reserved.
+ */
+#pragma once
+
+#include <new>
+#include <type_traits>
+
+#include "ButtonSequence.h"
+#include "DebounceBank.h"
+
+template <size_t N>
+class ButtonBank {
+public:
+    static_assert(N >= 1 && N <= DEBOUNCE_BANK_WIDTH,
+                    "a bank holds 1 to 32 buttons");
+
+    /**
+     * @brief Constructor for class, the buttons are constructed by begin()
+     *
+     * @param[in] active_level - logic level of a pressed button, for every
+     * bit
+     * @param[in] debounce_interval - milli sec debounce time
+     * @param[in] long_duration_interval - milli sec long click time
+     */
+    ButtonBank(ActiveLevel active_level,
+                system_tick_t debounce_interval = DEFAULT_DEBOUNCE_MS,
+                system_tick_t long_duration_interval = DEFAULT_LONG_CLICK_MS)
+        : _active_level(active_level)
+        , _debounce_interval(debounce_interval)
+        , _long_duration_interval(long_duration_interval)
+        , _begun(false)
+        , _busy(false)
+        , _active(0)
+        , _stable(0) {}
+
+    /**
+     * @brief Destructor, destroys the buttons
+     */
+    ~ButtonBank() {
+        end();
+    }
+
+    ButtonBank(const ButtonBank&) = delete;
+    ButtonBank& operator=(const ButtonBank&) = delete;
+
+    /**
+     * @brief Construct the buttons from the first word read
+     *
+     * @details Call once the hardware is set up, e.g. from setup(). Calling
+     * it again starts over from the new word
+     *
+     * @param[in] initial_word - input word at start up, bit i is button i
+     */
+    void begin(uint32_t initial_word) {
+        end();
+        initial_word &= mask();
+        _debounce.attach(initial_word, _debounce_interval);
+        _active = 0;
+        for(size_t i = 0; i < N; i++) {
+            new (&_storage[i]) ButtonSequence(_active_level,
+                            (initial_word >> i) & 1, _long_duration_interval);
+            if(at_begun(i)->is_active()) {
+                _active |= 1UL << i;
+            }
+        }
+        _stable = initial_word;
+        _busy = _active != 0;
+        _begun = true;
+    }
+
+    /**
+     * @brief Debounce a word and check the buttons
+     *
+     * @details Calls on_sequence for every non zero check_debounced() result.
+     * Bits above N are ignored. The buttons are only tracked through
+     * update(), check a button from at() only for its callbacks
+     *
+     * @param[in] word - input word, bit i is button i
+     * @param[in] now - milli sec time the word was read
+     * @param[in] on_sequence - callable taking (size_t index, int sequence)
+     *
+     * @return number of sequences decoded
+     */
+    template <typename F>
+    int update(uint32_t word, system_tick_t now, F&& on_sequence) {
+        if(!_begun) {
+            return 0;
+        }
+        word &= mask();
+        //idle: nothing settling, no deadline and the word did not move
+        if(!_busy && word == _stable) {
+            return 0;
+        }
+
+        uint32_t changed = _debounce.update(word, now);
+        _stable = _debounce.read();
+        int decoded = 0;
+        uint32_t active = 0;
+        for(uint32_t bits = changed | _active; bits; bits &= bits - 1) {
+            size_t i = __builtin_ctz(bits);
+            ButtonSequence* button = at_begun(i);
+            int sequence = button->check_debounced((_stable >> i) & 1, now);
+            if(button->is_active()) {
+                active |= 1UL << i;
+            }
+            if(sequence) {
+                on_sequence(i, sequence);
+                decoded++;
+            }
+        }
+        _active = active;
+        _busy = _active || !_debounce.isStable();
+        return decoded;
+    }
+
+    /**
+     * @brief Debounce a word read at millis() and check the buttons
+     *
+     * @param[in] word - input word, bit i is button i
+     * @param[in] on_sequence - callable taking (size_t index, int sequence)
+     *
+     * @return number of sequences decoded
+     */
+    template <typename F>
+    int update(uint32_t word, F&& on_sequence) {
+        return update(word, millis(), on_sequence);
+    }
+
+    /**
+     * @brief Check if a button needs fast sampling, see
+     * ButtonSequence::is_active()
+     *
+     * @return true if a bit is waiting to settle or a button is active
+     */
+    bool is_active() const {
+        return _begun && _busy;
+    }
+
+    /**
+     * @brief Get the earliest time update() has work to do without a new
+     * edge
+     *
+     * @param[out] deadline - milli sec time of the next deadline
+     *
+     * @return true if a deadline is pending, false if the bank is idle
+     */
+    bool next_deadline(system_tick_t& deadline) {
+        bool pending = false;
+        if(!_begun || !_busy) {
+            return false;
+        }
+        uint32_t settle;
+        if(_debounce.nextDeadline(settle)) {
+            deadline = settle;
+            pending = true;
+        }
+        //only active buttons are checked by update()
+        for(uint32_t bits = _active; bits; bits &= bits - 1) {
+            system_tick_t time;
+            if(at_begun(__builtin_ctz(bits))->next_deadline(time) &&
+                    (!pending || (int32_t)(time - deadline) < 0)) {
+                deadline = time;
+                pending = true;
+            }
+        }
+        return pending;
+    }
+
+    /**
+     * @brief Get a button, e.g. to set its stuck or press callback
+     *
+     * @param[in] index - bit of the button
+     *
+     * @return the button, nullptr before begin() or if index is not below N
+     */
+    ButtonSequence* at(size_t index) {
+        return (_begun && index < N) ? at_begun(index) : nullptr;
+    }
+
+    /**
+     * @brief Get the debounce of the word, e.g. to set a majority filter
+     *
+     * @return the bank debounce
+     */
+    DebounceBank& debounce() {
+        return _debounce;
+    }
+
+    /**
+     * @brief Get the debounce interval of the bank
+     *
+     * @return milli sec debounce time
+     */
+    system_tick_t get_debounce_interval() const {
+        return _debounce_interval;
+    }
+
+    /**
+     * @brief Get the number of buttons
+     *
+     * @return N
+     */
+    static constexpr size_t size() {
+        return N;
+    }
+
+private:
+
+    /**
+     * @brief Get the bits of the word that are buttons
+     *
+     * @return the low N bits set
+     */
+    static constexpr uint32_t mask() {
+        return (N >= 32) ? 0xFFFFFFFF : (uint32_t)((1UL << N) - 1);
+    }
+
+    /**
+     * @brief Get a button without the checks of at()
+     *
+     * @param[in] index - bit of the button, below N
+     *
+     * @return the button
+     */
+    ButtonSequence* at_begun(size_t index) {
+        return reinterpret_cast<ButtonSequence*>(&_storage[index]);
+    }
+
+    /**
+     * @brief Destroy the buttons constructed by begin()
+     */
+    void end() {
+        if(_begun) {
+            for(size_t i = 0; i < N; i++) {
+                at(i)->~ButtonSequence();
+            }
+            _begun = false;
+        }
+    }
+
+    DebounceBank _debounce;
+    ActiveLevel _active_level;
+    system_tick_t _debounce_interval;
+    system_tick_t _long_duration_interval;
+    bool _begun;
+    bool _busy;             //a bit is settling or a button is active
+    uint32_t _active;       //buttons active after their last check
+    uint32_t _stable;       //debounced word of the last update
+    typename std::aligned_storage<sizeof(ButtonSequence),
+                                alignof(ButtonSequence)>::type _storage[N];
+};
@@ -0,0 +1,26 @@
+/**
+ * @file ButtonCost.cpp
+ * @author Ed Ablan
+ * @version 1.0
+ * @date 10/17/2026
+ *
+ * @brief Counters of the work each button does
+ *
+ * @details Please read the header file for more details
+ *
+ * @copyright Copyright (c) 2020 Particle Industries, Inc.  All rights reserved.
+ */
+
+#include "ButtonCost.h"
+#include "ButtonPrint.h"
+
+void button_cost_print(Print& out, const char* label, ButtonCostMode mode,
+                        const ButtonCost& cost)
+{
+    static const char* const modes[] = {"loop", "fixed", "interrupt"};
+    button_print_line(out, "COST %s %s %lu %lu %lu %lu %lu %lu\r\n", label,
+                modes[(int)mode], (unsigned long)(millis() - cost.start),
+                (unsigned long)cost.polls, (unsigned long)cost.reads,
+                (unsigned long)cost.clock_reads, (unsigned long)cost.edges,
+                (unsigned long)cost.transitions);
+}
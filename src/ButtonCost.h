@@ -0,0 +1,68 @@
+/**
+ * @file ButtonCost.h
+ * @author Ed Ablan
+ * @version 1.0
+ * @date 10/17/2026
+ *
+ * @brief Counters of the work each button does, to estimate its CPU cost
+ *
+ * @details With BUTTON_COST_ENABLE defined, Debounce and ButtonSequence count
+ * their polls, pin or callback reads, millis() reads, raw edges and state
+ * transitions (debounced changes, press, release and the end of a sequence).
+ * Read them with cost(), print them with button_cost_print() at the end of a
+ * measurement interval and convert them to active time per hour with
+ * tools/cost_model.py, which holds the cost of each operation. Without
+ * BUTTON_COST_ENABLE the counting points compile to nothing and cost()
+ * returns zeros
+ *
+ * @copyright Copyright (c) 2020 Particle Industries, Inc.  All rights reserved.
+ */
+#pragma once
+
+#include "Particle.h"
+
+//How the application runs its buttons, tells the model what wakes the CPU
+enum class ButtonCostMode {
+    LOOP,           //check_button() every loop(), no wakeups of its own
+    FIXED_RATE,     //woken by a timer to check the buttons at a fixed rate
+    INTERRUPT,      //woken by pin interrupts and the next_deadline() timer
+};
+
+struct ButtonCost {
+    uint32_t polls;         //check_button() or update() calls
+    uint32_t reads;         //digitalRead() or read callback calls
+    uint32_t clock_reads;   //millis() calls
+    uint32_t edges;         //raw level changes seen
+    uint32_t transitions;   //debounced changes and sequence state changes
+    uint32_t start;         //millis() of the last reset
+
+    ButtonCost& operator+=(const ButtonCost& other) {
+        polls += other.polls;
+        reads += other.reads;
+        clock_reads += other.clock_reads;
+        edges += other.edges;
+        transitions += other.transitions;
+        return *this;
+    }
+};
+
+#ifdef BUTTON_COST_ENABLE
+#define BUTTON_COST(counter) ((counter)++)
+#else
+#define BUTTON_COST(counter) do {} while(0)
+#endif
+
+/**
+ * @brief Print the counters as one line for tools/cost_model.py
+ *
+ * @details The line is "COST <label> <mode> <elapsed ms> <polls> <reads>
+ * <clock reads> <edges> <transitions>", elapsed since cost.start. Sum the
+ * cost of every button of a configuration with += before printing it
+ *
+ * @param[in] out - where to print, e.g. Serial
+ * @param[in] label - name of the configuration, no spaces
+ * @param[in] mode - what wakes the CPU to check the buttons
+ * @param[in] cost - counters to print
+ */
+void button_cost_print(Print& out, const char* label, ButtonCostMode mode,
+                        const ButtonCost& cost);
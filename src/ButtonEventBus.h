@@ -0,0 +1,164 @@
+/**
+ * @file ButtonEventBus.h
+ * @author Ed Ablan
+ * @version 1.0
+ * @date 10/17/2026
+ *
+ * @brief Lock free bus that button groups running in different contexts
+ * publish their events into, drained by one consumer
+ *
+ * @details A bounded multi producer, single consumer ring of N slots. Each
+ * producer (a timer ISR, an expander thread, the main loop) claims a slot
+ * with one compare and swap on the tail, writes the event and marks the slot
+ * ready with its sequence number, so producers never wait on each other or on
+ * the consumer and publish() is safe from interrupts. When the ring is full
+ * the event is dropped and counted rather than blocking, see dropped().
+ *
+ * The consumer drains ready events in order in batches with drain(). An event
+ * whose producer was interrupted between claiming and filling its slot holds
+ * back the events after it until that producer finishes.
+ *
+ * The tail, the consumer head and the drop counter each sit on their own
+ * BUTTON_BUS_CACHE_LINE, and so does every slot, so producers filling
+ * neighbouring slots and the consumer draining do not false share. Devices
+ * without a data cache can define BUTTON_BUS_CACHE_LINE to 4 to save the
+ * padding
+ *
+ * @copyright Copyright (c) 2020 Particle Industries, Inc.  All rights reserved.
+ */
+#pragma once
+
+#include <atomic>
+#include <stddef.h>
+
+#include "types.h"
+
+#ifndef BUTTON_BUS_CACHE_LINE
+#define BUTTON_BUS_CACHE_LINE 64
+#endif
+
+static_assert(ATOMIC_INT_LOCK_FREE == 2,
+                "event bus needs lock free 32 bit atomics");
+
+template <size_t N, typename T = ButtonEvent>
+class ButtonEventBus {
+public:
+    static_assert(N >= 2 && (N & (N - 1)) == 0, "N must be a power of 2");
+
+    /**
+     * @brief Constructor for class, the bus starts empty
+     */
+    ButtonEventBus() : _tail(0), _head(0), _dropped(0) {
+        for(size_t i = 0; i < N; i++) {
+            _slots[i].seq.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * @brief Publish an event, from any context including interrupts
+     *
+     * @param[in] event - event to copy into the bus
+     *
+     * @return true if published, false if the bus was full and the event was
+     * dropped
+     */
+    bool publish(const T& event) {
+        uint32_t pos = _tail.load(std::memory_order_relaxed);
+        Slot* slot;
+        for(;;) {
+            slot = &_slots[pos & (N - 1)];
+            uint32_t seq = slot->seq.load(std::memory_order_acquire);
+            int32_t diff = (int32_t)(seq - pos);
+            if(diff == 0) {
+                //free slot, claim it, pos is reloaded if another producer won
+                if(_tail.compare_exchange_weak(pos, pos + 1,
+                                                std::memory_order_relaxed)) {
+                    break;
+                }
+            }
+            else if(diff < 0) {
+                //the consumer has not drained this slot from the previous lap
+                _dropped.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+            else {
+                pos = _tail.load(std::memory_order_relaxed);
+            }
+        }
+        slot->event = event;
+        slot->seq.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Copy out the events ready, oldest first. Call from the single
+     * consumer only
+     *
+     * @param[out] events - where to copy the events
+     * @param[in] max_events - most events to copy
+     *
+     * @return number of events copied, 0 if none is ready
+     */
+    size_t drain(T* events, size_t max_events) {
+        size_t count = 0;
+        uint32_t head = _head.load(std::memory_order_relaxed);
+        while(count < max_events) {
+            Slot& slot = _slots[head & (N - 1)];
+            if(slot.seq.load(std::memory_order_acquire) != head + 1) {
+                break;
+            }
+            events[count++] = slot.event;
+            //free the slot for the producer one lap ahead
+            slot.seq.store(head + N, std::memory_order_release);
+            head++;
+        }
+        _head.store(head, std::memory_order_relaxed);
+        return count;
+    }
+
+    /**
+     * @brief Get the number of events dropped because the bus was full
+     *
+     * @return events dropped since construction or the last take_dropped()
+     */
+    uint32_t dropped() const {
+        return _dropped.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Get and zero the number of events dropped, e.g. to report it
+     * with each batch
+     *
+     * @return events dropped since the last call
+     */
+    uint32_t take_dropped() {
+        return _dropped.exchange(0, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Check if an event is ready to drain. Call from the consumer
+     *
+     * @return true if drain() would return at least one event
+     */
+    bool ready() const {
+        uint32_t head = _head.load(std::memory_order_relaxed);
+        return _slots[head & (N - 1)].seq.load(std::memory_order_acquire) ==
+                head + 1;
+    }
+
+    static constexpr size_t capacity() {
+        return N;
+    }
+
+private:
+    struct alignas(BUTTON_BUS_CACHE_LINE) Slot {
+        //index the slot is free for, index + 1 once the event is written
+        std::atomic<uint32_t> seq;
+        T event;
+    };
+
+    alignas(BUTTON_BUS_CACHE_LINE) std::atomic<uint32_t> _tail;
+    alignas(BUTTON_BUS_CACHE_LINE) std::atomic<uint32_t> _head;
+    alignas(BUTTON_BUS_CACHE_LINE) std::atomic<uint32_t> _dropped;
+    Slot _slots[N];
+};
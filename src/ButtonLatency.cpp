@@ -0,0 +1,97 @@
+/**
+ * @file ButtonLatency.cpp
+ * @author Ed Ablan
+ * @version 1.0
+ * @date 10/17/2026
+ *
+ * @brief Histograms of the latency of decoded sequences per stage
+ *
+ * @details Please read the header file for more details
+ *
+ * @copyright Copyright (c) 2020 Particle Industries, Inc.  All rights reserved.
+ */
+
+#include "ButtonLatency.h"
+#include "ButtonPrint.h"
+
+#include <string.h>
+
+ButtonLatencyStats::ButtonLatencyStats()
+{
+    reset();
+}
+
+void ButtonLatencyStats::record(const ButtonLatency& latency, 
+                                system_tick_t handled)
+{
+    add(LatencyStage::DEBOUNCE, latency.confirmed - latency.edge);
+    add(LatencyStage::GAP, latency.emitted - latency.confirmed);
+    add(LatencyStage::QUEUE, handled - latency.emitted);
+    add(LatencyStage::TOTAL, handled - latency.edge);
+}
+
+void ButtonLatencyStats::add(LatencyStage stage, system_tick_t millis)
+{
+    LatencyHistogram& hist = _stages[(int)stage];
+    //a time that went backwards (handled before emitted) counts as 0
+    if((int32_t)millis < 0) {
+        millis = 0;
+    }
+    size_t bucket = (millis) ? 32 - __builtin_clz(millis) : 0;
+    if(bucket >= LATENCY_BUCKETS) {
+        bucket = LATENCY_BUCKETS - 1;
+    }
+    hist.buckets[bucket]++;
+    hist.count++;
+    hist.sum += millis;
+    if(millis > hist.max) {
+        hist.max = millis;
+    }
+}
+
+const LatencyHistogram& ButtonLatencyStats::histogram(LatencyStage stage) const
+{
+    return _stages[(int)stage];
+}
+
+system_tick_t ButtonLatencyStats::percentile(LatencyStage stage, 
+                                            uint8_t percent) const
+{
+    const LatencyHistogram& hist = _stages[(int)stage];
+    if(!hist.count) {
+        return 0;
+    }
+    //rank of the percentile, rounded up so p100 is the last sample
+    uint32_t rank = ((uint64_t)hist.count * percent + 99) / 100;
+    uint32_t seen = 0;
+    for(size_t i = 0; i < LATENCY_BUCKETS - 1; i++) {
+        seen += hist.buckets[i];
+        if(seen >= rank) {
+            system_tick_t upper = (i) ? (1UL << i) - 1 : 0;
+            return (upper < hist.max) ? upper : hist.max;
+        }
+    }
+    return hist.max;
+}
+
+void ButtonLatencyStats::print(Print& out) const
+{
+    static const char* const stages[] = {"debounce", "gap", "queue", "total"};
+    for(size_t i = 0; i < LATENCY_STAGES; i++) {
+        const LatencyHistogram& hist = _stages[i];
+        LatencyStage stage = (LatencyStage)i;
+        button_print_line(out, "LATENCY %s %lu %lu %lu %lu %lu %lu\r\n",
+                    stages[i],
+                    (unsigned long)hist.count,
+                    (unsigned long)((hist.count) ? hist.sum / hist.count : 0),
+                    (unsigned long)percentile(stage, 50),
+                    (unsigned long)percentile(stage, 90),
+                    (unsigned long)percentile(stage, 99),
+                    (unsigned long)hist.max);
+    }
+}
+
+void ButtonLatencyStats::reset()
+{
+    memset(_stages, 0, sizeof(_stages));
+}
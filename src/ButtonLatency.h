@@ -0,0 +1,126 @@
+/**
+ * @file ButtonLatency.h
+ * @author Ed Ablan
+ * @version 1.0
+ * @date 10/17/2026
+ *
+ * @brief Latency of decoded sequences from the physical edge to the 
+ * application, split into the stages that can be tuned
+ *
+ * @details With BUTTON_LATENCY_ENABLE defined, ButtonSequence tags every 
+ * sequence it returns with three times, read with latency(): the first raw
+ * edge of the transition that ended the sequence (the release of a short
+ * sequence, the press of a long one), the time the debounce confirmed it and
+ * the time check_button() returned the sequence. The ending transition is
+ * used rather than the first press of the sequence so the clicks of a multi
+ * click sequence do not count as latency, and the tag is kept out of
+ * ButtonEvent so events stay 8 bytes. The application records the tag with
+ * the time it handles the event in ButtonLatencyStats, which keeps a
+ * histogram per stage:
+ *
+ *  debounce  edge to confirmed, tune the debounce interval or filter
+ *  gap       confirmed to returned, the short click or long click timeout
+ *            plus the polling delay
+ *  queue     returned to handled, e.g. time spent in a ButtonEventBus
+ *  total     edge to handled
+ *
+ * Times are milli secs. Without BUTTON_LATENCY_ENABLE nothing is tracked and
+ * latency() returns zeros
+ *
+ * @copyright Copyright (c) 2020 Particle Industries, Inc.  All rights reserved.
+ */
+#pragma once
+
+#include "Particle.h"
+
+//Number of histogram buckets, bucket 0 counts 0 ms, bucket i counts 2^(i-1)
+//to 2^i - 1 ms and the last bucket everything longer
+#ifndef LATENCY_BUCKETS
+#define LATENCY_BUCKETS 16
+#endif
+
+//Times of one decoded sequence
+struct ButtonLatency {
+    system_tick_t edge;         //first raw edge of the ending transition
+    system_tick_t confirmed;    //the debounce confirmed the transition
+    system_tick_t emitted;      //check_button() returned the sequence
+};
+
+enum class LatencyStage {
+    DEBOUNCE = 0,   //edge to confirmed
+    GAP = 1,        //confirmed to emitted
+    QUEUE = 2,      //emitted to handled
+    TOTAL = 3,      //edge to handled
+};
+
+#define LATENCY_STAGES 4
+
+struct LatencyHistogram {
+    uint32_t count;
+    uint32_t sum;       //milli secs, for the mean
+    uint32_t max;
+    uint32_t buckets[LATENCY_BUCKETS];
+};
+
+class ButtonLatencyStats {
+public:
+
+    /**
+     * @brief Constructor for class, the histograms start empty
+     */
+    ButtonLatencyStats();
+
+    /**
+     * @brief Add the stage latencies of one sequence
+     *
+     * @param[in] latency - tag of the sequence, ButtonSequence::latency()
+     * @param[in] handled - milli sec time the application handled the 
+     * sequence, millis() when it is taken off the queue
+     */
+    void record(const ButtonLatency& latency, system_tick_t handled);
+
+    /**
+     * @brief Get the histogram of a stage
+     *
+     * @param[in] stage - stage of the latency
+     *
+     * @return the histogram, counts since construction or the last reset()
+     */
+    const LatencyHistogram& histogram(LatencyStage stage) const;
+
+    /**
+     * @brief Estimate a percentile of a stage from its histogram
+     *
+     * @param[in] stage - stage of the latency
+     * @param[in] percent - 1 to 100
+     *
+     * @return milli sec upper bound of the bucket holding the percentile, 
+     * capped at the max, 0 if nothing was recorded
+     */
+    system_tick_t percentile(LatencyStage stage, uint8_t percent) const;
+
+    /**
+     * @brief Print one line per stage, "LATENCY <stage> <count> <mean ms> 
+     * <p50 ms> <p90 ms> <p99 ms> <max ms>"
+     *
+     * @param[in] out - where to print, e.g. Serial
+     */
+    void print(Print& out) const;
+
+    /**
+     * @brief Empty the histograms
+     */
+    void reset();
+
+private:
+
+    /**
+     * @brief Add one latency to the histogram of a stage
+     *
+     * @param[in] stage - stage of the latency
+     * @param[in] millis - latency of the stage
+     */
+    void add(LatencyStage stage, system_tick_t millis);
+
+    LatencyHistogram _stages[LATENCY_STAGES];
+};
@@ -0,0 +1,31 @@
+/**
+ * @file ButtonPrint.cpp
+ * @author Ed Ablan
+ * @version 1.0
+ * @date 10/17/2026
+ *
+ * @brief Prints one formatted report line to a Print
+ *
+ * @details Please read the header file for more details
+ *
+ * @copyright Copyright (c) 2020 Particle Industries, Inc.  All rights reserved.
+ */
+
+#include "ButtonPrint.h"
+
+#include <stdarg.h>
+#include <stdio.h>
+
+size_t button_print_line(Print& out, const char* format, ...)
+{
+    char line[BUTTON_PRINT_LINE_SIZE];
+    va_list args;
+    va_start(args, format);
+    int len = vsnprintf(line, sizeof(line), format, args);
+    va_end(args);
+    if(len <= 0) {
+        return 0;
+    }
+    return out.write((const uint8_t*)line,
+                    ((size_t)len < sizeof(line)) ? len : sizeof(line) - 1);
+}
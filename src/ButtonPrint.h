@@ -0,0 +1,34 @@
+/**
+ * @file ButtonPrint.h
+ * @author Ed Ablan
+ * @version 1.0
+ * @date 10/17/2026
+ *
+ * @brief Prints one formatted report line to a Print
+ *
+ * @details The print() of the statistics classes (ButtonCost, 
+ * ButtonLatencyStats, ScanScheduler, BudgetPoller) format their lines with
+ * button_print_line(), which formats into a stack buffer and writes it in
+ * one call. A line longer than the buffer is cut off
+ *
+ * @copyright Copyright (c) 2020 Particle Industries, Inc.  All rights reserved.
+ */
+#pragma once
+
+#include "Particle.h"
+
+//Longest line printed, including the terminating zero
+#ifndef BUTTON_PRINT_LINE_SIZE
+#define BUTTON_PRINT_LINE_SIZE 128
+#endif
+
+/**
+ * @brief Format a line like printf() and write it to out
+ *
+ * @param[in] out - where to print, e.g. Serial
+ * @param[in] format - printf() format, include the line end
+ *
+ * @return bytes written
+ */
+size_t button_print_line(Print& out, const char* format, ...)
+                            __attribute__((format(printf, 2, 3)));
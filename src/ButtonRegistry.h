@@ -0,0 +1,138 @@
+/** 
+ * @file ButtonRegistry.h
+ * @author Ed Ablan
+ * @version 1.0
+ * @date 10/17/2026
+ *
+ * @brief Fixed size registry that constructs buttons in static storage
+ *
+ * @details Instead of creating each button with new, a registry declared at
+ * file scope reserves room for N ButtonSequence instances in one contiguous
+ * array and constructs them in place. poll_all() checks every button in 
+ * order with a single call. memory_reserved() is a compile time constant, so
+ * the RAM used by the input subsystem is known at build time.
+ *
+ * Buttons attached to a pin or to a read function with a context pointer do
+ * not use the heap. A read callback passed as a std::function is kept on the
+ * heap by the Debounce, one allocation per button
+ *
+ * @copyright Copyright (c) 2020 Particle Industries, Inc.  All rights reserved.
+ */
+#pragma once
+
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "ButtonSequence.h"
+
+template <size_t N>
+class ButtonRegistry {
+public:
+
+    /**
+     * @brief Constructor for class, no button is constructed yet
+     */
+    ButtonRegistry() : _count(0) {}
+
+    /**
+     * @brief Destructor, destroys the buttons that were added
+     */
+    ~ButtonRegistry() {
+        for(size_t i = 0; i < _count; i++) {
+            at(i)->~ButtonSequence();
+        }
+    }
+
+    ButtonRegistry(const ButtonRegistry&) = delete;
+    ButtonRegistry& operator=(const ButtonRegistry&) = delete;
+
+    /**
+     * @brief Construct a button in the next free slot
+     *
+     * @details Takes the same arguments as the ButtonSequence constructors.
+     * The index of the button is its position in the order it was added
+     *
+     * @param[in] args - ButtonSequence constructor arguments
+     *
+     * @return the button, nullptr if all N slots are in use
+     */
+    template <typename... Args>
+    ButtonSequence* add(Args&&... args) {
+        if(_count >= N) {
+            return nullptr;
+        }
+        ButtonSequence* button = 
+            new (&_storage[_count]) ButtonSequence(std::forward<Args>(args)...);
+        _count++;
+        return button;
+    }
+
+    /**
+     * @brief Check every button in the order they were added
+     *
+     * @details Calls check_button() on each button and calls on_sequence for
+     * every non zero result
+     *
+     * @param[in] on_sequence - callable taking (size_t index, int sequence)
+     *
+     * @return number of sequences decoded
+     */
+    template <typename F>
+    int poll_all(F&& on_sequence) {
+        int decoded = 0;
+        for(size_t i = 0; i < _count; i++) {
+            int sequence = at(i)->check_button();
+            if(sequence) {
+                on_sequence(i, sequence);
+                decoded++;
+            }
+        }
+        return decoded;
+    }
+
+    /**
+     * @brief Get a button by index
+     *
+     * @param[in] index - position the button was added at
+     *
+     * @return the button, nullptr if the index is not in use
+     */
+    ButtonSequence* at(size_t index) {
+        return (index < _count) ? 
+                reinterpret_cast<ButtonSequence*>(&_storage[index]) : nullptr;
+    }
+
+    /**
+     * @brief Get the number of buttons added
+     *
+     * @return buttons constructed in the registry
+     */
+    size_t size() const {
+        return _count;
+    }
+
+    /**
+     * @brief Get the number of buttons the registry can hold
+     *
+     * @return N
+     */
+    static constexpr size_t capacity() {
+        return N;
+    }
+
+    /**
+     * @brief Get the RAM reserved by the registry, including the storage of
+     * all N buttons
+     *
+     * @return bytes reserved
+     */
+    static constexpr size_t memory_reserved() {
+        return sizeof(ButtonRegistry<N>);
+    }
+
+private:
+    typename std::aligned_storage<sizeof(ButtonSequence), 
+                                alignof(ButtonSequence)>::type _storage[N];
+    size_t _count;
+};
@@ -18,7 +18,11 @@
  */
 
 #include "ButtonSequence.h"
+
+#include <utility>
+
 #include "spark_wiring_ticks.h"
+#include "ButtonTrace.h"
 
 #define SHORT_CLICK_TIMEOUT_MS 500
 
@@ -29,6 +33,8 @@ ButtonSequence::ButtonSequence(pin_t button_pin, PinMode mode,
 {
     _active_low = (active_level == ActiveLevel::LOW) ? true : false;
     debounce_button.attach(button_pin, mode, debounce_interval);
+    _run_time = millis();
+    reset_cost();
 }
 
 ButtonSequence::ButtonSequence(std::function<int32_t(void)> read_cb, 
@@ -37,43 +43,97 @@ ButtonSequence::ButtonSequence(std::function<int32_t(void)> read_cb,
         _long_duration_interval(long_duration_interval)
 {
     _active_low = (active_level == ActiveLevel::LOW) ? true : false;
-    debounce_button.attach(read_cb, debounce_interval);
+    debounce_button.attach(std::move(read_cb), debounce_interval);
+    _run_time = millis();
+    reset_cost();
 }
 
-int ButtonSequence::update_sequence(bool state_changed)
+ButtonSequence::ButtonSequence(DebounceReadFn read_fn, void* context, 
+                    ActiveLevel active_level, system_tick_t debounce_interval, 
+                    system_tick_t long_duration_interval) :
+        _long_duration_interval(long_duration_interval)
+{
+    _active_low = (active_level == ActiveLevel::LOW) ? true : false;
+    debounce_button.attach(read_fn, context, debounce_interval);
+    _run_time = millis();
+    reset_cost();
+}
+
+ButtonSequence::ButtonSequence(ActiveLevel active_level, bool initial_state,
+                    system_tick_t long_duration_interval) :
+        _long_duration_interval(long_duration_interval)
+{
+    _active_low = (active_level == ActiveLevel::LOW) ? true : false;
+    debounce_button.interval(0);
+    debounce_button.setState(initial_state, millis());
+    _run_time = millis();
+    reset_cost();
+}
+
+int ButtonSequence::update_sequence(bool state_changed, system_tick_t now)
 {
-    static system_tick_t long_press_timeout = 0, short_depress_timeout = 0,
-    start_time = 0;
-    static bool pressed = false;
-    static int click_count = 0;
     int returnval = 0;
+    _run_time = now;
+    if(_press_fn) {update_tentative(state_changed, now);}
+#ifdef BUTTON_LATENCY_ENABLE
+    track_edge(state_changed, now);
+#endif
 
     if(state_changed) {
         auto switch_state = debounce_button.read();
-        pressed = (_active_low) ?  !switch_state : switch_state;
+        _pressed = (_active_low) ?  !switch_state : switch_state;
 
-        if(pressed){click_count++;}
+        if(_pressed){_click_count++;}
+        //a stuck button that finally releases ends the fault, the hold that
+        //caused it is not reported as a sequence
+        else if(_stuck) {_stuck = false;}
+        BUTTON_TRACE((_pressed) ? TRACE_SEQUENCE_PRESS : TRACE_SEQUENCE_RELEASE,
+                    _click_count, (uintptr_t)this);
+        BUTTON_COST(_cost.transitions);
 
-        start_time = millis();
-        if(pressed) {long_press_timeout = _long_duration_interval;}
-        else {short_depress_timeout = SHORT_CLICK_TIMEOUT_MS;}   
+        _start_time = now;
+        if(_pressed) {_long_press_timeout = _long_duration_interval;}
+        else {_short_depress_timeout = SHORT_CLICK_TIMEOUT_MS;}   
     }
     //state didn't change, check sequence termination
     else {
+        //a press held far beyond the long click is a jammed or shorted input
+        if(_pressed && !_stuck && 
+                (now - _start_time > get_stuck_interval())) {
+            _stuck = true;
+            _stuck_skipped = false;
+            _click_count = 0;
+            _stuck_poll_time = now;
+            BUTTON_TRACE(TRACE_SEQUENCE_STUCK, 0, (uintptr_t)this);
+            BUTTON_COST(_cost.transitions);
+            if(_stuck_fn) {_stuck_fn(_stuck_context);}
+        }
         //only if a sequence is in progress
-        if(click_count) {
-            if(pressed) {
+        if(_click_count) {
+            if(_pressed) {
                 //check if long press was used to terminate the sequence
-                if(millis() - start_time > long_press_timeout) {
-                    returnval = (-1*click_count);
-                    click_count = 0;
+                if(now - _start_time > _long_press_timeout) {
+                    returnval = (-1*_click_count);
+                    BUTTON_TRACE(TRACE_SEQUENCE_LONG, _click_count, 
+                                (uintptr_t)this);
+                    BUTTON_COST(_cost.transitions);
+#ifdef BUTTON_LATENCY_ENABLE
+                    _latency = {_change_edge, _start_time, now};
+#endif
+                    _click_count = 0;
                 }
             }
             else {
                 //check if short depress terminates the sequence
-                if(millis() - start_time > short_depress_timeout) {
-                    returnval = click_count;
-                    click_count = 0;
+                if(now - _start_time > _short_depress_timeout) {
+                    returnval = _click_count;
+                    BUTTON_TRACE(TRACE_SEQUENCE_SHORT, _click_count, 
+                                (uintptr_t)this);
+                    BUTTON_COST(_cost.transitions);
+#ifdef BUTTON_LATENCY_ENABLE
+                    _latency = {_change_edge, _start_time, now};
+#endif
+                    _click_count = 0;
                 }
             }
         }
@@ -82,16 +142,140 @@ int ButtonSequence::update_sequence(bool state_changed)
     return returnval;
 }
 
+void ButtonSequence::update_tentative(bool state_changed, system_tick_t now)
+{
+    bool raw = debounce_button.readRaw();
+    bool raw_pressed = (_active_low) ? !raw : raw;
+    bool debounced = debounce_button.read();
+    bool confirmed = state_changed && ((_active_low) ? !debounced : debounced);
+
+    if(!_tentative && !_pressed && (raw_pressed || confirmed)) {
+        _tentative = true;
+        _press_fn(_press_context, PressPhase::TENTATIVE);
+    }
+    if(!_tentative) {
+        return;
+    }
+    if(confirmed) {
+        _tentative = false;
+        _press_fn(_press_context, PressPhase::CONFIRMED);
+    }
+    //back at released and held there for the debounce interval
+    else if(!raw_pressed && debounce_button.isStable() && 
+            (int32_t)(now - debounce_button.settleTime()) >= 0) {
+        _tentative = false;
+        _press_fn(_press_context, PressPhase::CANCELLED);
+    }
+}
+
+#ifdef BUTTON_LATENCY_ENABLE
+void ButtonSequence::track_edge(bool state_changed, system_tick_t now)
+{
+    if(state_changed) {
+        _change_edge = (_edge_pending) ? _edge_time : now;
+        _edge_pending = false;
+    }
+    bool raw = debounce_button.readRaw();
+    if(raw != debounce_button.read()) {
+        if(!_edge_pending) {
+            _edge_pending = true;
+            _edge_time = now;
+        }
+    }
+    //a bounce keeps the first edge, only a glitch that settled back for the
+    //debounce interval forgets it
+    else if(_edge_pending && debounce_button.isStable() && 
+            (int32_t)(now - debounce_button.settleTime()) >= 0) {
+        _edge_pending = false;
+    }
+}
+#endif
+
+bool ButtonSequence::stuck_backoff(system_tick_t now)
+{
+    //only sample a stuck button every STUCK_POLL_INTERVAL_MS until it releases
+    if(_stuck) {
+        if(now - _stuck_poll_time < STUCK_POLL_INTERVAL_MS) {
+            _stuck_skipped = true;
+            return true;
+        }
+        _stuck_poll_time = now;
+        _stuck_skipped = false;
+    }
+    return false;
+}
+
 int ButtonSequence::check_button()
 {
+    system_tick_t now = millis();
+    BUTTON_COST(_cost.clock_reads);
+    BUTTON_COST(_cost.polls);
+    if(stuck_backoff(now)) {return 0;}
     bool state_changed = debounce_button.update();
-    return update_sequence(state_changed);
+    return update_sequence(state_changed, now);
 }
 
 int ButtonSequence::check_button(bool current_state)
 {
-    bool state_changed = debounce_button.update(current_state);
-    return update_sequence(state_changed);
+    BUTTON_COST(_cost.clock_reads);
+    return check_button(current_state, millis());
+}
+
+int ButtonSequence::check_button(bool current_state, system_tick_t now)
+{
+    BUTTON_COST(_cost.polls);
+    //the caller passes every change in, a stuck button costs nothing to check
+    bool state_changed = debounce_button.update(current_state, now);
+    return update_sequence(state_changed, now);
+}
+
+int ButtonSequence::check_debounced(bool debounced_state, system_tick_t now)
+{
+    BUTTON_COST(_cost.polls);
+    bool state_changed = debounce_button.setState(debounced_state, now);
+    return update_sequence(state_changed, now);
+}
+
+size_t ButtonSequence::feed_run(bool level, system_tick_t duration, 
+                                ButtonEvent* events, size_t max_events)
+{
+    system_tick_t now = _run_time;
+    system_tick_t end = now + duration;
+    size_t count = 0;
+
+    if(!duration) {
+        return 0;
+    }
+
+    //the level applies from the first milli sec of the run, after that only
+    //the deadlines inside the run can change anything
+    for(;;) {
+        int sequence = check_button(level, now);
+        if(sequence) {
+            if(count < max_events) {
+                events[count].timestamp = now;
+                events[count].button_id = 0;
+                events[count].sequence = sequence;
+            }
+            count++;
+        }
+
+        system_tick_t deadline;
+        if(!next_deadline(deadline)) {
+            break;
+        }
+        //deadlines are never behind the current time
+        if((int32_t)(deadline - now) <= 0) {
+            deadline = now + 1;
+        }
+        if((int32_t)(deadline - end) >= 0) {
+            break;
+        }
+        now = deadline;
+    }
+
+    _run_time = end;
+    return count;
 }
 
 void ButtonSequence::set_long_interval(system_tick_t long_duration_interval)
@@ -102,4 +286,111 @@ void ButtonSequence::set_long_interval(system_tick_t long_duration_interval)
 system_tick_t ButtonSequence::get_long_interval()
 {
     return _long_duration_interval;
+}
+
+void ButtonSequence::set_majority_filter(uint8_t window, uint8_t threshold)
+{
+    debounce_button.majority(window, threshold);
+}
+
+void ButtonSequence::set_stuck_interval(system_tick_t stuck_interval)
+{
+    _stuck_interval = stuck_interval;
+}
+
+system_tick_t ButtonSequence::get_stuck_interval()
+{
+    return (_stuck_interval) ? _stuck_interval : 
+                        _long_duration_interval * STUCK_INTERVAL_FACTOR;
+}
+
+void ButtonSequence::set_stuck_callback(ButtonStuckFn stuck_fn, 
+                                        void* context)
+{
+    _stuck_fn = stuck_fn;
+    _stuck_context = context;
+}
+
+void ButtonSequence::set_press_callback(ButtonPressFn press_fn, 
+                                        void* context)
+{
+    _press_fn = press_fn;
+    _press_context = context;
+}
+
+bool ButtonSequence::is_stuck()
+{
+    return _stuck;
+}
+
+bool ButtonSequence::is_active()
+{
+    if(_stuck) {
+        return false;
+    }
+    return !debounce_button.isStable() || _pressed || _click_count || 
+            _tentative;
+}
+
+bool ButtonSequence::next_deadline(system_tick_t& deadline)
+{
+    bool pending = false;
+    auto earliest = [&](system_tick_t time) {
+        if(!pending || (int32_t)(time - deadline) < 0) {
+            deadline = time;
+            pending = true;
+        }
+    };
+
+    uint32_t settle;
+    if(debounce_button.nextDeadline(settle)) {earliest(settle);}
+
+    //a stuck button only has work if a sample of its input was skipped
+    if(_stuck) {
+        if(_stuck_skipped) {
+            earliest(_stuck_poll_time + STUCK_POLL_INTERVAL_MS);
+        }
+    }
+    else if(_pressed) {
+        earliest(_start_time + get_stuck_interval() + 1);
+    }
+    //a tentative press that bounced back is cancelled once it settles
+    if(_tentative && !_pressed) {
+        earliest(debounce_button.settleTime());
+    }
+    //timeouts fire once they are exceeded, one milli sec past the interval
+    if(_click_count) {
+        earliest(_start_time + ((_pressed) ? _long_press_timeout : 
+                                            _short_depress_timeout) + 1);
+    }
+    return pending;
+}
+
+ButtonCost ButtonSequence::cost()
+{
+    ButtonCost total = debounce_button.cost();
+#ifdef BUTTON_COST_ENABLE
+    //each check is one poll, the debounce update it makes is part of it
+    total.polls = 0;
+    total += _cost;
+#endif
+    return total;
+}
+
+void ButtonSequence::reset_cost()
+{
+    debounce_button.resetCost();
+#ifdef BUTTON_COST_ENABLE
+    _cost = ButtonCost{};
+    _cost.start = debounce_button.cost().start;
+#endif
+}
+
+ButtonLatency ButtonSequence::latency()
+{
+#ifdef BUTTON_LATENCY_ENABLE
+    return _latency;
+#else
+    return ButtonLatency{};
+#endif
 }
\ No newline at end of file
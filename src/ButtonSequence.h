@@ -18,10 +18,22 @@
 #pragma once
 
 #include "Debounce.h"
+#include "ButtonLatency.h"
 #include "types.h"
 
 #define DEFAULT_DEBOUNCE_MS 50
 #define DEFAULT_LONG_CLICK_MS 5000
+//A press held this many long click intervals is considered stuck
+#define STUCK_INTERVAL_FACTOR 4
+//Sample interval of a stuck button until it releases
+#define STUCK_POLL_INTERVAL_MS 250
+//Most sequences that can terminate within a single run passed to feed_run()
+#define BUTTON_RUN_MAX_EVENTS 2
+
+//Callbacks are a plain function and a context pointer, stored as two
+//pointers and called with one indirect call
+typedef void (*ButtonStuckFn)(void* context);
+typedef void (*ButtonPressFn)(void* context, PressPhase phase);
 
 class ButtonSequence {
 public:
@@ -57,6 +69,40 @@ public:
                 system_tick_t debounce_interval = DEFAULT_DEBOUNCE_MS, 
                 system_tick_t long_duration_interval = DEFAULT_LONG_CLICK_MS);
 
+    /**
+     * @brief Constructor for using a read function with a context pointer,
+     * see Debounce::attach()
+     *
+     * @details Nothing is copied or allocated and every read is a single
+     * indirect call, for many buttons or fast polling. The context is not
+     * owned, it must outlive the button
+     *
+     * @param[in] read_fn - function that returns the signal, called with 
+     * context
+     * @param[in] context - passed to read_fn
+     * @param[in] active_level - pin logic high on or logic low on
+     * @param[in] debounce_interval - milli sec debounce time
+     * @param[in] long_duration_interval - milli sec long click time
+     */
+    ButtonSequence(DebounceReadFn read_fn, void* context, 
+                ActiveLevel active_level, 
+                system_tick_t debounce_interval = DEFAULT_DEBOUNCE_MS, 
+                system_tick_t long_duration_interval = DEFAULT_LONG_CLICK_MS);
+
+    /**
+     * @brief Constructor for a button that is debounced elsewhere, such as 
+     * one bit of a DebounceBank, and fed with check_debounced()
+     *
+     * @details No pin or callback is attached, check_button() must not be
+     * used
+     *
+     * @param[in] active_level - signal logic high on or logic low on
+     * @param[in] initial_state - debounced signal value at start up
+     * @param[in] long_duration_interval - milli sec long click time
+     */
+    ButtonSequence(ActiveLevel active_level, bool initial_state,
+                system_tick_t long_duration_interval = DEFAULT_LONG_CLICK_MS);
+
     /**
      * @brief Checks the button sequence. This version is inteded to debounce
      * a signal from a pin or callback function
@@ -84,6 +130,65 @@ public:
      */
     int check_button(bool current_state);
 
+    /**
+     * @brief Checks the button sequence. This version is intended for signals
+     * that are passed in with the time they were sampled, such as timestamped
+     * edges from a kernel or a capture, instead of millis()
+     *
+     * @details Function calls debounce.update(), determines if there is a 
+     * debounced state change. All timeouts are evaluated against now, so 
+     * calls must not go back in time
+     *
+     * @param[in] current_state - signal value
+     * @param[in] now - milli sec time the signal was sampled
+     *
+     * @return 0 if no button click or sequence in progress, positive click 
+     * count if short click sequence detected, negative click count if long 
+     * click terminates the short click sequence or a single long click detected
+     */
+    int check_button(bool current_state, system_tick_t now);
+
+    /**
+     * @brief Checks the button sequence with a signal that is already 
+     * debounced, see ButtonBank.h
+     *
+     * @details The debounce interval and majority filter are skipped and the
+     * word was read by the caller, so a stuck button is not rate limited. 
+     * The latency tag sees the debounced change as the raw edge
+     *
+     * @param[in] debounced_state - debounced signal value
+     * @param[in] now - milli sec time the signal was debounced
+     *
+     * @return 0 if no button click or sequence in progress, positive click 
+     * count if short click sequence detected, negative click count if long 
+     * click terminates the short click sequence or a single long click detected
+     */
+    int check_debounced(bool debounced_state, system_tick_t now);
+
+    /**
+     * @brief Feeds a run of constant signal level, for sources that produce 
+     * run length data (logic analyzer exports, kernel edge timestamps, ISR
+     * edge capture)
+     *
+     * @details The run starts where the previous run, check_button() call or
+     * the constructor left off, and lasts duration milli secs. The debounce
+     * and sequence state is advanced analytically: only the debounce settle
+     * time and the timeouts that fall inside the run are evaluated, so the 
+     * cost depends on the number of edges and not on the elapsed time. The
+     * result is the same as calling check_button(level, now) every milli sec
+     * of the run. The button_id of the events is 0
+     *
+     * @param[in] level - signal value for the whole run
+     * @param[in] duration - milli secs the run lasts
+     * @param[out] events - sequences that terminated inside the run
+     * @param[in] max_events - size of the events array, at most 
+     * BUTTON_RUN_MAX_EVENTS sequences terminate inside a run
+     *
+     * @return number of sequences that terminated inside the run
+     */
+    size_t feed_run(bool level, system_tick_t duration, ButtonEvent* events,
+                    size_t max_events);
+
     /**
      * @brief Set the _long_duration_interval
      *
@@ -103,6 +208,131 @@ public:
      */
     uint32_t get_long_interval();
 
+    /**
+     * @brief Use a majority vote of the last samples as the debounce stage
+     *
+     * @details See Debounce::majority(). Intended for noisy inputs sampled at
+     * a fixed rate
+     *
+     * @param[in] window - number of samples voting (8, 16 or 32), 0 returns
+     * to the debounce interval
+     * @param[in] threshold - samples that must agree to change the state, 0 
+     * for three quarters of the window
+     */
+    void set_majority_filter(uint8_t window, uint8_t threshold = 0);
+
+    /**
+     * @brief Set the _stuck_interval
+     *
+     * @details A press held longer than this interval raises the stuck fault,
+     * the sequence is discarded and check_button() only reads the input 
+     * every STUCK_POLL_INTERVAL_MS until it releases. A state passed to
+     * check_button(state, now) is always applied. 0 uses 
+     * STUCK_INTERVAL_FACTOR times the long duration interval
+     *
+     * @param[in] stuck_interval - milli secs a press is held before it is 
+     * considered stuck, 0 for the default
+     */
+    void set_stuck_interval(system_tick_t stuck_interval);
+
+    /**
+     * @brief Get the interval a press is held before it is considered stuck
+     *
+     * @return the stuck interval in milliseconds
+     */
+    system_tick_t get_stuck_interval();
+
+    /**
+     * @brief Set a callback for the stuck fault
+     *
+     * @details The callback is called once when a press exceeds the stuck
+     * interval. It is called from check_button(). The context is not owned,
+     * it must outlive the button
+     *
+     * @param[in] stuck_fn - function called when the button is stuck, NULL
+     * for none
+     * @param[in] context - passed to stuck_fn
+     */
+    void set_stuck_callback(ButtonStuckFn stuck_fn, void* context = NULL);
+
+    /**
+     * @brief Check if the button is stuck
+     *
+     * @return true from the stuck fault until the button releases
+     */
+    bool is_stuck();
+
+    /**
+     * @brief Set a callback for instant press feedback
+     *
+     * @details The callback is called with PressPhase::TENTATIVE on the first
+     * raw edge towards pressed, before the debounce interval has passed, so 
+     * an LED can respond at once. It is followed by exactly one 
+     * PressPhase::CONFIRMED when the debounce confirms the press, or 
+     * PressPhase::CANCELLED when the signal settles back for the debounce
+     * interval without a press. Sequences are only counted on confirmed
+     * presses, as before. It is called from check_button(). The context is
+     * not owned, it must outlive the button
+     *
+     * @param[in] press_fn - function called with the context and the press
+     * phase, NULL for none
+     * @param[in] context - passed to press_fn
+     */
+    void set_press_callback(ButtonPressFn press_fn, void* context = NULL);
+
+    /**
+     * @brief Check if the button needs fast sampling
+     *
+     * @details The button is active while the debounce is unstable, the 
+     * button is pressed or a sequence is waiting on the short click or long
+     * click timeout. A stuck button is not active, it is sampled at
+     * STUCK_POLL_INTERVAL_MS
+     *
+     * @return true if the button is active, false if idle
+     */
+    bool is_active();
+
+    /**
+     * @brief Get the earliest time check_button() has work to do without a
+     * new edge
+     *
+     * @details The earliest of the debounce settle time, the short click or
+     * long click timeout of a sequence in progress, the stuck timeout of a 
+     * press, and the next sample of a stuck button whose input check_button()
+     * skipped reading. A stuck button fed its state has no deadline until
+     * the state changes
+     *
+     * @param[out] deadline - milli sec time of the next deadline
+     *
+     * @return true if a deadline is pending, false if the button is idle
+     */
+    bool next_deadline(system_tick_t& deadline);
+
+    /**
+     * @brief Get the work counted since the last reset_cost(), for this 
+     * button and its debounce, see ButtonCost.h
+     *
+     * @return the counters, zeros unless built with BUTTON_COST_ENABLE
+     */
+    ButtonCost cost();
+
+    /**
+     * @brief Zero the work counters and restart the measurement interval
+     */
+    void reset_cost();
+
+    /**
+     * @brief Get the latency tag of the last sequence returned by 
+     * check_button(), see ButtonLatency.h
+     *
+     * @details Read it right after check_button() returns a sequence and
+     * keep it with the event. feed_run() tags only the last sequence of a run
+     *
+     * @return the edge, confirm and emit times, zeros unless built with
+     * BUTTON_LATENCY_ENABLE
+     */
+    ButtonLatency latency();
+
 private:
 
     /**
@@ -116,14 +346,74 @@ private:
      * click finished
      * 
      * @param[in] state_changed - bool if the debounced state_changed
+     * @param[in] now - milli sec time of the update
      *
      * @return 0 if no button click or sequence in progress, positive click 
      * count if short click sequence detected, negative click count if long 
      * click terminates the short click sequence or a single long click detected
      */
-    int update_sequence(bool state_changed);
+    int update_sequence(bool state_changed, system_tick_t now);
+
+    /**
+     * @brief Rate limit the reads of a stuck button by check_button()
+     *
+     * @param[in] now - milli sec time of the poll
+     *
+     * @return true if this poll should be skipped
+     */
+    bool stuck_backoff(system_tick_t now);
+
+    /**
+     * @brief Report the tentative, confirmed and cancelled press phases
+     *
+     * @param[in] state_changed - bool if the debounced state_changed
+     * @param[in] now - milli sec time of the update
+     */
+    void update_tentative(bool state_changed, system_tick_t now);
+
+    /**
+     * @brief Remember the first raw edge of a pending debounced change, for
+     * the latency tag
+     *
+     * @param[in] state_changed - bool if the debounced state_changed
+     * @param[in] now - milli sec time of the update
+     */
+    void track_edge(bool state_changed, system_tick_t now);
 
     Debounce  debounce_button;
     system_tick_t _long_duration_interval;
     bool _active_low;
+
+    system_tick_t _long_press_timeout = 0;
+    system_tick_t _short_depress_timeout = 0;
+    system_tick_t _start_time = 0;
+    bool _pressed = false;
+    int _click_count = 0;
+
+    system_tick_t _stuck_interval = 0;
+    system_tick_t _stuck_poll_time = 0;
+    bool _stuck = false;
+    //check_button() skipped reading the input of the stuck button
+    bool _stuck_skipped = false;
+    bool _tentative = false;
+    ButtonStuckFn _stuck_fn = NULL;
+    void* _stuck_context = NULL;
+    ButtonPressFn _press_fn = NULL;
+    void* _press_context = NULL;
+
+    //milli sec time of the last update, where the next run starts
+    system_tick_t _run_time = 0;
+
+#ifdef BUTTON_COST_ENABLE
+    ButtonCost _cost = {};
+#endif
+
+#ifdef BUTTON_LATENCY_ENABLE
+    //first raw edge away from the debounced state, while _edge_pending
+    system_tick_t _edge_time = 0;
+    bool _edge_pending = false;
+    //first raw edge of the last debounced change, confirmed at _start_time
+    system_tick_t _change_edge = 0;
+    ButtonLatency _latency = {};
+#endif
 };
\ No newline at end of file
@@ -0,0 +1,122 @@
+/** 
+ * @file ButtonTelemetry.cpp
+ * @author Ed Ablan
+ * @version 1.0
+ * @date 10/17/2026
+ *
+ * @brief Compact binary telemetry of button sequences
+ *
+ * @details Blob layout, all varints are unsigned LEB128:
+ *  byte    format version
+ *  varint  interval start time in milli secs
+ *  varint  interval duration in milli secs
+ *  varint  events recorded
+ *  varint  events dropped
+ *  byte    number of histogram bins (N)
+ *  N x varint short sequence histogram, bin i counts i + 1 clicks
+ *  N x varint long sequence histogram, bin i counts i + 1 clicks
+ *  varint  length of the event section in bytes
+ *  events: varint delta milli secs from previous event (or interval start),
+ *          byte button id, varint zigzag encoded sequence
+ *
+ * @copyright Copyright (c) 2020 Particle Industries, Inc.  All rights reserved.
+ */
+
+#include "ButtonTelemetry.h"
+
+//Worst case size of a single encoded event
+#define TELEMETRY_MAX_EVENT_SIZE (5 + 1 + 5)
+
+ButtonTelemetry::ButtonTelemetry()
+{
+    reset();
+}
+
+size_t ButtonTelemetry::put_varint(uint8_t* out, uint32_t value)
+{
+    size_t len = 0;
+    while(value >= 0x80) {
+        out[len++] = (uint8_t)(value | 0x80);
+        value >>= 7;
+    }
+    out[len++] = (uint8_t)value;
+    return len;
+}
+
+bool ButtonTelemetry::record(uint8_t button_id, int sequence)
+{
+    if(!sequence) {
+        return false;
+    }
+
+    uint32_t clicks = (sequence < 0) ? -sequence : sequence;
+    uint32_t bin = (clicks > TELEMETRY_MAX_CLICKS) ? 
+                    TELEMETRY_MAX_CLICKS - 1 : clicks - 1;
+    if(sequence < 0) {_long_hist[bin]++;}
+    else {_short_hist[bin]++;}
+    _event_count++;
+
+    system_tick_t now = millis();
+    uint8_t event[TELEMETRY_MAX_EVENT_SIZE];
+    size_t len = put_varint(event, now - _last_time);
+    event[len++] = button_id;
+    //zigzag so short (positive) and long (negative) sequences stay one byte
+    len += put_varint(&event[len], 
+                    ((uint32_t)sequence << 1) ^ (uint32_t)(sequence >> 31));
+
+    if(_events_len + len > sizeof(_events)) {
+        _dropped++;
+        return false;
+    }
+    memcpy(&_events[_events_len], event, len);
+    _events_len += len;
+    _last_time = now;
+    return true;
+}
+
+size_t ButtonTelemetry::serialize(uint8_t* out, size_t out_len)
+{
+    //header and histograms are bounded, check against the worst case
+    size_t needed = 1 + 4*5 + 1 + 2*TELEMETRY_MAX_CLICKS*5 + 5 + _events_len;
+    if(out_len < needed) {
+        return 0;
+    }
+
+    size_t len = 0;
+    out[len++] = TELEMETRY_FORMAT_VERSION;
+    len += put_varint(&out[len], _start_time);
+    len += put_varint(&out[len], millis() - _start_time);
+    len += put_varint(&out[len], _event_count);
+    len += put_varint(&out[len], _dropped);
+    out[len++] = TELEMETRY_MAX_CLICKS;
+    for(int i = 0; i < TELEMETRY_MAX_CLICKS; i++) {
+        len += put_varint(&out[len], _short_hist[i]);
+    }
+    for(int i = 0; i < TELEMETRY_MAX_CLICKS; i++) {
+        len += put_varint(&out[len], _long_hist[i]);
+    }
+    len += put_varint(&out[len], _events_len);
+    memcpy(&out[len], _events, _events_len);
+    return len + _events_len;
+}
+
+void ButtonTelemetry::reset()
+{
+    _events_len = 0;
+    _start_time = millis();
+    _last_time = _start_time;
+    _event_count = 0;
+    _dropped = 0;
+    memset(_short_hist, 0, sizeof(_short_hist));
+    memset(_long_hist, 0, sizeof(_long_hist));
+}
+
+uint32_t ButtonTelemetry::event_count()
+{
+    return _event_count;
+}
+
+uint32_t ButtonTelemetry::dropped_count()
+{
+    return _dropped;
+}
@@ -0,0 +1,110 @@
+/** 
+ * @file ButtonTelemetry.h
+ * @author Ed Ablan
+ * @version 1.0
+ * @date 10/17/2026
+ *
+ * @brief Aggregates decoded button sequences into a compact binary buffer so
+ * that an interval of activity can be sent in a single publish
+ *
+ * @details Every recorded sequence is stored as a varint delta timestamp, the 
+ * button id and a zigzag varint of the sequence value returned by 
+ * check_button(). Per-gesture histograms of short and long sequences are kept
+ * alongside the events and survive a full event buffer. The host side decoder
+ * for the format is tools/telemetry_decode.py
+ *
+ * @copyright Copyright (c) 2020 Particle Industries, Inc.  All rights reserved.
+ */
+#pragma once
+
+#include "Particle.h"
+
+#ifndef TELEMETRY_BUFFER_SIZE
+#define TELEMETRY_BUFFER_SIZE 256
+#endif
+
+//Number of histogram bins, the last bin counts sequences of this many clicks
+//or more
+#ifndef TELEMETRY_MAX_CLICKS
+#define TELEMETRY_MAX_CLICKS 8
+#endif
+
+#define TELEMETRY_FORMAT_VERSION 1
+
+class ButtonTelemetry {
+public:
+
+    /**
+     * @brief Constructor for class, starts the first interval
+     */
+    ButtonTelemetry();
+
+    /**
+     * @brief Record a sequence returned by ButtonSequence::check_button()
+     *
+     * @details Adds the sequence to the histograms and appends an event to the
+     * binary buffer. When the buffer is full the event is counted as dropped,
+     * the histograms are still updated
+     *
+     * @param[in] button_id - application defined id of the button
+     * @param[in] sequence - value returned by check_button(), 0 is ignored
+     *
+     * @return true if the event was stored in the buffer, false if ignored
+     * or dropped
+     */
+    bool record(uint8_t button_id, int sequence);
+
+    /**
+     * @brief Serialize the interval into a binary blob for publishing
+     *
+     * @details Writes the header, histograms and events. Does not reset the
+     * interval, call reset() once the blob has been sent
+     *
+     * @param[out] out - buffer to write the blob to
+     * @param[in] out_len - size of the out buffer
+     *
+     * @return number of bytes written, 0 if out_len is too small
+     */
+    size_t serialize(uint8_t* out, size_t out_len);
+
+    /**
+     * @brief Discard the recorded events and histograms and start a new 
+     * interval
+     */
+    void reset();
+
+    /**
+     * @brief Get the number of events recorded in this interval
+     *
+     * @return events recorded, including dropped ones
+     */
+    uint32_t event_count();
+
+    /**
+     * @brief Get the number of events that did not fit in the buffer
+     *
+     * @return events dropped in this interval
+     */
+    uint32_t dropped_count();
+
+private:
+
+    /**
+     * @brief Append a LEB128 varint to a buffer
+     *
+     * @param[out] out - buffer to write to
+     * @param[in] value - value to encode
+     *
+     * @return number of bytes written, at most 5
+     */
+    static size_t put_varint(uint8_t* out, uint32_t value);
+
+    uint8_t _events[TELEMETRY_BUFFER_SIZE];
+    size_t _events_len;
+    system_tick_t _start_time;
+    system_tick_t _last_time;
+    uint32_t _event_count;
+    uint32_t _dropped;
+    uint32_t _short_hist[TELEMETRY_MAX_CLICKS];
+    uint32_t _long_hist[TELEMETRY_MAX_CLICKS];
+};
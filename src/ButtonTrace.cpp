@@ -0,0 +1,60 @@
+/** 
+ * @file ButtonTrace.cpp
+ * @author Ed Ablan
+ * @version 1.0
+ * @date 10/17/2026
+ *
+ * @brief Binary trace log ring and dump
+ *
+ * @details Please read the header file for more details
+ *
+ * @copyright Copyright (c) 2020 Particle Industries, Inc.  All rights reserved.
+ */
+
+#include "ButtonTrace.h"
+
+static_assert((BUTTON_TRACE_SIZE & (BUTTON_TRACE_SIZE - 1)) == 0, 
+                "BUTTON_TRACE_SIZE must be a power of 2");
+static_assert(sizeof(ButtonTraceRecord) == 12, "trace record is 12 bytes");
+
+#ifdef BUTTON_TRACE_ENABLE
+
+ButtonTraceRecord button_trace_ring[BUTTON_TRACE_SIZE];
+uint32_t button_trace_head = 0;
+
+size_t button_trace_dump(Print& out)
+{
+    uint32_t head = button_trace_head;
+    uint32_t count = (head < BUTTON_TRACE_SIZE) ? head : BUTTON_TRACE_SIZE;
+    uint32_t header[4] = {
+        BUTTON_TRACE_MAGIC,
+        BUTTON_TRACE_VERSION | (sizeof(ButtonTraceRecord) << 16),
+        count,
+        head - count,
+    };
+    out.write((const uint8_t*)header, sizeof(header));
+    for(uint32_t i = head - count; i != head; i++) {
+        out.write((const uint8_t*)&button_trace_ring[i & (BUTTON_TRACE_SIZE - 1)], 
+                    sizeof(ButtonTraceRecord));
+    }
+    return count;
+}
+
+void button_trace_clear()
+{
+    button_trace_head = 0;
+}
+
+#else
+
+size_t button_trace_dump(Print& out)
+{
+    (void)out;
+    return 0;
+}
+
+void button_trace_clear()
+{
+}
+
+#endif // BUTTON_TRACE_ENABLE
@@ -0,0 +1,104 @@
+/** 
+ * @file ButtonTrace.h
+ * @author Ed Ablan
+ * @version 1.0
+ * @date 10/17/2026
+ *
+ * @brief Binary trace log of the debounce and sequence hot path
+ *
+ * @details Printing from inside update() destroys the timing being debugged.
+ * With BUTTON_TRACE_ENABLE defined, trace points in Debounce and 
+ * ButtonSequence write fixed size records (trace id, micros() timestamp and
+ * two arguments) into a RAM ring, which costs a few instructions each. 
+ * Nothing is formatted on the device: button_trace_dump() writes the ring as
+ * binary at a convenient time and tools/trace_timeline.py renders it as a 
+ * timeline on the host. Without BUTTON_TRACE_ENABLE the trace points compile
+ * to nothing
+ *
+ * The ring is not protected against trace points in interrupts, trace from
+ * one context at a time
+ *
+ * @copyright Copyright (c) 2020 Particle Industries, Inc.  All rights reserved.
+ */
+#pragma once
+
+#include "Particle.h"
+
+//Number of records in the ring, must be a power of 2
+#ifndef BUTTON_TRACE_SIZE
+#define BUTTON_TRACE_SIZE 256
+#endif
+
+#define BUTTON_TRACE_MAGIC 0x43525442   // "BTRC"
+#define BUTTON_TRACE_VERSION 1
+
+//Trace ids, keep in sync with tools/trace_timeline.py and the names in
+//tools/trace/trace_sim.cpp
+enum ButtonTraceId : uint16_t {
+    TRACE_DEBOUNCE_RAW = 1,         //arg0 level, arg1 instance
+    TRACE_DEBOUNCE_STABLE = 2,      //arg0 level, arg1 instance
+    TRACE_SEQUENCE_PRESS = 3,       //arg0 click count, arg1 instance
+    TRACE_SEQUENCE_RELEASE = 4,     //arg0 click count, arg1 instance
+    TRACE_SEQUENCE_SHORT = 5,       //arg0 click count, arg1 instance
+    TRACE_SEQUENCE_LONG = 6,        //arg0 click count, arg1 instance
+    TRACE_SEQUENCE_STUCK = 7,       //arg0 0, arg1 instance
+    TRACE_USER = 0x100,             //first id free for the application
+};
+
+struct ButtonTraceRecord {
+    uint32_t timestamp;     //micros()
+    uint16_t id;
+    uint16_t arg0;
+    uint32_t arg1;
+};
+
+#ifdef BUTTON_TRACE_ENABLE
+
+extern ButtonTraceRecord button_trace_ring[BUTTON_TRACE_SIZE];
+extern uint32_t button_trace_head;
+
+/**
+ * @brief Write a trace record, use the BUTTON_TRACE() macro instead so the
+ * trace point disappears when tracing is disabled
+ *
+ * @param[in] id - trace id
+ * @param[in] arg0 - first argument
+ * @param[in] arg1 - second argument
+ */
+inline void button_trace(uint16_t id, uint16_t arg0, uint32_t arg1)
+{
+    ButtonTraceRecord& record = 
+        button_trace_ring[button_trace_head++ & (BUTTON_TRACE_SIZE - 1)];
+    record.timestamp = micros();
+    record.id = id;
+    record.arg0 = arg0;
+    record.arg1 = arg1;
+}
+
+#define BUTTON_TRACE(id, arg0, arg1) \
+    button_trace((id), (uint16_t)(arg0), (uint32_t)(arg1))
+
+#else
+
+#define BUTTON_TRACE(id, arg0, arg1) do {} while(0)
+
+#endif // BUTTON_TRACE_ENABLE
+
+/**
+ * @brief Write the ring as binary, oldest record first
+ *
+ * @details Writes a header (magic, version, record size, record count and the
+ * number of records overwritten) followed by the records in little endian.
+ * Call from a low priority context, e.g. when a serial command asks for it.
+ * Writes nothing when tracing is disabled
+ *
+ * @param[in] out - where to write the dump, e.g. Serial
+ *
+ * @return number of records written
+ */
+size_t button_trace_dump(Print& out);
+
+/**
+ * @brief Empty the ring
+ */
+void button_trace_clear();
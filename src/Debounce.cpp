@@ -12,7 +12,11 @@
  */
 
 #include "Debounce.h"
+
+#include <utility>
+
 #include "spark_wiring.h"
+#include "ButtonTrace.h"
 
 #define DEBOUNCE_STATE_DEBOUNCED (0)
 #define DEBOUNCE_STATE_UNSTABLE  (1)
@@ -20,11 +24,56 @@
 #define _BV(n) (1<<(n))
 
 Debounce::Debounce()
-    : _previousMillis(0)
+    : _read_fn(NULL)
+    , _read_context(NULL)
+    , _previousMillis(0)
     , _intervalMillis(30)
     , _state(0)
     , _pin(0)
-{}
+    , _history(0)
+    , _sampleMillis(0)
+    , _window(0)
+    , _threshold(0)
+{
+    resetCost();
+}
+
+Debounce::~Debounce()
+{
+    releaseSource();
+}
+
+Debounce::Debounce(const Debounce& other)
+    : Debounce()
+{
+    *this = other;
+}
+
+Debounce& Debounce::operator=(const Debounce& other)
+{
+    if(this == &other) {
+        return *this;
+    }
+    releaseSource();
+    _read_fn = other._read_fn;
+    _read_context = other._read_context;
+    if(_read_fn == readCallback) {
+        _read_context = new std::function<int32_t(void)>(
+                *static_cast<std::function<int32_t(void)>*>(_read_context));
+    }
+    _previousMillis = other._previousMillis;
+    _intervalMillis = other._intervalMillis;
+    _state = other._state;
+    _pin = other._pin;
+    _history = other._history;
+    _sampleMillis = other._sampleMillis;
+    _window = other._window;
+    _threshold = other._threshold;
+#ifdef BUTTON_COST_ENABLE
+    _cost = other._cost;
+#endif
+    return *this;
+}
 
 void Debounce::attach(pin_t pin)
 {
@@ -47,48 +96,115 @@ void Debounce::attach(pin_t pin, PinMode mode, uint32_t intervalMillis)
 void Debounce::attach(std::function<int32_t(void)> read_cb, uint32_t intervalMillis)
 {
     interval(intervalMillis);
-    _read_cb = read_cb;
+    releaseSource();
+    if(read_cb) {
+        _read_fn = readCallback;
+        _read_context = new std::function<int32_t(void)>(std::move(read_cb));
+    }
     start();
 }
 
+void Debounce::attach(DebounceReadFn read_fn, void* context, 
+                        uint32_t intervalMillis)
+{
+    interval(intervalMillis);
+    releaseSource();
+    _read_fn = read_fn;
+    _read_context = context;
+    start();
+}
+
+bool Debounce::readSource()
+{
+    if (_read_fn) {
+        return _read_fn(_read_context);
+    }
+    return digitalRead(_pin);
+}
+
+int32_t Debounce::readCallback(void* context)
+{
+    return (*static_cast<std::function<int32_t(void)>*>(context))();
+}
+
+void Debounce::releaseSource()
+{
+    if(_read_fn == readCallback) {
+        delete static_cast<std::function<int32_t(void)>*>(_read_context);
+    }
+    _read_fn = NULL;
+    _read_context = NULL;
+}
+
 void Debounce::interval(uint32_t intervalMillis)
 {
     _intervalMillis = intervalMillis;
 }
 
+void Debounce::majority(uint8_t window, uint8_t threshold)
+{
+    if(window > DEBOUNCE_MAJORITY_MAX_WINDOW) {
+        window = DEBOUNCE_MAJORITY_MAX_WINDOW;
+    }
+    _window = window;
+    _threshold = (threshold) ? threshold : (window * 3 + 3) / 4;
+    //a vote that can be won both ways would flip on every sample
+    if(_threshold * 2 <= _window) {_threshold = _window / 2 + 1;}
+    if(_threshold > _window) {_threshold = _window;}
+    //start from a full window of the debounced state
+    _history = (_state & _BV(DEBOUNCE_STATE_DEBOUNCED)) ? 0xFFFFFFFF : 0;
+}
+
 void Debounce::start()
 {
     _state = 0;
-    if ((_read_cb) ? _read_cb() : digitalRead(_pin)) {
+    if (readSource()) {
         _state = _BV(DEBOUNCE_STATE_DEBOUNCED) | _BV(DEBOUNCE_STATE_UNSTABLE);
     }
     _previousMillis = millis();
+    _history = (_state & _BV(DEBOUNCE_STATE_DEBOUNCED)) ? 0xFFFFFFFF : 0;
 }
 
 bool Debounce::update()
 {
     // Read the state of the switch in a temporary variable.
-    bool currentState = (_read_cb) ? _read_cb() : digitalRead(_pin);
+    bool currentState = readSource();
+    BUTTON_COST(_cost.reads);
     return update(currentState);
 }
 
 bool Debounce::update(bool currentState)
 {
+    BUTTON_COST(_cost.clock_reads);
+    return update(currentState, millis());
+}
+
+bool Debounce::update(bool currentState, uint32_t now)
+{
+    BUTTON_COST(_cost.polls);
     _state &= ~_BV(DEBOUNCE_STATE_CHANGED);
+    if (_window) {
+        return updateMajority(currentState, now);
+    }
 
     // If the read is different from last reading, reset the debounce counter
     if (currentState != (bool)(_state & _BV(DEBOUNCE_STATE_UNSTABLE)) ) {
-        _previousMillis = millis();
+        _previousMillis = now;
         _state ^= _BV(DEBOUNCE_STATE_UNSTABLE);
+        BUTTON_TRACE(TRACE_DEBOUNCE_RAW, currentState, (uintptr_t)this);
+        BUTTON_COST(_cost.edges);
     } else {
-        if (millis() - _previousMillis >= _intervalMillis) {
+        if (now - _previousMillis >= _intervalMillis) {
             // We have passed the threshold time, so the input is now stable
             // If it is different from last state, set the 
             //DEBOUNCE_STATE_CHANGED flag
             if ((bool)(_state & _BV(DEBOUNCE_STATE_DEBOUNCED)) != currentState) {
-                _previousMillis = millis();
+                _previousMillis = now;
                 _state ^= _BV(DEBOUNCE_STATE_DEBOUNCED);
                 _state |= _BV(DEBOUNCE_STATE_CHANGED);
+                BUTTON_TRACE(TRACE_DEBOUNCE_STABLE, currentState, 
+                            (uintptr_t)this);
+                BUTTON_COST(_cost.transitions);
             }
         }
     }
@@ -96,6 +212,158 @@ bool Debounce::update(bool currentState)
     return _state & _BV(DEBOUNCE_STATE_CHANGED);
 }
 
+bool Debounce::setState(bool value, uint32_t now)
+{
+    BUTTON_COST(_cost.polls);
+    bool changed = value != (bool)(_state & _BV(DEBOUNCE_STATE_DEBOUNCED));
+    _state = (value) ? 
+            (_BV(DEBOUNCE_STATE_DEBOUNCED) | _BV(DEBOUNCE_STATE_UNSTABLE)) : 0;
+    _sampleMillis = now;
+    _history = (value) ? 0xFFFFFFFF : 0;
+    if (changed) {
+        _previousMillis = now;
+        _state |= _BV(DEBOUNCE_STATE_CHANGED);
+        BUTTON_TRACE(TRACE_DEBOUNCE_STABLE, value, (uintptr_t)this);
+        BUTTON_COST(_cost.transitions);
+    }
+    return changed;
+}
+
+uint32_t Debounce::windowMask()
+{
+    return (_window >= 32) ? 0xFFFFFFFF : (1UL << _window) - 1;
+}
+
+bool Debounce::updateMajority(bool currentState, uint32_t now)
+{
+    _sampleMillis = now;
+    if (currentState != (bool)(_state & _BV(DEBOUNCE_STATE_UNSTABLE)) ) {
+        _previousMillis = now;
+        _state ^= _BV(DEBOUNCE_STATE_UNSTABLE);
+        BUTTON_TRACE(TRACE_DEBOUNCE_RAW, currentState, (uintptr_t)this);
+        BUTTON_COST(_cost.edges);
+    }
+
+    // Shift the sample in and vote, with hysteresis so the level only moves
+    // once threshold of the last window samples agree
+    _history = (_history << 1) | currentState;
+    uint32_t votes = __builtin_popcount(_history & windowMask());
+    bool level = _state & _BV(DEBOUNCE_STATE_DEBOUNCED);
+    bool next = (votes >= _threshold) || (level && votes > (uint32_t)(_window - _threshold));
+
+    if (next != level) {
+        _previousMillis = now;
+        _state ^= _BV(DEBOUNCE_STATE_DEBOUNCED);
+        _state |= _BV(DEBOUNCE_STATE_CHANGED);
+        BUTTON_TRACE(TRACE_DEBOUNCE_STABLE, next, (uintptr_t)this);
+        BUTTON_COST(_cost.transitions);
+    }
+    return _state & _BV(DEBOUNCE_STATE_CHANGED);
+}
+
+//Index of the first sample at or after from whose zero-ness differs from
+//level, n if the run lasts to the end of the block
+static size_t find_transition(const uint8_t* samples, size_t from, size_t n, 
+                                bool level)
+{
+    size_t i = from;
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    //8 samples at a time, high runs look for a zero byte, low runs for a non
+    //zero byte
+    const uint64_t ones = 0x0101010101010101ULL;
+    const uint64_t highs = 0x8080808080808080ULL;
+    for(; i + 8 <= n; i += 8) {
+        uint64_t word;
+        memcpy(&word, &samples[i], sizeof(word));
+        uint64_t found = (level) ? (word - ones) & ~word & highs : word;
+        if(found) {
+            return i + __builtin_ctzll(found) / 8;
+        }
+    }
+#endif
+    for(; i < n; i++) {
+        if((bool)samples[i] != level) {
+            return i;
+        }
+    }
+    return n;
+}
+
+size_t Debounce::updateBlock(const uint8_t* samples, size_t n, 
+                        uint32_t start_millis, uint32_t sample_period_micros, 
+                        DebounceEvent* events, size_t max_events)
+{
+    if(!n || !sample_period_micros) {
+        return 0;
+    }
+
+    //the vote counts every sample, no run can be skipped
+    if(_window) {
+        size_t count = 0;
+        for(size_t i = 0; i < n; i++) {
+            uint32_t timestamp = start_millis + 
+                        (uint32_t)((uint64_t)i * sample_period_micros / 1000);
+            if(update(samples[i], timestamp)) {
+                if(count < max_events) {
+                    events[count] = {(uint32_t)i, timestamp, read()};
+                }
+                count++;
+            }
+        }
+        return count;
+    }
+
+    const int64_t period = sample_period_micros;
+    bool raw = _state & _BV(DEBOUNCE_STATE_UNSTABLE);
+    bool debounced = _state & _BV(DEBOUNCE_STATE_DEBOUNCED);
+    //milli sec timestamp of the last raw change relative to samples[0], and
+    //the first sample that may change the debounced state
+    int64_t change_ms = -(int64_t)(int32_t)(start_millis - _previousMillis);
+    int64_t first = 0;
+    size_t count = 0;
+
+    BUTTON_COST(_cost.polls);
+    _state &= ~_BV(DEBOUNCE_STATE_CHANGED);
+    for(size_t i = 0; i < n; ) {
+        size_t next = find_transition(samples, i, n, raw);
+
+        //the run [i, next) holds raw, the debounced state follows once the
+        //interval has passed since the last change
+        if(raw != debounced) {
+            int64_t settle = debounce_settle_sample(change_ms + _intervalMillis,
+                                                    period, first);
+            if(settle < (int64_t)next) {
+                debounced = raw;
+                change_ms = settle * period / 1000;
+                if(count < max_events) {
+                    events[count].sample = settle;
+                    events[count].timestamp = start_millis + 
+                                                (uint32_t)change_ms;
+                    events[count].state = debounced;
+                }
+                count++;
+                _state |= _BV(DEBOUNCE_STATE_CHANGED);
+                BUTTON_TRACE(TRACE_DEBOUNCE_STABLE, debounced, (uintptr_t)this);
+                BUTTON_COST(_cost.transitions);
+            }
+        }
+        if(next < n) {
+            raw = !raw;
+            change_ms = (int64_t)next * period / 1000;
+            first = next + 1;
+            BUTTON_TRACE(TRACE_DEBOUNCE_RAW, raw, (uintptr_t)this);
+            BUTTON_COST(_cost.edges);
+        }
+        i = next + 1;
+    }
+
+    _state &= ~(_BV(DEBOUNCE_STATE_UNSTABLE) | _BV(DEBOUNCE_STATE_DEBOUNCED));
+    if(raw) {_state |= _BV(DEBOUNCE_STATE_UNSTABLE);}
+    if(debounced) {_state |= _BV(DEBOUNCE_STATE_DEBOUNCED);}
+    _previousMillis = start_millis + (uint32_t)change_ms;
+    return count;
+}
+
 bool Debounce::read()
 {
     return _state & _BV(DEBOUNCE_STATE_DEBOUNCED);
@@ -118,3 +386,53 @@ bool Debounce::isLow()
     update();
     return !( read() );
 }
+
+bool Debounce::isStable()
+{
+    if (_window) {
+        // Settled once the whole window agrees with the debounced state
+        uint32_t full = (_state & _BV(DEBOUNCE_STATE_DEBOUNCED)) ? 
+                            windowMask() : 0;
+        return (_history & windowMask()) == full;
+    }
+    return (bool)(_state & _BV(DEBOUNCE_STATE_UNSTABLE)) == 
+            (bool)(_state & _BV(DEBOUNCE_STATE_DEBOUNCED));
+}
+
+bool Debounce::nextDeadline(uint32_t& deadline)
+{
+    if(isStable()) {
+        return false;
+    }
+    // The vote needs every sample until the window agrees, one per milli sec
+    deadline = (_window) ? _sampleMillis + 1 : _previousMillis + _intervalMillis;
+    return true;
+}
+
+bool Debounce::readRaw()
+{
+    return _state & _BV(DEBOUNCE_STATE_UNSTABLE);
+}
+
+uint32_t Debounce::settleTime()
+{
+    // A vote is settled as soon as the window agrees, see isStable()
+    return (_window) ? _previousMillis : _previousMillis + _intervalMillis;
+}
+
+ButtonCost Debounce::cost()
+{
+#ifdef BUTTON_COST_ENABLE
+    return _cost;
+#else
+    return ButtonCost{};
+#endif
+}
+
+void Debounce::resetCost()
+{
+#ifdef BUTTON_COST_ENABLE
+    _cost = ButtonCost{};
+    _cost.start = millis();
+#endif
+}
@@ -17,6 +17,43 @@
 
 #include <functional>
 #include "Particle.h"
+#include "ButtonCost.h"
+
+//Longest majority vote window, one bit per sample
+#define DEBOUNCE_MAJORITY_MAX_WINDOW 32
+
+//A debounced state change found by Debounce::updateBlock()
+struct DebounceEvent {
+    uint32_t sample;        //index of the sample in the block
+    uint32_t timestamp;     //milli sec time of the sample
+    bool state;             //new debounced state
+};
+
+/**
+ * @brief Find the sample of a block at which a pending change settles
+ *
+ * @details Samples are timestamped like update(value, now) would be called
+ * for them, start_millis + index * period / 1000 rounded down, so the result
+ * is the sample the per sample path settles at
+ *
+ * @param[in] target_ms - milli sec time relative to samples[0] the change
+ * settles at, the last raw change plus the interval
+ * @param[in] period - micro secs between samples
+ * @param[in] first - first sample that may settle
+ *
+ * @return index of the sample, may be past the end of the block
+ */
+inline int64_t debounce_settle_sample(int64_t target_ms, int64_t period,
+                                        int64_t first)
+{
+    int64_t sample = (target_ms <= 0) ? 0 : 
+                        (target_ms * 1000 + period - 1) / period;
+    return (sample < first) ? first : sample;
+}
+
+//Read source that is a plain function and a context pointer, called with one
+//indirect call and nothing copied or allocated
+typedef int32_t (*DebounceReadFn)(void* context);
 
 class Debounce {
 public:
@@ -26,6 +63,17 @@ public:
      */
     Debounce();
 
+    /**
+     * @brief Destructor, frees the callback attached with std::function
+     */
+    ~Debounce();
+
+    /**
+     * @brief Copy, the callback attached with std::function is copied too
+     */
+    Debounce(const Debounce& other);
+    Debounce& operator=(const Debounce& other);
+
     /**
      * @brief Attach to a pin (and also sets initial state)
      *
@@ -66,13 +114,32 @@ public:
      * callback function is used so the programmer can write their own custom
      * function for reading a signal if something more complicated that 
      * digitalRead() is needed. If a basic digitalRead() is sufficient to read
-     * the pin, just use one of the above attach() functions.
+     * the pin, just use one of the above attach() functions. The callback is
+     * kept on the heap, so a debounce without one carries a single pointer
+     * for it; attach a DebounceReadFn below where nothing may be allocated
      *
      * @param[in] read_cb - callback function to do the reading of the signal
      * @param[in] intervalMillis - debounce interval
      */
     void attach(std::function<int32_t(void)> read_cb, uint32_t intervalMillis);
 
+    /**
+     * @brief Attach a read function with a context pointer, and interval in 
+     * milliseconds
+     *
+     * @details Same as the callback attach() without the std::function: the
+     * function pointer and context are stored as they are and every read is
+     * a single indirect call. The context is not owned, it must outlive the 
+     * debounce
+     *
+     * @param[in] read_fn - function that returns the signal state, called 
+     * with context
+     * @param[in] context - passed to read_fn, e.g. the object that reads the
+     * signal
+     * @param[in] intervalMillis - debounce interval
+     */
+    void attach(DebounceReadFn read_fn, void* context, uint32_t intervalMillis);
+
     /**
      * @brief Sets the debounce interval
      *
@@ -82,6 +149,25 @@ public:
      */
     void interval(uint32_t intervalMillis);
 
+    /**
+     * @brief Use a majority vote of the last samples instead of the debounce
+     * interval
+     *
+     * @details For noisy, EMI heavy installs where periodic spikes keep 
+     * restarting the debounce interval. The last window samples are kept in
+     * a shift register; the debounced state goes high once threshold of them
+     * are high, and low once threshold of them are low. Each update is a 
+     * shift and a popcount. The vote counts samples, not time, so the signal
+     * should be sampled at a fixed rate; while the window is mixed 
+     * nextDeadline() asks for a sample every milli sec
+     *
+     * @param[in] window - number of samples voting (8, 16 or 32), 0 returns
+     * to the debounce interval
+     * @param[in] threshold - samples that must agree to change the state, more
+     * than half the window. 0 uses three quarters of the window
+     */
+    void majority(uint8_t window, uint8_t threshold = 0);
+
     /**
      * @brief Update the debouce counters, and check for a stable signal. This
      * version of update will read the digial pin or use the callback to get
@@ -108,6 +194,61 @@ public:
      */
     bool update(bool value);
 
+    /**
+     * @brief Pass the signal value and the time it was sampled, Update the 
+     * debouce counters, and check for a stable signal. This version is used 
+     * when the samples carry their own timestamps instead of millis()
+     *
+     * @details updates the bit states for the signal, and check against the 
+     * debounce time, if it is stable return that the state changed
+     * 
+     * @param[in] value - signal value that will be debounced
+     * @param[in] now - milli sec time the value was sampled
+     *
+     * @return 1 if the state changed, 0 if the state did not change
+     */
+    bool update(bool value, uint32_t now);
+
+    /**
+     * @brief Set the debounced state of a signal that is debounced elsewhere,
+     * such as a bit of a DebounceBank
+     *
+     * @details The raw and debounced state both take the value at once, the
+     * debounce interval and majority vote are not applied
+     *
+     * @param[in] value - debounced signal value
+     * @param[in] now - milli sec time the value was debounced
+     *
+     * @return 1 if the state changed, 0 if the state did not change
+     */
+    bool setState(bool value, uint32_t now);
+
+    /**
+     * @brief Debounce a block of samples captured at a fixed rate, such as a
+     * timer plus DMA buffer
+     *
+     * @details Equivalent to calling update(value, now) for every sample, 
+     * but runs of identical samples are skipped a word at a time and only the
+     * transitions are processed. Timestamps are derived from the sample 
+     * index as start_millis + index * sample_period_micros / 1000 rounded
+     * down to the milli sec, the same now update() would be passed, so the
+     * state settles at the same sample for any period. Like 
+     * snprintf() the return value counts every change, if it is larger than
+     * max_events the later changes were applied but not reported
+     *
+     * @param[in] samples - one byte per sample, 0 for low, non zero for high
+     * @param[in] n - number of samples
+     * @param[in] start_millis - milli sec time of samples[0]
+     * @param[in] sample_period_micros - micro secs between samples
+     * @param[out] events - debounced state changes, in sample order
+     * @param[in] max_events - size of the events array
+     *
+     * @return number of debounced state changes in the block
+     */
+    size_t updateBlock(const uint8_t* samples, size_t n, uint32_t start_millis,
+                        uint32_t sample_period_micros, DebounceEvent* events, 
+                        size_t max_events);
+
     /**
      * @brief Get the updated signal state
      * 
@@ -144,6 +285,56 @@ public:
      */
     bool isLow();
 
+    /**
+     * @brief Check if the signal is settled
+     *
+     * @details The signal is settled when the last read matches the 
+     * debounced state, so no debounce interval is pending
+     *
+     * @return true if no state change is pending, false if unstable
+     */
+    bool isStable();
+
+    /**
+     * @brief Get the time the pending state change settles
+     *
+     * @details While the signal is unstable an update at or after the 
+     * deadline with the same value changes the debounced state
+     *
+     * @param[out] deadline - milli sec time the debounce interval ends
+     *
+     * @return true if a deadline is pending, false if the signal is stable
+     */
+    bool nextDeadline(uint32_t& deadline);
+
+    /**
+     * @brief Get the last read without debouncing
+     *
+     * @return the value passed to, or read by, the last update
+     */
+    bool readRaw();
+
+    /**
+     * @brief Get the time the last change of the signal, or of the debounced
+     * state, has held for the debounce interval
+     *
+     * @return milli sec time the signal is settled
+     */
+    uint32_t settleTime();
+
+    /**
+     * @brief Get the work counted since the last resetCost(), see 
+     * ButtonCost.h
+     *
+     * @return the counters, zeros unless built with BUTTON_COST_ENABLE
+     */
+    ButtonCost cost();
+
+    /**
+     * @brief Zero the work counters and restart the measurement interval
+     */
+    void resetCost();
+
 private:
     /**
      * @brief Starts up the debounce counters and time
@@ -153,11 +344,58 @@ private:
      */
     void start();
 
+    /**
+     * @brief update() for the majority vote
+     *
+     * @param[in] value - signal value that will be debounced
+     * @param[in] now - milli sec time the value was sampled
+     *
+     * @return 1 if the state changed, 0 if the state did not change
+     */
+    bool updateMajority(bool value, uint32_t now);
+
+    /**
+     * @brief Get the mask of the samples that vote
+     *
+     * @return the low window bits set
+     */
+    uint32_t windowMask();
+
+    /**
+     * @brief Read the signal from the attached source
+     *
+     * @return the read function, callback or pin value
+     */
+    bool readSource();
+
+    /**
+     * @brief DebounceReadFn of a callback attached with std::function
+     *
+     * @param[in] context - the std::function owned by the debounce
+     *
+     * @return the value the callback returned
+     */
+    static int32_t readCallback(void* context);
+
+    /**
+     * @brief Free the std::function callback if one is attached
+     */
+    void releaseSource();
 
 protected:
-    std::function<int32_t(void)> _read_cb;
+    //read function and context, readCallback() and the std::function owned
+    //by the debounce for a std::function callback
+    DebounceReadFn _read_fn;
+    void* _read_context;
     uint32_t _previousMillis;
     uint32_t _intervalMillis;
     uint8_t _state;
     pin_t _pin;
+    uint32_t _history;
+    uint32_t _sampleMillis;
+    uint8_t _window;
+    uint8_t _threshold;
+#ifdef BUTTON_COST_ENABLE
+    ButtonCost _cost;
+#endif
 };
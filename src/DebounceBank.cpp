@@ -0,0 +1,275 @@
+/** 
+ * @file DebounceBank.cpp
+ * @author Ed Ablan
+ * @version 1.0
+ * @date 10/17/2026
+ *
+ * @brief Debounce up to 32 switches read as one word
+ *
+ * @details Please read the header file for more details
+ *
+ * @copyright Copyright (c) 2020 Particle Industries, Inc.  All rights reserved.
+ */
+
+#include "DebounceBank.h"
+#include "spark_wiring.h"
+
+DebounceBank::DebounceBank()
+    : _intervalMillis(30)
+    , _raw(0)
+    , _debounced(0)
+    , _changed(0)
+    , _unsettled(0)
+    , _sampleMillis(0)
+    , _window(0)
+    , _threshold(0)
+{
+    memset(_previousMillis, 0, sizeof(_previousMillis));
+    memset(_history, 0, sizeof(_history));
+}
+
+void DebounceBank::attach(std::function<uint32_t(void)> read_cb, 
+                            uint32_t intervalMillis)
+{
+    _read_cb = read_cb;
+    attach(_read_cb(), intervalMillis);
+}
+
+void DebounceBank::attach(uint32_t initial_state, uint32_t intervalMillis)
+{
+    interval(intervalMillis);
+    _raw = initial_state;
+    _debounced = initial_state;
+    _changed = 0;
+    _unsettled = 0;
+    uint32_t now = millis();
+    for(int i = 0; i < DEBOUNCE_BANK_WIDTH; i++) {
+        _previousMillis[i] = now;
+        _history[i] = (initial_state & (1UL << i)) ? 0xFFFFFFFF : 0;
+    }
+}
+
+void DebounceBank::majority(uint8_t window, uint8_t threshold)
+{
+    if(window > DEBOUNCE_MAJORITY_MAX_WINDOW) {
+        window = DEBOUNCE_MAJORITY_MAX_WINDOW;
+    }
+    _window = window;
+    _threshold = (threshold) ? threshold : (window * 3 + 3) / 4;
+    //a vote that can be won both ways would flip on every sample
+    if(_threshold * 2 <= _window) {_threshold = _window / 2 + 1;}
+    if(_threshold > _window) {_threshold = _window;}
+    for(int i = 0; i < DEBOUNCE_BANK_WIDTH; i++) {
+        _history[i] = (_debounced & (1UL << i)) ? 0xFFFFFFFF : 0;
+    }
+    _unsettled = 0;
+}
+
+void DebounceBank::interval(uint32_t intervalMillis)
+{
+    _intervalMillis = intervalMillis;
+}
+
+uint32_t DebounceBank::update()
+{
+    return update(_read_cb(), millis());
+}
+
+uint32_t DebounceBank::update(uint32_t value)
+{
+    return update(value, millis());
+}
+
+uint32_t DebounceBank::update(uint32_t value, uint32_t now)
+{
+    if(_window) {
+        return updateMajority(value, now);
+    }
+
+    // Restart the debounce interval of every bit that differs from last read
+    uint32_t toggled = value ^ _raw;
+    _raw = value;
+    for(uint32_t bits = toggled; bits; bits &= bits - 1) {
+        _previousMillis[__builtin_ctz(bits)] = now;
+    }
+
+    // Bits that held their new value for the interval are now stable
+    _changed = 0;
+    for(uint32_t bits = (_raw ^ _debounced) & ~toggled; bits; bits &= bits - 1) {
+        int bit = __builtin_ctz(bits);
+        if(now - _previousMillis[bit] >= _intervalMillis) {
+            _previousMillis[bit] = now;
+            _changed |= 1UL << bit;
+        }
+    }
+    _debounced ^= _changed;
+    return _changed;
+}
+
+uint32_t DebounceBank::updateMajority(uint32_t value, uint32_t now)
+{
+    const uint32_t mask = (_window >= 32) ? 0xFFFFFFFF : (1UL << _window) - 1;
+    const uint32_t against = _window - _threshold;
+    uint32_t high = 0, low = 0, mixed = 0;
+
+    // Branch free over every bit so the loop vectorizes
+    for(int bit = 0; bit < DEBOUNCE_BANK_WIDTH; bit++) {
+        uint32_t history = (_history[bit] << 1) | ((value >> bit) & 1);
+        uint32_t votes = __builtin_popcount(history & mask);
+        _history[bit] = history;
+        high |= (uint32_t)(votes >= _threshold) << bit;
+        low |= (uint32_t)(votes <= against) << bit;
+        mixed |= (uint32_t)(votes != 0 && votes != _window) << bit;
+    }
+
+    uint32_t next = high | (_debounced & ~low);
+    _changed = next ^ _debounced;
+    for(uint32_t bits = (value ^ _raw) | _changed; bits; bits &= bits - 1) {
+        _previousMillis[__builtin_ctz(bits)] = now;
+    }
+    _debounced = next;
+    _raw = value;
+    //a full window that disagrees with the state cannot happen after the vote
+    _unsettled = mixed;
+    _sampleMillis = now;
+    return _changed;
+}
+
+size_t DebounceBank::updateBlock(const uint32_t* samples, size_t n, 
+                        uint32_t start_millis, uint32_t sample_period_micros, 
+                        DebounceBankEvent* events, size_t max_events)
+{
+    if(!n || !sample_period_micros) {
+        return 0;
+    }
+
+    //the vote counts every sample, no run can be skipped
+    if(_window) {
+        size_t count = 0;
+        for(size_t i = 0; i < n; i++) {
+            uint32_t timestamp = start_millis + 
+                        (uint32_t)((uint64_t)i * sample_period_micros / 1000);
+            uint32_t changed = update(samples[i], timestamp);
+            if(changed) {
+                if(count < max_events) {
+                    events[count] = {(uint32_t)i, timestamp, changed, _debounced};
+                }
+                count++;
+            }
+        }
+        return count;
+    }
+
+    const int64_t period = sample_period_micros;
+    //per bit, the milli sec timestamp of the last change relative to 
+    //samples[0] and the sample at which a pending change settles, on the
+    //floored timestamps update() would be passed. A change in the block
+    //never settles at the sample that changed
+    int64_t settle[DEBOUNCE_BANK_WIDTH];
+    int64_t change_ms[DEBOUNCE_BANK_WIDTH];
+    for(uint32_t bits = _raw ^ _debounced; bits; bits &= bits - 1) {
+        int bit = __builtin_ctz(bits);
+        change_ms[bit] = -(int64_t)(int32_t)(start_millis - 
+                                            _previousMillis[bit]);
+        settle[bit] = debounce_settle_sample(change_ms[bit] + _intervalMillis,
+                                                period, 0);
+    }
+
+    size_t count = 0;
+    _changed = 0;
+    for(size_t i = 0; i < n; ) {
+        // Skip the run of words equal to the last read
+        size_t next = i;
+        while(next < n && samples[next] == _raw) {next++;}
+
+        // Settle the pending bits in sample order until the run ends
+        for(;;) {
+            uint32_t pending = _raw ^ _debounced;
+            int64_t at = next;
+            for(uint32_t bits = pending; bits; bits &= bits - 1) {
+                int bit = __builtin_ctz(bits);
+                if(settle[bit] < at) {at = settle[bit];}
+            }
+            if(at >= (int64_t)next) {
+                break;
+            }
+            uint32_t changed = 0;
+            for(uint32_t bits = pending; bits; bits &= bits - 1) {
+                int bit = __builtin_ctz(bits);
+                if(settle[bit] == at) {
+                    changed |= 1UL << bit;
+                    change_ms[bit] = at * period / 1000;
+                }
+            }
+            _debounced ^= changed;
+            _changed |= changed;
+            if(count < max_events) {
+                events[count].sample = at;
+                events[count].timestamp = start_millis + 
+                                            (uint32_t)(at * period / 1000);
+                events[count].changed = changed;
+                events[count].state = _debounced;
+            }
+            count++;
+        }
+
+        if(next < n) {
+            uint32_t toggled = samples[next] ^ _raw;
+            _raw = samples[next];
+            for(uint32_t bits = toggled; bits; bits &= bits - 1) {
+                int bit = __builtin_ctz(bits);
+                change_ms[bit] = (int64_t)next * period / 1000;
+                settle[bit] = debounce_settle_sample(
+                        change_ms[bit] + _intervalMillis, period, next + 1);
+            }
+        }
+        //the word at next starts the next run, bits that did not toggle may
+        //still settle at it
+        i = next;
+    }
+
+    for(uint32_t bits = (_raw ^ _debounced) | _changed; bits; bits &= bits - 1) {
+        int bit = __builtin_ctz(bits);
+        _previousMillis[bit] = start_millis + (uint32_t)change_ms[bit];
+    }
+    return count;
+}
+
+uint32_t DebounceBank::read()
+{
+    return _debounced;
+}
+
+uint32_t DebounceBank::changed()
+{
+    return _changed;
+}
+
+uint32_t DebounceBank::unstable()
+{
+    return (_window) ? _unsettled : _raw ^ _debounced;
+}
+
+bool DebounceBank::isStable()
+{
+    return !unstable();
+}
+
+bool DebounceBank::nextDeadline(uint32_t& deadline)
+{
+    // The vote needs every sample until the windows agree, one per milli sec
+    if(_window) {
+        deadline = _sampleMillis + 1;
+        return _unsettled;
+    }
+
+    bool pending = false;
+    for(uint32_t bits = _raw ^ _debounced; bits; bits &= bits - 1) {
+        uint32_t settle = _previousMillis[__builtin_ctz(bits)] + _intervalMillis;
+        if(!pending || (int32_t)(settle - deadline) < 0) {
+            deadline = settle;
+            pending = true;
+        }
+    }
+    return pending;
+}
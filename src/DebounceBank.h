@@ -0,0 +1,192 @@
+/** 
+ * @file DebounceBank.h
+ * @author Ed Ablan
+ * @version 1.0
+ * @date 10/17/2026
+ *
+ * @brief Used to debounce up to 32 switches or buttons that are read together
+ * as one word, such as a GPIO port, a shift register chain or an expander
+ *
+ * @details Every bit is debounced exactly like a Debounce instance, but the
+ * whole word is updated at once and only the bits that changed or are 
+ * waiting to settle are looked at individually
+ *
+ * @copyright Copyright (c) 2020 Particle Industries, Inc.  All rights reserved.
+ */
+#pragma once
+
+#include <functional>
+#include "Debounce.h"
+
+#define DEBOUNCE_BANK_WIDTH 32
+
+//Debounced state changes found by DebounceBank::updateBlock() at one sample
+struct DebounceBankEvent {
+    uint32_t sample;        //index of the sample in the block
+    uint32_t timestamp;     //milli sec time of the sample
+    uint32_t changed;       //bits whose debounced state changed
+    uint32_t state;         //debounced word after the change
+};
+
+class DebounceBank {
+public:
+
+    /**
+     * @brief Constructor for class
+     */
+    DebounceBank();
+
+    /**
+     * @brief Attach the callback that reads the word, and interval in 
+     * milliseconds. The initial state is read from the callback
+     *
+     * @param[in] read_cb - callback function that returns the input word
+     * @param[in] intervalMillis - debounce interval
+     */
+    void attach(std::function<uint32_t(void)> read_cb, uint32_t intervalMillis);
+
+    /**
+     * @brief Set the initial state and interval in milliseconds for words that
+     * are passed to update()
+     *
+     * @param[in] initial_state - input word at start up
+     * @param[in] intervalMillis - debounce interval
+     */
+    void attach(uint32_t initial_state, uint32_t intervalMillis);
+
+    /**
+     * @brief Sets the debounce interval
+     *
+     * @param[in] intervalMillis -  debounce interval time
+     */
+    void interval(uint32_t intervalMillis);
+
+    /**
+     * @brief Use a majority vote of the last samples of every bit instead of 
+     * the debounce interval, see Debounce::majority()
+     *
+     * @details Every bit keeps its own shift register. The vote of all 32 bits
+     * is a branch free loop of shifts and popcounts that the compiler can 
+     * vectorize
+     *
+     * @param[in] window - number of samples voting (8, 16 or 32), 0 returns
+     * to the debounce interval
+     * @param[in] threshold - samples that must agree to change the state, more
+     * than half the window. 0 uses three quarters of the window
+     */
+    void majority(uint8_t window, uint8_t threshold = 0);
+
+    /**
+     * @brief Read the word with the callback and update the debounce state
+     *
+     * @return bits whose debounced state changed, 0 if none
+     */
+    uint32_t update();
+
+    /**
+     * @brief Pass the input word and update the debounce state
+     *
+     * @param[in] value - input word
+     *
+     * @return bits whose debounced state changed, 0 if none
+     */
+    uint32_t update(uint32_t value);
+
+    /**
+     * @brief Pass the input word and the time it was sampled and update the
+     * debounce state
+     *
+     * @param[in] value - input word
+     * @param[in] now - milli sec time the word was sampled
+     *
+     * @return bits whose debounced state changed, 0 if none
+     */
+    uint32_t update(uint32_t value, uint32_t now);
+
+    /**
+     * @brief Debounce a block of words captured at a fixed rate, such as a
+     * timer plus DMA buffer of a GPIO port
+     *
+     * @details Equivalent to calling update(value, now) for every word, but 
+     * runs of identical words are skipped and only the transitions are 
+     * processed. Timestamps are derived from the sample index as
+     * start_millis + index * sample_period_micros / 1000 rounded down to the
+     * milli sec, the same now update() would be passed, so every bit settles
+     * at the same sample for any period. Like 
+     * snprintf() the return value counts every event, if it is larger than
+     * max_events the later events were applied but not reported
+     *
+     * @param[in] samples - input words
+     * @param[in] n - number of samples
+     * @param[in] start_millis - milli sec time of samples[0]
+     * @param[in] sample_period_micros - micro secs between samples
+     * @param[out] events - debounced state changes, in sample order
+     * @param[in] max_events - size of the events array
+     *
+     * @return number of samples at which the debounced state changed
+     */
+    size_t updateBlock(const uint32_t* samples, size_t n, uint32_t start_millis,
+                        uint32_t sample_period_micros, DebounceBankEvent* events,
+                        size_t max_events);
+
+    /**
+     * @brief Get the debounced word
+     *
+     * @return debounced state of every bit
+     */
+    uint32_t read();
+
+    /**
+     * @brief Get the bits that changed in the last update
+     *
+     * @return bits whose debounced state changed
+     */
+    uint32_t changed();
+
+    /**
+     * @brief Get the bits whose last read differs from the debounced state
+     *
+     * @return bits waiting for the debounce interval
+     */
+    uint32_t unstable();
+
+    /**
+     * @brief Check if every bit is settled
+     *
+     * @return true if no state change is pending
+     */
+    bool isStable();
+
+    /**
+     * @brief Get the time the earliest pending state change settles
+     *
+     * @param[out] deadline - milli sec time the first debounce interval ends
+     *
+     * @return true if a deadline is pending, false if every bit is stable
+     */
+    bool nextDeadline(uint32_t& deadline);
+
+protected:
+    std::function<uint32_t(void)> _read_cb;
+    uint32_t _previousMillis[DEBOUNCE_BANK_WIDTH];
+    uint32_t _intervalMillis;
+    uint32_t _raw;
+    uint32_t _debounced;
+    uint32_t _changed;
+    uint32_t _history[DEBOUNCE_BANK_WIDTH];
+    uint32_t _unsettled;
+    uint32_t _sampleMillis;
+    uint8_t _window;
+    uint8_t _threshold;
+
+private:
+    /**
+     * @brief update() for the majority vote
+     *
+     * @param[in] value - input word
+     * @param[in] now - milli sec time the word was sampled
+     *
+     * @return bits whose debounced state changed, 0 if none
+     */
+    uint32_t updateMajority(uint32_t value, uint32_t now);
+};
@@ -0,0 +1,143 @@
+/** 
+ * @file LinuxButtonNotifier.cpp
+ * @author Ed Ablan
+ * @version 1.0
+ * @date 10/17/2026
+ *
+ * @brief eventfd and timerfd readiness for button events
+ *
+ * @details Please read the header file for more details
+ *
+ * @copyright Copyright (c) 2020 Particle Industries, Inc.  All rights reserved.
+ */
+
+#include "LinuxButtonNotifier.h"
+
+#if defined(__linux__)
+
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+
+#include "LinuxInputSource.h"
+
+LinuxButtonNotifier::LinuxButtonNotifier()
+    : _head(0)
+    , _count(0)
+    , _dropped(0)
+    , _button_count(0)
+    , _event_fd(-1)
+    , _timer_fd(-1)
+{}
+
+LinuxButtonNotifier::~LinuxButtonNotifier()
+{
+    if(_event_fd >= 0) {close(_event_fd);}
+    if(_timer_fd >= 0) {close(_timer_fd);}
+}
+
+bool LinuxButtonNotifier::begin()
+{
+    //called again, the descriptors already created are kept
+    if(_event_fd < 0) {
+        _event_fd = eventfd((_count) ? 1 : 0, EFD_NONBLOCK | EFD_CLOEXEC);
+    }
+    if(_timer_fd < 0) {
+        _timer_fd = timerfd_create(CLOCK_MONOTONIC, 
+                                    TFD_NONBLOCK | TFD_CLOEXEC);
+    }
+    return _event_fd >= 0 && _timer_fd >= 0;
+}
+
+bool LinuxButtonNotifier::add(ButtonSequence* button)
+{
+    if(_button_count >= LINUX_NOTIFIER_MAX_BUTTONS) {
+        return false;
+    }
+    _buttons[_button_count++] = button;
+    return true;
+}
+
+bool LinuxButtonNotifier::push(const ButtonEvent& event)
+{
+    if(_count >= LINUX_NOTIFIER_QUEUE_SIZE) {
+        _dropped++;
+        return false;
+    }
+    _queue[(_head + _count) % LINUX_NOTIFIER_QUEUE_SIZE] = event;
+    //only the transition to non empty needs a wakeup
+    if(_count++ == 0) {
+        uint64_t one = 1;
+        (void)write(_event_fd, &one, sizeof(one));
+    }
+    return true;
+}
+
+bool LinuxButtonNotifier::pop(ButtonEvent& event)
+{
+    if(!_count) {
+        return false;
+    }
+    event = _queue[_head];
+    _head = (_head + 1) % LINUX_NOTIFIER_QUEUE_SIZE;
+    if(--_count == 0) {
+        uint64_t value;
+        (void)read(_event_fd, &value, sizeof(value));
+    }
+    return true;
+}
+
+void LinuxButtonNotifier::rearm()
+{
+    system_tick_t now = LinuxInputSource::now();
+    bool pending = false;
+    int32_t wait = 0;
+
+    for(size_t i = 0; i < _button_count; i++) {
+        system_tick_t deadline;
+        if(_buttons[i]->next_deadline(deadline)) {
+            int32_t remaining = (int32_t)(deadline - now);
+            if(!pending || remaining < wait) {
+                wait = remaining;
+                pending = true;
+            }
+        }
+    }
+
+    //an all zero it_value disarms, a deadline already passed fires at once
+    struct itimerspec spec = {};
+    if(pending) {
+        if(wait > 0) {
+            spec.it_value.tv_sec = wait / 1000;
+            spec.it_value.tv_nsec = (wait % 1000) * 1000000L;
+        }
+        else {
+            spec.it_value.tv_nsec = 1;
+        }
+    }
+    timerfd_settime(_timer_fd, 0, &spec, NULL);
+}
+
+bool LinuxButtonNotifier::timer_expired()
+{
+    uint64_t expirations = 0;
+    return read(_timer_fd, &expirations, sizeof(expirations)) == 
+                sizeof(expirations) && expirations;
+}
+
+int LinuxButtonNotifier::event_fd()
+{
+    return _event_fd;
+}
+
+int LinuxButtonNotifier::timer_fd()
+{
+    return _timer_fd;
+}
+
+uint32_t LinuxButtonNotifier::dropped()
+{
+    return _dropped;
+}
+
+#endif // __linux__
@@ -0,0 +1,136 @@
+/** 
+ * @file LinuxButtonNotifier.h
+ * @author Ed Ablan
+ * @version 1.0
+ * @date 10/17/2026
+ *
+ * @brief Readiness file descriptors for decoded button events and button 
+ * deadlines on embedded Linux
+ *
+ * @details Decoded events are queued in a fixed size queue and signalled on
+ * an eventfd. A timerfd is armed to the earliest deadline of the buttons 
+ * (debounce settle, short click or long click timeout), so an epoll or select
+ * based service can block with no CPU use while idle and still run the 
+ * timeouts on time. Times use the LinuxInputSource::now() monotonic clock
+ *
+ * Only compiled for Linux targets
+ *
+ * @copyright Copyright (c) 2020 Particle Industries, Inc.  All rights reserved.
+ */
+#pragma once
+
+#if defined(__linux__)
+
+#include "ButtonSequence.h"
+
+#ifndef LINUX_NOTIFIER_QUEUE_SIZE
+#define LINUX_NOTIFIER_QUEUE_SIZE 32
+#endif
+
+#ifndef LINUX_NOTIFIER_MAX_BUTTONS
+#define LINUX_NOTIFIER_MAX_BUTTONS 32
+#endif
+
+class LinuxButtonNotifier {
+public:
+
+    /**
+     * @brief Constructor for class
+     */
+    LinuxButtonNotifier();
+
+    /**
+     * @brief Destructor, closes the eventfd and timerfd
+     */
+    ~LinuxButtonNotifier();
+
+    /**
+     * @brief Create the eventfd and timerfd
+     *
+     * @details Calling it again keeps the descriptors already created and
+     * only retries the one that could not be created
+     *
+     * @return true on success, false if either could not be created
+     */
+    bool begin();
+
+    /**
+     * @brief Add a button whose deadlines arm the timerfd
+     *
+     * @param[in] button - button to include in rearm()
+     *
+     * @return true if added, false if LINUX_NOTIFIER_MAX_BUTTONS are in use
+     */
+    bool add(ButtonSequence* button);
+
+    /**
+     * @brief Queue a decoded event and make the eventfd readable
+     *
+     * @details Can be used directly as the event callback of a source
+     *
+     * @param[in] event - decoded event
+     *
+     * @return true if queued, false if the queue is full and it was dropped
+     */
+    bool push(const ButtonEvent& event);
+
+    /**
+     * @brief Take the oldest queued event
+     *
+     * @details The eventfd is cleared once the queue is empty
+     *
+     * @param[out] event - oldest event
+     *
+     * @return true if an event was returned, false if the queue is empty
+     */
+    bool pop(ButtonEvent& event);
+
+    /**
+     * @brief Arm the timerfd to the earliest deadline of the buttons, or 
+     * disarm it if every button is idle
+     *
+     * @details Call after feeding the buttons, both after edges and after
+     * the timer expired
+     */
+    void rearm();
+
+    /**
+     * @brief Acknowledge the timerfd after it became readable
+     *
+     * @return true if the timer had expired
+     */
+    bool timer_expired();
+
+    /**
+     * @brief Get the eventfd that is readable while events are queued
+     *
+     * @return eventfd, -1 before begin()
+     */
+    int event_fd();
+
+    /**
+     * @brief Get the timerfd that is readable when a deadline is reached
+     *
+     * @return timerfd, -1 before begin()
+     */
+    int timer_fd();
+
+    /**
+     * @brief Get the number of events dropped because the queue was full
+     *
+     * @return dropped events
+     */
+    uint32_t dropped();
+
+private:
+    ButtonEvent _queue[LINUX_NOTIFIER_QUEUE_SIZE];
+    size_t _head;
+    size_t _count;
+    uint32_t _dropped;
+    ButtonSequence* _buttons[LINUX_NOTIFIER_MAX_BUTTONS];
+    size_t _button_count;
+    int _event_fd;
+    int _timer_fd;
+};
+
+#endif // __linux__
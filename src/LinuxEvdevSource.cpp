@@ -0,0 +1,74 @@
+/** 
+ * @file LinuxEvdevSource.cpp
+ * @author Ed Ablan
+ * @version 1.0
+ * @date 10/17/2026
+ *
+ * @brief Linux input key events to button sequences
+ *
+ * @details Please read the header file for more details
+ *
+ * @copyright Copyright (c) 2020 Particle Industries, Inc.  All rights reserved.
+ */
+
+#include "LinuxEvdevSource.h"
+
+#if defined(__linux__)
+
+#include <sys/ioctl.h>
+#include <time.h>
+
+//older headers only have the struct timeval member
+#ifndef input_event_sec
+#define input_event_sec time.tv_sec
+#define input_event_usec time.tv_usec
+#endif
+
+//input_event value of a key that is auto repeating
+#define EVDEV_KEY_REPEAT 2
+
+LinuxEvdevSource::LinuxEvdevSource()
+    : LinuxInputSource(_keys, LINUX_EVDEV_MAX_KEYS, _rx, sizeof(_rx),
+                        sizeof(struct input_event))
+{}
+
+void LinuxEvdevSource::attach(int fd)
+{
+    attach_fd(fd);
+    int clock = CLOCK_MONOTONIC;
+    (void)ioctl(fd, EVIOCSCLOCKID, &clock);
+}
+
+bool LinuxEvdevSource::add_key(uint16_t code, ButtonSequence* button)
+{
+    if(code > KEY_MAX) {
+        return false;
+    }
+    //a key held at start up is down, not up until its first event
+    uint8_t keys[KEY_MAX / 8 + 1] = {};
+    bool level = false;
+    if(fd() >= 0 && ioctl(fd(), EVIOCGKEY(sizeof(keys)), keys) >= 0) {
+        level = (keys[code / 8] >> (code % 8)) & 1;
+    }
+    return add_input(code, button, level);
+}
+
+int LinuxEvdevSource::on_record(const uint8_t* record)
+{
+    struct input_event event;
+    memcpy(&event, record, sizeof(event));
+    if(event.type != EV_KEY || event.value == EVDEV_KEY_REPEAT) {
+        return 0;
+    }
+
+    int index = find_input(event.code);
+    if(index < 0) {
+        return 0;
+    }
+    //input_event_sec is 32 bits on some targets, widen before scaling
+    system_tick_t timestamp = (uint64_t)event.input_event_sec * 1000 + 
+                                event.input_event_usec / 1000;
+    return feed(index, event.value, timestamp);
+}
+
+#endif // __linux__
@@ -0,0 +1,88 @@
+/** 
+ * @file LinuxEvdevSource.h
+ * @author Ed Ablan
+ * @version 1.0
+ * @date 10/17/2026
+ *
+ * @brief Feeds Linux input (evdev) key events into button sequences
+ *
+ * @details Buttons exposed as /dev/input/event* devices (e.g. gpio-keys) 
+ * deliver struct input_event records. This source reads them in batches, 
+ * maps EV_KEY codes to ButtonSequence instances through a preallocated table
+ * and feeds the key level with the event timestamp instead of reading the 
+ * clock. Key down is fed as a high level, so the buttons should be created 
+ * with ActiveLevel::HIGH. It is driven like the other Linux sources, see
+ * LinuxInputSource. A pipe written with input_event records can stand
+ * in for the device
+ *
+ * Only compiled for Linux targets
+ *
+ * @copyright Copyright (c) 2020 Particle Industries, Inc.  All rights reserved.
+ */
+#pragma once
+
+#if defined(__linux__)
+
+#include <linux/input.h>
+
+#include "LinuxInputSource.h"
+
+#ifndef LINUX_EVDEV_MAX_KEYS
+#define LINUX_EVDEV_MAX_KEYS 16
+#endif
+
+//Number of input events read from the fd per read()
+#define LINUX_EVDEV_READ_BATCH 32
+
+class LinuxEvdevSource : public LinuxInputSource {
+public:
+
+    /**
+     * @brief Constructor for class
+     */
+    LinuxEvdevSource();
+
+    /**
+     * @brief Attach the fd of an input device (or a stand in)
+     *
+     * @details The fd is set to non blocking and the device is asked for 
+     * CLOCK_MONOTONIC timestamps (EVIOCSCLOCKID), the clock of 
+     * LinuxInputSource::now(). The request is ignored by a stand in
+     *
+     * @param[in] fd - file descriptor that input events are read from
+     */
+    void attach(int fd);
+
+    /**
+     * @brief Map a key code to a button
+     *
+     * @details Call after attach(). The button starts from the key state of
+     * the device (EVIOCGKEY), so a key held at start up is seen as down; a
+     * stand in without the ioctl starts with the key up
+     *
+     * @param[in] code - EV_KEY code (KEY_* or BTN_*)
+     * @param[in] button - button the key level is fed to
+     *
+     * @return true if added, false if LINUX_EVDEV_MAX_KEYS are in use or the
+     * code is above KEY_MAX
+     */
+    bool add_key(uint16_t code, ButtonSequence* button);
+
+protected:
+
+    /**
+     * @brief Feed a key down or up event to the button of its key, other 
+     * events and auto repeat are skipped
+     *
+     * @param[in] record - one struct input_event
+     *
+     * @return number of sequences decoded
+     */
+    int on_record(const uint8_t* record) override;
+
+private:
+    Input _keys[LINUX_EVDEV_MAX_KEYS];
+    uint8_t _rx[LINUX_EVDEV_READ_BATCH * sizeof(struct input_event)];
+};
+
+#endif // __linux__
@@ -0,0 +1,48 @@
+/** 
+ * @file LinuxGpioSource.cpp
+ * @author Ed Ablan
+ * @version 1.0
+ * @date 10/17/2026
+ *
+ * @brief Kernel GPIO line events to button sequences
+ *
+ * @details Please read the header file for more details
+ *
+ * @copyright Copyright (c) 2020 Particle Industries, Inc.  All rights reserved.
+ */
+
+#include "LinuxGpioSource.h"
+
+#if defined(__linux__)
+
+LinuxGpioSource::LinuxGpioSource()
+    : LinuxInputSource(_lines, LINUX_GPIO_MAX_LINES, _rx, sizeof(_rx),
+                        sizeof(GpioLineEvent))
+{}
+
+void LinuxGpioSource::attach(int fd)
+{
+    attach_fd(fd);
+}
+
+bool LinuxGpioSource::add_line(uint32_t offset, ButtonSequence* button, 
+                                bool initial_level)
+{
+    return add_input(offset, button, initial_level);
+}
+
+int LinuxGpioSource::on_record(const uint8_t* record)
+{
+    GpioLineEvent event;
+    memcpy(&event, record, sizeof(event));
+
+    int index = find_input(event.offset);
+    if(index < 0) {
+        return 0;
+    }
+    system_tick_t timestamp = event.timestamp_ns / 1000000;
+    bool level = (event.id == GPIO_LINE_EVENT_RISING_EDGE);
+    return feed(index, level, timestamp);
+}
+
+#endif // __linux__
@@ -0,0 +1,97 @@
+/** 
+ * @file LinuxGpioSource.h
+ * @author Ed Ablan
+ * @version 1.0
+ * @date 10/17/2026
+ *
+ * @brief Feeds kernel GPIO line events into button sequences on embedded 
+ * Linux
+ *
+ * @details On Linux the GPIO character device delivers timestamped edges on
+ * the file descriptor of a line request, so there is no need to poll with 
+ * digitalRead(). This source reads the line events (layout compatible with
+ * struct gpio_v2_line_event), and feeds every edge into the ButtonSequence 
+ * attached to the line offset using the kernel timestamp. Debounce and 
+ * sequence timeouts that have no edge of their own are run by 
+ * check_timeouts(), see LinuxInputSource for the calls shared with the other
+ * Linux sources. Any fd that produces the same records, such as a pipe or
+ * socketpair, can stand in for the line request
+ *
+ * Only compiled for Linux targets
+ *
+ * @copyright Copyright (c) 2020 Particle Industries, Inc.  All rights reserved.
+ */
+#pragma once
+
+#if defined(__linux__)
+
+#include "LinuxInputSource.h"
+
+#ifndef LINUX_GPIO_MAX_LINES
+#define LINUX_GPIO_MAX_LINES 32
+#endif
+
+//Number of line events read from the fd per read()
+#define LINUX_GPIO_READ_BATCH 16
+
+//gpio_v2_line_event id values
+#define GPIO_LINE_EVENT_RISING_EDGE  1
+#define GPIO_LINE_EVENT_FALLING_EDGE 2
+
+//Same layout as struct gpio_v2_line_event in linux/gpio.h
+struct GpioLineEvent {
+    uint64_t timestamp_ns;
+    uint32_t id;
+    uint32_t offset;
+    uint32_t seqno;
+    uint32_t line_seqno;
+    uint32_t padding[6];
+};
+static_assert(sizeof(GpioLineEvent) == 48, "must match gpio_v2_line_event");
+
+class LinuxGpioSource : public LinuxInputSource {
+public:
+
+    /**
+     * @brief Constructor for class
+     */
+    LinuxGpioSource();
+
+    /**
+     * @brief Attach the fd of a GPIO line request (or a stand in) 
+     *
+     * @details The fd is set to non blocking. The line request should be made
+     * with both edge detection flags and the default monotonic event clock
+     *
+     * @param[in] fd - file descriptor that line events are read from
+     */
+    void attach(int fd);
+
+    /**
+     * @brief Attach a button to a line offset of the request
+     *
+     * @param[in] offset - line offset reported in the line events
+     * @param[in] button - button that the edges of the line are fed to
+     * @param[in] initial_level - line level when the request was made
+     *
+     * @return true if added, false if LINUX_GPIO_MAX_LINES are in use
+     */
+    bool add_line(uint32_t offset, ButtonSequence* button, bool initial_level);
+
+protected:
+
+    /**
+     * @brief Feed the edge of a line event to the button of its line
+     *
+     * @param[in] record - one GpioLineEvent
+     *
+     * @return number of sequences decoded
+     */
+    int on_record(const uint8_t* record) override;
+
+private:
+    Input _lines[LINUX_GPIO_MAX_LINES];
+    uint8_t _rx[LINUX_GPIO_READ_BATCH * sizeof(GpioLineEvent)];
+};
+
+#endif // __linux__
@@ -0,0 +1,173 @@
+/**
+ * @file LinuxInputSource.cpp
+ * @author Ed Ablan
+ * @version 1.0
+ * @date 10/17/2026
+ *
+ * @brief Common part of the Linux button sources
+ *
+ * @details Please read the header file for more details
+ *
+ * @copyright Copyright (c) 2020 Particle Industries, Inc.  All rights reserved.
+ */
+
+#include "LinuxInputSource.h"
+
+#if defined(__linux__)
+
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/epoll.h>
+#include <time.h>
+#include <unistd.h>
+
+LinuxInputSource::LinuxInputSource(Input* inputs, size_t max_inputs,
+                                    uint8_t* rx, size_t rx_size,
+                                    size_t record_size)
+    : _inputs(inputs)
+    , _max_inputs(max_inputs)
+    , _input_count(0)
+    , _fd(-1)
+    , _rx(rx)
+    , _rx_size(rx_size)
+    , _rx_len(0)
+    , _record_size(record_size)
+{}
+
+void LinuxInputSource::attach_fd(int fd)
+{
+    _fd = fd;
+    _rx_len = 0;
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+}
+
+bool LinuxInputSource::add_input(uint32_t id, ButtonSequence* button,
+                                    bool initial_level)
+{
+    if(_input_count >= _max_inputs) {
+        return false;
+    }
+    //start the button on the clock of the records
+    system_tick_t current = now();
+    button->check_button(initial_level, current);
+    _inputs[_input_count++] = {id, button, initial_level, current};
+    return true;
+}
+
+int LinuxInputSource::find_input(uint32_t id)
+{
+    for(size_t i = 0; i < _input_count; i++) {
+        if(_inputs[i].id == id) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+void LinuxInputSource::set_event_callback(
+                        std::function<void(const ButtonEvent&)> event_cb)
+{
+    _event_cb = event_cb;
+}
+
+bool LinuxInputSource::add_to_epoll(int epoll_fd)
+{
+    struct epoll_event ev = {};
+    ev.events = EPOLLIN;
+    ev.data.ptr = this;
+    return epoll_ctl(epoll_fd, EPOLL_CTL_ADD, _fd, &ev) == 0;
+}
+
+int LinuxInputSource::feed(size_t index, bool level, system_tick_t now)
+{
+    auto& entry = _inputs[index];
+    //edges read late can be older than the last timeout check, never feed a
+    //button a time before the last one it has seen
+    if((int32_t)(now - entry.time) < 0) {
+        now = entry.time;
+    }
+
+    //run the previous level up to now, so timeouts that passed while no one
+    //was reading fire at their own time, then apply the new level
+    ButtonEvent events[BUTTON_RUN_MAX_EVENTS + 1];
+    size_t count = entry.button->feed_run(entry.level, now - entry.time,
+                                        events, BUTTON_RUN_MAX_EVENTS);
+    if(count > BUTTON_RUN_MAX_EVENTS) {count = BUTTON_RUN_MAX_EVENTS;}
+    int sequence = entry.button->check_button(level, now);
+    if(sequence) {
+        events[count++] = {now, 0, (int16_t)sequence};
+    }
+    entry.level = level;
+    entry.time = now;
+
+    for(size_t i = 0; _event_cb && i < count; i++) {
+        events[i].button_id = entry.id;
+        _event_cb(events[i]);
+    }
+    return count;
+}
+
+int LinuxInputSource::dispatch()
+{
+    int decoded = 0;
+
+    for(;;) {
+        ssize_t len = read(_fd, &_rx[_rx_len], _rx_size - _rx_len);
+        if(len < 0) {
+            if(errno == EINTR) {continue;}
+            return (errno == EAGAIN || errno == EWOULDBLOCK) ? decoded : -1;
+        }
+        if(len == 0) {
+            return -1;
+        }
+        _rx_len += len;
+
+        //a pipe may split a record, keep the remainder for the next read
+        size_t count = _rx_len / _record_size;
+        for(size_t i = 0; i < count; i++) {
+            decoded += on_record(&_rx[i * _record_size]);
+        }
+        size_t used = count * _record_size;
+        memmove(_rx, &_rx[used], _rx_len - used);
+        _rx_len -= used;
+    }
+}
+
+int LinuxInputSource::check_timeouts(system_tick_t now)
+{
+    int decoded = 0;
+    for(size_t i = 0; i < _input_count; i++) {
+        decoded += feed(i, _inputs[i].level, now);
+    }
+    return decoded;
+}
+
+int LinuxInputSource::timeout_ms()
+{
+    system_tick_t current = now();
+    int timeout = -1;
+    for(size_t i = 0; i < _input_count; i++) {
+        system_tick_t deadline;
+        if(_inputs[i].button->next_deadline(deadline)) {
+            int32_t remaining = (int32_t)(deadline - current);
+            if(remaining < 0) {remaining = 0;}
+            if(timeout < 0 || remaining < timeout) {timeout = remaining;}
+        }
+    }
+    return timeout;
+}
+
+int LinuxInputSource::fd()
+{
+    return _fd;
+}
+
+system_tick_t LinuxInputSource::now()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    //tv_sec is 32 bits on some targets, the product must not overflow
+    return (system_tick_t)((uint64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000);
+}
+
+#endif // __linux__
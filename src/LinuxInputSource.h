@@ -0,0 +1,176 @@
+/**
+ * @file LinuxInputSource.h
+ * @author Ed Ablan
+ * @version 1.0
+ * @date 10/17/2026
+ *
+ * @brief Common part of the Linux sources that feed timestamped level
+ * changes read from an fd into button sequences
+ *
+ * @details Holds the table of inputs (a line offset or key code and its
+ * ButtonSequence), reads fixed size records from a non blocking fd in
+ * batches, keeping a record split by a pipe for the next read, and runs the
+ * timeouts of the buttons. A source derives from it, owns the input table
+ * and the read buffer and decodes its records in on_record(). See
+ * LinuxGpioSource and LinuxEvdevSource
+ *
+ * Only compiled for Linux targets
+ *
+ * @copyright Copyright (c) 2020 Particle Industries, Inc.  All rights reserved.
+ */
+#pragma once
+
+#if defined(__linux__)
+
+#include "ButtonSequence.h"
+
+class LinuxInputSource {
+public:
+
+    virtual ~LinuxInputSource() {}
+
+    LinuxInputSource(const LinuxInputSource&) = delete;
+    LinuxInputSource& operator=(const LinuxInputSource&) = delete;
+
+    /**
+     * @brief Set the callback that receives decoded sequences
+     *
+     * @details The button_id of the event is the id of the input, the line
+     * offset or key code
+     *
+     * @param[in] event_cb - callback called for every decoded sequence
+     */
+    void set_event_callback(std::function<void(const ButtonEvent&)> event_cb);
+
+    /**
+     * @brief Add the fd to an epoll set
+     *
+     * @details Registered for EPOLLIN with data.ptr set to this source, call
+     * dispatch() when it is readable
+     *
+     * @param[in] epoll_fd - epoll instance
+     *
+     * @return true on success, false if epoll_ctl() failed
+     */
+    bool add_to_epoll(int epoll_fd);
+
+    /**
+     * @brief Read all pending records and feed them to the buttons
+     *
+     * @return number of sequences decoded, -1 on a read error or end of file
+     */
+    int dispatch();
+
+    /**
+     * @brief Run the debounce and sequence timeouts of all inputs
+     *
+     * @param[in] now - milli sec monotonic time, see now()
+     *
+     * @return number of sequences decoded
+     */
+    int check_timeouts(system_tick_t now);
+
+    /**
+     * @brief Get the epoll_wait() timeout until check_timeouts() is needed
+     *
+     * @return milli secs until the earliest button deadline, -1 (wait
+     * forever) while all buttons are idle
+     */
+    int timeout_ms();
+
+    /**
+     * @brief Get the file descriptor
+     *
+     * @return fd passed to attach(), -1 if none
+     */
+    int fd();
+
+    /**
+     * @brief Get the monotonic clock in milliseconds, the clock of the
+     * record timestamps
+     *
+     * @return milli sec monotonic time
+     */
+    static system_tick_t now();
+
+protected:
+
+    struct Input {
+        uint32_t id;
+        ButtonSequence* button;
+        bool level;
+        system_tick_t time;
+    };
+
+    /**
+     * @brief Constructor for class, the tables are owned by the source
+     *
+     * @param[in] inputs - table of max_inputs inputs
+     * @param[in] max_inputs - size of the table
+     * @param[in] rx - read buffer, a multiple of record_size
+     * @param[in] rx_size - size of the read buffer
+     * @param[in] record_size - bytes per record
+     */
+    LinuxInputSource(Input* inputs, size_t max_inputs, uint8_t* rx,
+                        size_t rx_size, size_t record_size);
+
+    /**
+     * @brief Attach the fd and set it to non blocking
+     *
+     * @param[in] fd - file descriptor that records are read from
+     */
+    void attach_fd(int fd);
+
+    /**
+     * @brief Add an input and start its button on now()
+     *
+     * @param[in] id - line offset or key code
+     * @param[in] button - button that the levels of the input are fed to
+     * @param[in] initial_level - level of the input now
+     *
+     * @return true if added, false if the table is full
+     */
+    bool add_input(uint32_t id, ButtonSequence* button, bool initial_level);
+
+    /**
+     * @brief Find an input
+     *
+     * @param[in] id - line offset or key code
+     *
+     * @return index of the input, -1 if there is none
+     */
+    int find_input(uint32_t id);
+
+    /**
+     * @brief Feed a level to the button of an input and report any sequence
+     *
+     * @param[in] index - index of the input
+     * @param[in] level - input level
+     * @param[in] now - milli sec time of the level
+     *
+     * @return number of sequences decoded
+     */
+    int feed(size_t index, bool level, system_tick_t now);
+
+    /**
+     * @brief Decode one record read by dispatch() and feed it
+     *
+     * @param[in] record - record_size bytes, not aligned
+     *
+     * @return number of sequences decoded
+     */
+    virtual int on_record(const uint8_t* record) = 0;
+
+private:
+    Input* _inputs;
+    size_t _max_inputs;
+    size_t _input_count;
+    int _fd;
+    std::function<void(const ButtonEvent&)> _event_cb;
+    uint8_t* _rx;
+    size_t _rx_size;
+    size_t _rx_len;
+    size_t _record_size;
+};
+
+#endif // __linux__
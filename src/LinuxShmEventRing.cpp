@@ -0,0 +1,226 @@
+/** 
+ * @file LinuxShmEventRing.cpp
+ * @author Ed Ablan
+ * @version 1.0
+ * @date 10/17/2026
+ *
+ * @brief Single writer, multi reader event ring in POSIX shared memory
+ *
+ * @details Please read the header file for more details
+ *
+ * @copyright Copyright (c) 2020 Particle Industries, Inc.  All rights reserved.
+ */
+
+#include "LinuxShmEventRing.h"
+
+#if defined(__linux__)
+
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+//slots start on the cache line after the header
+#define SHM_RING_SLOTS_OFFSET (sizeof(ShmRingHeader))
+
+LinuxShmEventPublisher::LinuxShmEventPublisher()
+    : _header(NULL)
+    , _slots(NULL)
+    , _map_len(0)
+    , _mask(0)
+{}
+
+LinuxShmEventPublisher::~LinuxShmEventPublisher()
+{
+    if(_header) {munmap(_header, _map_len);}
+}
+
+bool LinuxShmEventPublisher::begin(const char* name, uint32_t capacity)
+{
+    if(!capacity || (capacity & (capacity - 1))) {
+        return false;
+    }
+
+    int fd = shm_open(name, O_CREAT | O_RDWR, 0644);
+    if(fd < 0) {
+        return false;
+    }
+    //readers map the size they found, cutting it would fault them
+    size_t len = SHM_RING_SLOTS_OFFSET + capacity * sizeof(ShmRingSlot);
+    struct stat st;
+    void* map = MAP_FAILED;
+    if(fstat(fd, &st) == 0 && (size_t)st.st_size <= len &&
+            ftruncate(fd, len) == 0) {
+        map = mmap(NULL, len, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    }
+    close(fd);
+    if(map == MAP_FAILED) {
+        return false;
+    }
+    //called again, the ring of the last call is no longer written
+    if(_header) {
+        munmap(_header, _map_len);
+    }
+
+    //a valid ring carries on, so the cursors of attached readers stay valid
+    ShmRingHeader* header = (ShmRingHeader*)map;
+    bool valid = (size_t)st.st_size >= SHM_RING_SLOTS_OFFSET &&
+                    header->magic == SHM_RING_MAGIC &&
+                    header->version == SHM_RING_VERSION;
+    uint64_t write_seq = (valid) ?
+                    header->write_seq.load(std::memory_order_relaxed) : 0;
+    uint32_t generation = (valid) ? header->generation + 1 : 0;
+
+    //readers check the magic last, so clear it while the ring is rebuilt
+    _header = header;
+    _header->magic = 0;
+    std::atomic_thread_fence(std::memory_order_release);
+    _slots = (ShmRingSlot*)((uint8_t*)map + SHM_RING_SLOTS_OFFSET);
+    for(uint32_t i = 0; i < capacity; i++) {
+        _slots[i].seq.store(0, std::memory_order_relaxed);
+    }
+    _header->version = SHM_RING_VERSION;
+    _header->capacity = capacity;
+    _header->generation = generation;
+    _header->write_seq.store(write_seq, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    _header->magic = SHM_RING_MAGIC;
+
+    _map_len = len;
+    _mask = capacity - 1;
+    return true;
+}
+
+void LinuxShmEventPublisher::publish(const ButtonEvent& event)
+{
+    uint64_t pos = _header->write_seq.load(std::memory_order_relaxed);
+    ShmRingSlot& slot = _slots[pos & _mask];
+
+    slot.seq.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    memcpy(&slot.event, &event, sizeof(event));
+    slot.seq.store(pos + 1, std::memory_order_release);
+    _header->write_seq.store(pos + 1, std::memory_order_release);
+}
+
+void LinuxShmEventPublisher::unlink(const char* name)
+{
+    shm_unlink(name);
+}
+
+LinuxShmEventReader::LinuxShmEventReader()
+    : _header(NULL)
+    , _slots(NULL)
+    , _map_len(0)
+    , _mask(0)
+    , _cursor(0)
+    , _lost(0)
+    , _generation(0)
+{
+    _name[0] = 0;
+}
+
+LinuxShmEventReader::~LinuxShmEventReader()
+{
+    if(_header) {munmap((void*)_header, _map_len);}
+}
+
+bool LinuxShmEventReader::open(const char* name)
+{
+    if(strlen(name) > NAME_MAX || !map(name)) {
+        return false;
+    }
+    strcpy(_name, name);
+    _cursor = _header->write_seq.load(std::memory_order_acquire);
+    return true;
+}
+
+bool LinuxShmEventReader::map(const char* name)
+{
+    int fd = shm_open(name, O_RDONLY, 0);
+    if(fd < 0) {
+        return false;
+    }
+    struct stat st;
+    void* map = MAP_FAILED;
+    if(fstat(fd, &st) == 0 && (size_t)st.st_size >= SHM_RING_SLOTS_OFFSET) {
+        map = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    }
+    close(fd);
+    if(map == MAP_FAILED) {
+        return false;
+    }
+
+    //the magic is written last, the rest of the header is valid once it is
+    const ShmRingHeader* header = (const ShmRingHeader*)map;
+    uint32_t magic = header->magic;
+    std::atomic_thread_fence(std::memory_order_acquire);
+    uint32_t capacity = header->capacity;
+    if(magic != SHM_RING_MAGIC || header->version != SHM_RING_VERSION ||
+            !capacity || (capacity & (capacity - 1)) ||
+            (size_t)st.st_size < SHM_RING_SLOTS_OFFSET +
+                                    capacity * sizeof(ShmRingSlot)) {
+        munmap(map, st.st_size);
+        return false;
+    }
+
+    if(_header) {
+        munmap((void*)_header, _map_len);
+    }
+    _header = header;
+    _slots = (const ShmRingSlot*)((const uint8_t*)map + SHM_RING_SLOTS_OFFSET);
+    _map_len = st.st_size;
+    _mask = capacity - 1;
+    _generation = header->generation;
+    return true;
+}
+
+bool LinuxShmEventReader::next(ButtonEvent& event)
+{
+    for(;;) {
+        //rebuilt by begin(), the positions carry on so the cursor does too
+        uint32_t magic = _header->magic;
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if(magic != SHM_RING_MAGIC) {
+            return false;
+        }
+        if(_header->generation != _generation && !map(_name)) {
+            return false;
+        }
+        uint64_t written = _header->write_seq.load(std::memory_order_acquire);
+        //rebuilt by a publisher that did not find a valid ring
+        if(written < _cursor) {
+            _cursor = written;
+        }
+        if(_cursor == written) {
+            return false;
+        }
+        //lapped by the writer, skip to the oldest slot still in the ring
+        if(written - _cursor > _mask + 1) {
+            _lost += written - _cursor - (_mask + 1);
+            _cursor = written - (_mask + 1);
+        }
+
+        const ShmRingSlot& slot = _slots[_cursor & _mask];
+        uint64_t seq = slot.seq.load(std::memory_order_acquire);
+        if(seq == _cursor + 1) {
+            memcpy(&event, (const void*)&slot.event, sizeof(event));
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if(slot.seq.load(std::memory_order_relaxed) == seq) {
+                _cursor++;
+                return true;
+            }
+        }
+        //the slot was overwritten while it was read, count it and move on
+        _lost++;
+        _cursor++;
+    }
+}
+
+uint64_t LinuxShmEventReader::lost()
+{
+    return _lost;
+}
+
+#endif // __linux__
@@ -0,0 +1,172 @@
+/** 
+ * @file LinuxShmEventRing.h
+ * @author Ed Ablan
+ * @version 1.0
+ * @date 10/17/2026
+ *
+ * @brief Shares decoded button events with other local processes through a
+ * ring in POSIX shared memory
+ *
+ * @details One process decodes the buttons and publishes every ButtonEvent 
+ * into a lock free single writer ring. Any number of local processes map the
+ * ring read only and follow it with their own cursor, so consuming events 
+ * needs no copies through sockets and no syscalls. The writer never waits 
+ * for readers; a reader that falls more than the ring capacity behind skips
+ * ahead and counts the events it lost. Each slot carries a sequence number
+ * that is checked before and after the event is copied out, so a slot being
+ * overwritten is never returned
+ *
+ * Only compiled for Linux targets, link with -lrt on older C libraries
+ *
+ * @copyright Copyright (c) 2020 Particle Industries, Inc.  All rights reserved.
+ */
+#pragma once
+
+#if defined(__linux__)
+
+#include <atomic>
+#include <limits.h>
+#include <stddef.h>
+
+#include "types.h"
+
+#define SHM_RING_MAGIC 0x42534551
+#define SHM_RING_VERSION 1
+
+//Default number of slots, must be a power of 2
+#define DEFAULT_SHM_RING_CAPACITY 256
+
+//Layout of the shared memory, the writer owns every field
+struct ShmRingHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t capacity;
+    uint32_t generation;    //bumped by every begin(), readers remap on change
+    //on its own cache line so readers polling it do not share with the slots
+    alignas(64) std::atomic<uint64_t> write_seq;
+};
+
+struct ShmRingSlot {
+    std::atomic<uint64_t> seq;      //position + 1 once written, 0 while writing
+    ButtonEvent event;
+};
+
+static_assert(ATOMIC_LLONG_LOCK_FREE == 2, 
+                "shared memory ring needs lock free 64 bit atomics");
+
+class LinuxShmEventPublisher {
+public:
+
+    /**
+     * @brief Constructor for class
+     */
+    LinuxShmEventPublisher();
+
+    /**
+     * @brief Destructor, unmaps the ring. The shared memory object stays until
+     * unlink() so readers can keep reading
+     */
+    ~LinuxShmEventPublisher();
+
+    /**
+     * @brief Create (or recreate) the ring
+     *
+     * @details A ring that already exists under the name is rebuilt in place
+     * and may grow, but is never shrunk: readers keep the size they mapped
+     * and would fault on the cut off pages. The positions of a valid ring
+     * carry on from where it stopped and its generation is bumped, so
+     * attached readers remap it and count the events it held as lost.
+     * Calling it again replaces the ring of the last call, which is unmapped
+     *
+     * @param[in] name - POSIX shared memory name, e.g. "/button_events"
+     * @param[in] capacity - number of slots, must be a power of 2
+     *
+     * @return true on success, false if the ring could not be created or the
+     * existing ring is larger, the ring of the last call is kept then
+     */
+    bool begin(const char* name, uint32_t capacity = DEFAULT_SHM_RING_CAPACITY);
+
+    /**
+     * @brief Write an event to the ring, overwriting the oldest slot
+     *
+     * @details Can be used directly as the event callback of a source
+     *
+     * @param[in] event - decoded event
+     */
+    void publish(const ButtonEvent& event);
+
+    /**
+     * @brief Remove the shared memory name
+     *
+     * @param[in] name - name passed to begin()
+     */
+    static void unlink(const char* name);
+
+private:
+    ShmRingHeader* _header;
+    ShmRingSlot* _slots;
+    size_t _map_len;
+    uint64_t _mask;
+};
+
+class LinuxShmEventReader {
+public:
+
+    /**
+     * @brief Constructor for class
+     */
+    LinuxShmEventReader();
+
+    /**
+     * @brief Destructor, unmaps the ring
+     */
+    ~LinuxShmEventReader();
+
+    /**
+     * @brief Map an existing ring read only
+     *
+     * @details The cursor starts at the newest position, only events 
+     * published after open() are returned
+     *
+     * @param[in] name - name the publisher passed to begin()
+     *
+     * @return true on success, false if the ring does not exist or is not a 
+     * valid ring
+     */
+    bool open(const char* name);
+
+    /**
+     * @brief Get the next event after the cursor
+     *
+     * @details Remaps the ring when the publisher rebuilt it, keeping the
+     * cursor. Returns false while the ring is being rebuilt or if it could
+     * not be remapped
+     *
+     * @param[out] event - next event
+     *
+     * @return true if an event was returned, false if there is no new event
+     */
+    bool next(ButtonEvent& event);
+
+    /**
+     * @brief Get the number of events overwritten before this reader got to
+     * them
+     *
+     * @return events lost
+     */
+    uint64_t lost();
+
+private:
+    bool map(const char* name);
+
+    const ShmRingHeader* _header;
+    const ShmRingSlot* _slots;
+    size_t _map_len;
+    uint64_t _mask;
+    uint64_t _cursor;
+    uint64_t _lost;
+    uint32_t _generation;
+    char _name[NAME_MAX + 1];
+};
+
+#endif // __linux__
@@ -0,0 +1,124 @@
+/**
+ * @file Mcp23017Input.cpp
+ * @author Ed Ablan
+ * @version 1.0
+ * @date 10/17/2026
+ *
+ * @brief Reads buttons on an MCP23017 expander, gated by its interrupt
+ *
+ * @details Please read the header file for more details
+ *
+ * @copyright Copyright (c) 2020 Particle Industries, Inc.  All rights reserved.
+ */
+
+#include "Mcp23017Input.h"
+
+//Register addresses with IOCON.BANK = 0, port A then port B
+#define MCP23017_IODIRA 0x00
+#define MCP23017_INTFA 0x0E
+//IODIR through GPPU, written by begin() in one burst
+#define MCP23017_CONFIG_LENGTH 14
+//INTF, INTCAP and GPIO of both ports, read by read() in one burst
+#define MCP23017_STATUS_LENGTH 6
+
+//IOCON: INTA and INTB mirrored, open drain, sequential addressing
+#define MCP23017_IOCON_MIRROR 0x40
+#define MCP23017_IOCON_ODR 0x04
+
+WireTransport::WireTransport(TwoWire& wire) : _wire(wire)
+{
+}
+
+bool WireTransport::write(uint8_t address, uint8_t reg, const uint8_t* data,
+                            size_t length)
+{
+    _wire.beginTransmission(address);
+    _wire.write(reg);
+    _wire.write(data, length);
+    return _wire.endTransmission() == 0;
+}
+
+bool WireTransport::read(uint8_t address, uint8_t reg, uint8_t* data,
+                            size_t length)
+{
+    _wire.beginTransmission(address);
+    _wire.write(reg);
+    if(_wire.endTransmission(false) != 0) {
+        return false;
+    }
+    if(_wire.requestFrom(address, length) != length) {
+        return false;
+    }
+    for(size_t i = 0; i < length; i++) {
+        data[i] = _wire.read();
+    }
+    return true;
+}
+
+Mcp23017Input::Mcp23017Input(I2cTransport& i2c, uint8_t address,
+                                pin_t int_pin)
+    : _i2c(i2c)
+    , _address(address)
+    , _int_pin(int_pin)
+    , _word(0xFFFF)
+    , _flags(0)
+    , _refresh(true)
+    , _transactions(0)
+    , _errors(0)
+{
+}
+
+bool Mcp23017Input::begin(uint16_t pullups)
+{
+    uint8_t iocon = MCP23017_IOCON_MIRROR | MCP23017_IOCON_ODR;
+    const uint8_t config[MCP23017_CONFIG_LENGTH] = {
+        0xFF, 0xFF,                 //IODIR: all inputs
+        0x00, 0x00,                 //IPOL: not inverted
+        0xFF, 0xFF,                 //GPINTEN: interrupt on every input
+        0x00, 0x00,                 //DEFVAL: unused
+        0x00, 0x00,                 //INTCON: compare with the previous value
+        iocon, iocon,
+        (uint8_t)pullups, (uint8_t)(pullups >> 8),   //GPPU
+    };
+
+    _transactions = 0;
+    _errors = 0;
+    if(_int_pin != MCP23017_NO_INT_PIN) {
+        pinMode(_int_pin, INPUT_PULLUP);
+    }
+    _transactions++;
+    if(!_i2c.write(_address, MCP23017_IODIRA, config, sizeof(config))) {
+        _errors++;
+        return false;
+    }
+    _refresh = true;
+    read();
+    return !_refresh;
+}
+
+bool Mcp23017Input::pending()
+{
+    return _refresh || _int_pin == MCP23017_NO_INT_PIN ||
+            !digitalRead(_int_pin);
+}
+
+uint32_t Mcp23017Input::read()
+{
+    if(!pending()) {
+        return _word;
+    }
+
+    uint8_t status[MCP23017_STATUS_LENGTH];
+    _transactions++;
+    if(!_i2c.read(_address, MCP23017_INTFA, status, sizeof(status))) {
+        _errors++;
+        _refresh = true;
+        return _word;
+    }
+    //INTF A, B, INTCAP A, B, GPIO A, B; the change is in GPIO and reading it
+    //releases INT, so INTCAP is not needed
+    _flags = status[0] | (status[1] << 8);
+    _word = status[4] | (status[5] << 8);
+    _refresh = false;
+    return _word;
+}
@@ -0,0 +1,174 @@
+/**
+ * @file Mcp23017Input.h
+ * @author Ed Ablan
+ * @version 1.0
+ * @date 10/17/2026
+ *
+ * @brief Reads 16 buttons on an MCP23017 I2C expander with one transaction,
+ * and only when the expander reports a change
+ *
+ * @details begin() makes both ports inputs with interrupt on change, INTA
+ * and INTB mirrored and open drain, so the INT outputs of several expanders
+ * can share one pin with a pull up. read() returns the port word for a
+ * ButtonBank; with an INT pin it only talks to the expander while the pin is
+ * low, otherwise the last word is returned without bus traffic. Each read is
+ * one burst of INTF, INTCAP and GPIO of both ports, which also clears the
+ * interrupt. Without an INT pin every read() is a transaction, so the polling
+ * rate is the bus load. Bit k of the word is GPAk for k below 8 and GPB(k-8)
+ * above.
+ *
+ * The bus is reached through I2cTransport, WireTransport for the Wire API, so
+ * a host fake can replace the expander
+ *
+ * @copyright Copyright (c) 2020 Particle Industries, Inc.  All rights reserved.
+ */
+#pragma once
+
+#include "Particle.h"
+
+//Address with A2, A1 and A0 low, add 0 to 7 for the others
+#define MCP23017_ADDRESS 0x20
+#define MCP23017_NO_INT_PIN ((pin_t)0xFFFF)
+#define MCP23017_BITS 16
+
+class I2cTransport {
+public:
+    virtual ~I2cTransport() {}
+
+    /**
+     * @brief Write consecutive registers in one transaction
+     *
+     * @param[in] address - 7 bit device address
+     * @param[in] reg - first register
+     * @param[in] data - register values
+     * @param[in] length - number of registers
+     *
+     * @return true if the device acknowledged every byte
+     */
+    virtual bool write(uint8_t address, uint8_t reg, const uint8_t* data,
+                        size_t length) = 0;
+
+    /**
+     * @brief Read consecutive registers in one transaction, a register write
+     * followed by a repeated start
+     *
+     * @param[in] address - 7 bit device address
+     * @param[in] reg - first register
+     * @param[out] data - register values
+     * @param[in] length - number of registers
+     *
+     * @return true if every byte was read
+     */
+    virtual bool read(uint8_t address, uint8_t reg, uint8_t* data,
+                        size_t length) = 0;
+};
+
+class WireTransport : public I2cTransport {
+public:
+
+    /**
+     * @brief Constructor for class
+     *
+     * @param[in] wire - I2C interface, e.g. Wire or Wire1, begin() must have
+     * been called
+     */
+    explicit WireTransport(TwoWire& wire);
+
+    bool write(uint8_t address, uint8_t reg, const uint8_t* data,
+                size_t length) override;
+    bool read(uint8_t address, uint8_t reg, uint8_t* data,
+                size_t length) override;
+
+private:
+    TwoWire& _wire;
+};
+
+class Mcp23017Input {
+public:
+
+    /**
+     * @brief Constructor for class
+     *
+     * @param[in] i2c - bus the expander is on
+     * @param[in] address - 7 bit address of the expander
+     * @param[in] int_pin - pin wired to INTA or INTB, MCP23017_NO_INT_PIN to
+     * read on every read()
+     */
+    Mcp23017Input(I2cTransport& i2c, uint8_t address = MCP23017_ADDRESS,
+                    pin_t int_pin = MCP23017_NO_INT_PIN);
+
+    /**
+     * @brief Configure the expander and read the first word
+     *
+     * @param[in] pullups - inputs that use the internal 100k pull up, all by
+     * default for buttons to ground
+     *
+     * @return true if the expander answered
+     */
+    bool begin(uint16_t pullups = 0xFFFF);
+
+    /**
+     * @brief Get the port word, reading the expander only if it reported a
+     * change
+     *
+     * @details A failed transaction keeps the last word and is retried on
+     * the next read()
+     *
+     * @return GPIO of both ports, GPA in the low byte
+     */
+    uint32_t read();
+
+    /**
+     * @brief Check if the next read() talks to the expander
+     *
+     * @return true if the INT pin is low, a read failed or there is no INT
+     * pin
+     */
+    bool pending();
+
+    /**
+     * @brief Get the inputs that changed to raise the last interrupt
+     *
+     * @return INTF of both ports at the last transaction
+     */
+    uint16_t interrupt_flags() const {
+        return _flags;
+    }
+
+    /**
+     * @brief Get the number of I2C transactions since begin()
+     *
+     * @return transactions, failed ones included
+     */
+    uint32_t transactions() const {
+        return _transactions;
+    }
+
+    /**
+     * @brief Get the number of failed transactions since begin()
+     *
+     * @return transactions the expander did not answer
+     */
+    uint32_t errors() const {
+        return _errors;
+    }
+
+    /**
+     * @brief Get the number of inputs
+     *
+     * @return MCP23017_BITS
+     */
+    static constexpr uint8_t bits() {
+        return MCP23017_BITS;
+    }
+
+private:
+    I2cTransport& _i2c;
+    uint8_t _address;
+    pin_t _int_pin;
+    uint16_t _word;
+    uint16_t _flags;
+    bool _refresh;
+    uint32_t _transactions;
+    uint32_t _errors;
+};
@@ -0,0 +1,55 @@
+/** 
+ * @file PollGovernor.cpp
+ * @author Ed Ablan
+ * @version 1.0
+ * @date 10/17/2026
+ *
+ * @brief Activity based sample interval for a group of buttons
+ *
+ * @details Please read the header file for more details
+ *
+ * @copyright Copyright (c) 2020 Particle Industries, Inc.  All rights reserved.
+ */
+
+#include "PollGovernor.h"
+
+PollGovernor::PollGovernor(system_tick_t active_interval, 
+                            system_tick_t idle_interval)
+    : _count(0)
+    , _active_interval(active_interval)
+    , _idle_interval(idle_interval)
+    , _last_poll(0)
+{}
+
+bool PollGovernor::add(ButtonSequence* button)
+{
+    if(_count >= POLL_GOVERNOR_MAX_BUTTONS) {
+        return false;
+    }
+    _buttons[_count++] = button;
+    return true;
+}
+
+bool PollGovernor::is_idle()
+{
+    for(size_t i = 0; i < _count; i++) {
+        if(_buttons[i]->is_active()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+system_tick_t PollGovernor::next_interval()
+{
+    return (is_idle()) ? _idle_interval : _active_interval;
+}
+
+bool PollGovernor::poll_due()
+{
+    if(millis() - _last_poll < next_interval()) {
+        return false;
+    }
+    _last_poll = millis();
+    return true;
+}
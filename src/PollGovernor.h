@@ -0,0 +1,82 @@
+/** 
+ * @file PollGovernor.h
+ * @author Ed Ablan
+ * @version 1.0
+ * @date 10/17/2026
+ *
+ * @brief Recommends how often a group of buttons needs to be sampled
+ *
+ * @details Buttons that are idle only need to be sampled often enough to 
+ * catch the start of a press. Once any button is active (unstable debounce,
+ * pressed, or a sequence waiting on a timeout) the group is sampled at the 
+ * active interval until every sequence has finished. The main loop and sleep
+ * logic use next_interval() or poll_due() to cut idle wakeups
+ *
+ * @copyright Copyright (c) 2020 Particle Industries, Inc.  All rights reserved.
+ */
+#pragma once
+
+#include "ButtonSequence.h"
+
+#ifndef POLL_GOVERNOR_MAX_BUTTONS
+#define POLL_GOVERNOR_MAX_BUTTONS 16
+#endif
+
+#define DEFAULT_ACTIVE_POLL_MS 1
+#define DEFAULT_IDLE_POLL_MS 100
+
+class PollGovernor {
+public:
+
+    /**
+     * @brief Constructor for class
+     *
+     * @param[in] active_interval - milli sec sample interval while any button
+     * is active
+     * @param[in] idle_interval - milli sec sample interval while all buttons
+     * are idle
+     */
+    PollGovernor(system_tick_t active_interval = DEFAULT_ACTIVE_POLL_MS,
+                system_tick_t idle_interval = DEFAULT_IDLE_POLL_MS);
+
+    /**
+     * @brief Add a button to the group governed
+     *
+     * @param[in] button - button to include in the activity check
+     *
+     * @return true if added, false if POLL_GOVERNOR_MAX_BUTTONS are in use
+     */
+    bool add(ButtonSequence* button);
+
+    /**
+     * @brief Check if every button in the group is idle
+     *
+     * @return true if no button is active
+     */
+    bool is_idle();
+
+    /**
+     * @brief Get the recommended interval until the next sample
+     *
+     * @return the active interval if any button is active, otherwise the
+     * idle interval
+     */
+    system_tick_t next_interval();
+
+    /**
+     * @brief Check if the group should be sampled now
+     *
+     * @details Intended to be called every loop, returns true once the 
+     * recommended interval has passed since the last time it returned true
+     *
+     * @return true if the buttons should be checked
+     */
+    bool poll_due();
+
+private:
+    ButtonSequence* _buttons[POLL_GOVERNOR_MAX_BUTTONS];
+    size_t _count;
+    system_tick_t _active_interval;
+    system_tick_t _idle_interval;
+    system_tick_t _last_poll;
+};
@@ -0,0 +1,191 @@
+/**
+ * @file ScanScheduler.cpp
+ * @author Ed Ablan
+ * @version 1.0
+ * @date 10/17/2026
+ *
+ * @brief Schedules button group scans within a bus transaction budget
+ *
+ * @details Please read the header file for more details
+ *
+ * @copyright Copyright (c) 2020 Particle Industries, Inc.  All rights reserved.
+ */
+
+#include "ScanScheduler.h"
+#include "ButtonPrint.h"
+
+//Milli transactions per transaction in the bucket
+#define SCAN_TOKEN 1000
+
+ScanScheduler::ScanScheduler(uint32_t budget)
+    : _count(0)
+    , _budget(budget)
+    , _tokens(0)
+    , _refill_time(millis())
+    , _stats_start(millis())
+{
+}
+
+bool ScanScheduler::add(ScanGroup* group, system_tick_t active_interval,
+                        system_tick_t idle_interval)
+{
+    if(_count >= SCAN_SCHEDULER_MAX_GROUPS) {
+        return false;
+    }
+    system_tick_t debounce = group->debounce_interval();
+    Entry& entry = _entries[_count++];
+    entry.group = group;
+    entry.active_interval = (active_interval) ? active_interval :
+                                        debounce / SCAN_ACTIVE_SAMPLES;
+    entry.idle_interval = (idle_interval) ? idle_interval : 
+                                        debounce / SCAN_IDLE_SAMPLES;
+    if(!entry.active_interval) {entry.active_interval = 1;}
+    if(!entry.idle_interval) {entry.idle_interval = 1;}
+    //due at once, the first scan picks up the activity
+    entry.last_scan = millis() - entry.idle_interval;
+    entry.active = false;
+    entry.waiting = false;
+    entry.stats = ScanGroupStats{};
+    return true;
+}
+
+void ScanScheduler::set_budget(uint32_t budget)
+{
+    _budget = budget;
+}
+
+system_tick_t ScanScheduler::interval(const Entry& entry)
+{
+    return (entry.active) ? entry.active_interval : entry.idle_interval;
+}
+
+void ScanScheduler::refill(system_tick_t now)
+{
+    int64_t cap = (int64_t)_budget * SCAN_BURST_MS;
+    //a small budget still saves up for one transaction
+    if(cap < SCAN_TOKEN) {cap = SCAN_TOKEN;}
+    //budget / 1000 transactions per milli sec, in milli transactions
+    int64_t tokens = _tokens + (int64_t)(now - _refill_time) * _budget;
+    _tokens = (int32_t)((tokens > cap) ? cap : tokens);
+    _refill_time = now;
+}
+
+size_t ScanScheduler::run()
+{
+    return run(millis());
+}
+
+size_t ScanScheduler::run(system_tick_t now)
+{
+    size_t scanned = 0;
+    refill(now);
+
+    for(;;) {
+        //the due group furthest past its interval, relative to the interval
+        Entry* next = nullptr;
+        uint64_t next_urgency = 0;
+        for(size_t i = 0; i < _count; i++) {
+            Entry& entry = _entries[i];
+            system_tick_t elapsed = now - entry.last_scan;
+            if(elapsed < interval(entry)) {
+                continue;
+            }
+            if(_tokens < SCAN_TOKEN && entry.group->needs_bus()) {
+                //counted once per wait
+                if(!entry.waiting) {
+                    entry.waiting = true;
+                    entry.stats.deferred++;
+                }
+                continue;
+            }
+            uint64_t urgency = (uint64_t)elapsed * 1024 / interval(entry);
+            if(!next || urgency > next_urgency) {
+                next = &entry;
+                next_urgency = urgency;
+            }
+        }
+        if(!next) {
+            break;
+        }
+
+        system_tick_t late = now - next->last_scan - interval(*next);
+        uint32_t used = next->group->scan(now);
+        _tokens -= used * SCAN_TOKEN;
+        next->last_scan = now;
+        next->waiting = false;
+        next->active = next->group->is_active();
+        next->stats.scans++;
+        next->stats.transactions += used;
+        if(late > next->stats.max_late) {
+            next->stats.max_late = late;
+        }
+        scanned++;
+    }
+    return scanned;
+}
+
+bool ScanScheduler::next_deadline(system_tick_t& deadline)
+{
+    for(size_t i = 0; i < _count; i++) {
+        system_tick_t due = _entries[i].last_scan + interval(_entries[i]);
+        if(!i || (int32_t)(due - deadline) < 0) {
+            deadline = due;
+        }
+    }
+    return _count != 0;
+}
+
+ScanGroupStats ScanScheduler::stats(size_t index)
+{
+    return (index < _count) ? _entries[index].stats : ScanGroupStats{};
+}
+
+uint32_t ScanScheduler::achieved_rate(size_t index)
+{
+    system_tick_t elapsed = millis() - _stats_start;
+    if(index >= _count || !elapsed) {
+        return 0;
+    }
+    return (uint64_t)_entries[index].stats.scans * 1000 / elapsed;
+}
+
+uint32_t ScanScheduler::budget_used()
+{
+    system_tick_t elapsed = millis() - _stats_start;
+    uint64_t transactions = 0;
+    for(size_t i = 0; i < _count; i++) {
+        transactions += _entries[i].stats.transactions;
+    }
+    uint64_t allowed = (uint64_t)_budget * elapsed;
+    return (allowed) ? transactions * 1000 * 100 / allowed : 0;
+}
+
+void ScanScheduler::print(Print& out)
+{
+    system_tick_t elapsed = millis() - _stats_start;
+    uint64_t transactions = 0;
+
+    for(size_t i = 0; i < _count; i++) {
+        const Entry& entry = _entries[i];
+        transactions += entry.stats.transactions;
+        button_print_line(out, "SCAN %u %lu %lu %lu %lu %lu\r\n", (unsigned)i,
+                (unsigned long)interval(entry),
+                (unsigned long)achieved_rate(i),
+                (unsigned long)((elapsed) ? (uint64_t)entry.stats.transactions
+                                            * 1000 / elapsed : 0),
+                (unsigned long)entry.stats.deferred,
+                (unsigned long)entry.stats.max_late);
+    }
+    button_print_line(out, "BUS %lu %lu %lu\r\n",
+                (unsigned long)_budget,
+                (unsigned long)((elapsed) ? transactions * 1000 / elapsed : 0),
+                (unsigned long)budget_used());
+}
+
+void ScanScheduler::reset_stats()
+{
+    for(size_t i = 0; i < _count; i++) {
+        _entries[i].stats = ScanGroupStats{};
+    }
+    _stats_start = millis();
+}
@@ -0,0 +1,279 @@
+/**
+ * @file ScanScheduler.h
+ * @author Ed Ablan
+ * @version 1.0
+ * @date 10/17/2026
+ *
+ * @brief Schedules the scans of several expander or shift register button
+ * groups that share one bus, within a budget of bus transactions per second
+ *
+ * @details Each group scans at a rate derived from its debounce interval:
+ * SCAN_IDLE_SAMPLES times per debounce interval while idle and
+ * SCAN_ACTIVE_SAMPLES times while a bit is settling or a sequence is in
+ * progress. A press is seen once it holds for the debounce interval plus one
+ * idle and one active interval, 1.75 debounce intervals with the defaults;
+ * shorter taps can be missed. Both intervals can be set per group. The
+ * transactions are paid from a token bucket refilled at the budget rate,
+ * holding at most SCAN_BURST_MS of budget. When the bucket is empty due groups
+ * wait, except a group whose next scan needs no bus transaction (an expander
+ * with an idle INT line). Due groups are scanned furthest past their interval
+ * first, relative to the interval, so active groups go ahead of idle ones
+ * without starving them. Per group the achieved scan rate, the bus
+ * transactions, the scans deferred by the budget and the longest wait are
+ * reported, with the share of the budget used.
+ *
+ * A group is anything implementing ScanGroup; BankScanGroup ties an input
+ * (ShiftRegisterTransport, Mcp23017Input) to a ButtonBank
+ *
+ * @copyright Copyright (c) 2020 Particle Industries, Inc.  All rights reserved.
+ */
+#pragma once
+
+#include <functional>
+
+#include "ButtonBank.h"
+#include "Mcp23017Input.h"
+
+#ifndef SCAN_SCHEDULER_MAX_GROUPS
+#define SCAN_SCHEDULER_MAX_GROUPS 8
+#endif
+
+//Scans per debounce interval of an idle group
+#ifndef SCAN_IDLE_SAMPLES
+#define SCAN_IDLE_SAMPLES 2
+#endif
+
+//Scans per debounce interval of an active group
+#ifndef SCAN_ACTIVE_SAMPLES
+#define SCAN_ACTIVE_SAMPLES 4
+#endif
+
+//Most budget that can be saved up while groups are idle, in milli secs
+#ifndef SCAN_BURST_MS
+#define SCAN_BURST_MS 100
+#endif
+
+class ScanGroup {
+public:
+    virtual ~ScanGroup() {}
+
+    /**
+     * @brief Read the inputs of the group and decode them
+     *
+     * @param[in] now - milli sec time of the scan
+     *
+     * @return bus transactions the scan used
+     */
+    virtual uint32_t scan(system_tick_t now) = 0;
+
+    /**
+     * @brief Check if the group needs the active scan rate
+     *
+     * @return true if a bit is settling or a sequence is in progress
+     */
+    virtual bool is_active() = 0;
+
+    /**
+     * @brief Get the debounce interval the scan rates are derived from
+     *
+     * @return milli sec debounce interval
+     */
+    virtual system_tick_t debounce_interval() = 0;
+
+    /**
+     * @brief Check if the next scan uses the bus
+     *
+     * @return false if the scan can go ahead without budget
+     */
+    virtual bool needs_bus() {
+        return true;
+    }
+};
+
+//Whether the next read of an input uses the bus, see ScanGroup::needs_bus()
+template <typename Input>
+inline bool scan_needs_bus(Input& input)
+{
+    (void)input;
+    return true;
+}
+
+inline bool scan_needs_bus(Mcp23017Input& input)
+{
+    return input.pending();
+}
+
+//A ButtonBank read from an input with read() and transactions()
+template <size_t N, typename Input>
+class BankScanGroup : public ScanGroup {
+public:
+
+    /**
+     * @brief Constructor for class
+     *
+     * @param[in] input - input the bank is read from, begun by the caller
+     * @param[in] bank - bank decoding the input, begun by the caller
+     * @param[in] on_sequence - called with (size_t index, int sequence)
+     */
+    BankScanGroup(Input& input, ButtonBank<N>& bank,
+                    std::function<void(size_t, int)> on_sequence)
+        : _input(input), _bank(bank), _on_sequence(on_sequence) {}
+
+    uint32_t scan(system_tick_t now) override {
+        uint32_t before = _input.transactions();
+        uint32_t word = _input.read();
+        _bank.update(word, now, _on_sequence);
+        return _input.transactions() - before;
+    }
+
+    bool is_active() override {
+        return _bank.is_active();
+    }
+
+    system_tick_t debounce_interval() override {
+        return _bank.get_debounce_interval();
+    }
+
+    bool needs_bus() override {
+        return scan_needs_bus(_input);
+    }
+
+private:
+    Input& _input;
+    ButtonBank<N>& _bank;
+    std::function<void(size_t, int)> _on_sequence;
+};
+
+struct ScanGroupStats {
+    uint32_t scans;
+    uint32_t transactions;
+    uint32_t deferred;          //scans delayed because the budget was spent
+    system_tick_t max_late;     //longest a scan waited past its due time
+};
+
+class ScanScheduler {
+public:
+
+    /**
+     * @brief Constructor for class
+     *
+     * @param[in] budget - bus transactions per second the groups may use
+     */
+    explicit ScanScheduler(uint32_t budget);
+
+    /**
+     * @brief Add a group to the schedule
+     *
+     * @param[in] group - group to scan, must outlive the scheduler
+     * @param[in] active_interval - milli secs between scans while active, 0
+     * for the debounce interval / SCAN_ACTIVE_SAMPLES
+     * @param[in] idle_interval - milli secs between scans while idle, 0 for
+     * the debounce interval / SCAN_IDLE_SAMPLES
+     *
+     * @return true if added, false if SCAN_SCHEDULER_MAX_GROUPS are in use
+     */
+    bool add(ScanGroup* group, system_tick_t active_interval = 0,
+                system_tick_t idle_interval = 0);
+
+    /**
+     * @brief Change the bus budget
+     *
+     * @param[in] budget - bus transactions per second the groups may use
+     */
+    void set_budget(uint32_t budget);
+
+    /**
+     * @brief Scan the groups that are due, as far as the budget allows. Call
+     * every loop
+     *
+     * @param[in] now - milli sec time, millis() by default
+     *
+     * @return number of groups scanned
+     */
+    size_t run();
+    size_t run(system_tick_t now);
+
+    /**
+     * @brief Get the time the next group is due, e.g. to sleep until then
+     *
+     * @param[out] deadline - milli sec time of the next scan
+     *
+     * @return true if a group is added, false if there is nothing to scan
+     */
+    bool next_deadline(system_tick_t& deadline);
+
+    /**
+     * @brief Get the counters of a group since the last reset_stats()
+     *
+     * @param[in] index - position the group was added at
+     *
+     * @return the counters, zeros for an index not in use
+     */
+    ScanGroupStats stats(size_t index);
+
+    /**
+     * @brief Get the scans per second a group achieved since the last
+     * reset_stats()
+     *
+     * @param[in] index - position the group was added at
+     *
+     * @return scans per second, rounded down
+     */
+    uint32_t achieved_rate(size_t index);
+
+    /**
+     * @brief Get the share of the budget used since the last reset_stats()
+     *
+     * @return percent of the budget used by all groups
+     */
+    uint32_t budget_used();
+
+    /**
+     * @brief Print one line per group, "SCAN <index> <interval ms> <scans/s>
+     * <transactions/s> <deferred> <max late ms>", and the bus line, "BUS
+     * <budget/s> <transactions/s> <percent used>"
+     *
+     * @param[in] out - where to print, e.g. Serial
+     */
+    void print(Print& out);
+
+    /**
+     * @brief Zero the counters and restart the measurement interval
+     */
+    void reset_stats();
+
+private:
+    struct Entry {
+        ScanGroup* group;
+        system_tick_t active_interval;
+        system_tick_t idle_interval;
+        system_tick_t last_scan;
+        bool active;
+        bool waiting;           //due and deferred by the budget
+        ScanGroupStats stats;
+    };
+
+    /**
+     * @brief Get the interval of a group at its current activity
+     *
+     * @param[in] entry - group
+     *
+     * @return milli secs between scans
+     */
+    static system_tick_t interval(const Entry& entry);
+
+    /**
+     * @brief Add the budget earned since the last refill to the bucket
+     *
+     * @param[in] now - milli sec time
+     */
+    void refill(system_tick_t now);
+
+    Entry _entries[SCAN_SCHEDULER_MAX_GROUPS];
+    size_t _count;
+    uint32_t _budget;
+    //milli transactions in the bucket, below 0 after a scan that cost more
+    int32_t _tokens;
+    system_tick_t _refill_time;
+    system_tick_t _stats_start;
+};
@@ -0,0 +1,102 @@
+/**
+ * @file ShiftRegisterInput.cpp
+ * @author Ed Ablan
+ * @version 1.0
+ * @date 10/17/2026
+ *
+ * @brief Reads a chain of 74HC165 shift registers over SPI or bit bang
+ *
+ * @details Please read the header file for more details
+ *
+ * @copyright Copyright (c) 2020 Particle Industries, Inc.  All rights reserved.
+ */
+
+#include "ShiftRegisterInput.h"
+
+ShiftRegisterTransport::ShiftRegisterTransport(uint8_t bits)
+    : _bits((bits > SHIFT_REGISTER_MAX_BITS) ? SHIFT_REGISTER_MAX_BITS :
+                                                ((bits + 7) & ~7))
+    , _transactions(0)
+{
+}
+
+uint32_t ShiftRegisterTransport::assemble(const uint8_t* bytes) const
+{
+    uint32_t word = 0;
+    for(uint8_t r = 0; r < _bits / 8; r++) {
+        word |= (uint32_t)bytes[r] << (8 * r);
+    }
+    return word;
+}
+
+ShiftRegisterSpi::ShiftRegisterSpi(SPIClass& spi, pin_t load_pin, uint8_t bits,
+                                    uint32_t clock_hz)
+    : ShiftRegisterTransport(bits)
+    , _spi(spi)
+    , _load_pin(load_pin)
+    , _clock_hz(clock_hz)
+{
+}
+
+void ShiftRegisterSpi::begin()
+{
+    pinMode(_load_pin, OUTPUT);
+    digitalWrite(_load_pin, 1);
+    _spi.begin();
+    _transactions = 0;
+}
+
+uint32_t ShiftRegisterSpi::read()
+{
+    uint8_t bytes[SHIFT_REGISTER_MAX_BITS / 8];
+
+    //switching a shared bus from mode 0 raises SCK to the mode 2 idle level,
+    //a rising edge that shifts the chain, so it must come before the latch
+    _spi.beginTransaction(SPISettings(_clock_hz, MSBFIRST, SPI_MODE2));
+    //a low pulse on SH/LD latches the inputs, QH then holds D7 of register 0
+    digitalWrite(_load_pin, 0);
+    digitalWrite(_load_pin, 1);
+    _spi.transfer(NULL, bytes, _bits / 8, NULL);
+    _spi.endTransaction();
+    _transactions++;
+    return assemble(bytes);
+}
+
+ShiftRegisterBitBang::ShiftRegisterBitBang(pin_t load_pin, pin_t clock_pin,
+                                            pin_t data_pin, uint8_t bits)
+    : ShiftRegisterTransport(bits)
+    , _load_pin(load_pin)
+    , _clock_pin(clock_pin)
+    , _data_pin(data_pin)
+{
+}
+
+void ShiftRegisterBitBang::begin()
+{
+    pinMode(_load_pin, OUTPUT);
+    pinMode(_clock_pin, OUTPUT);
+    pinMode(_data_pin, INPUT);
+    digitalWrite(_load_pin, 1);
+    digitalWrite(_clock_pin, 0);
+    _transactions = 0;
+}
+
+uint32_t ShiftRegisterBitBang::read()
+{
+    uint8_t bytes[SHIFT_REGISTER_MAX_BITS / 8];
+
+    digitalWrite(_load_pin, 0);
+    digitalWrite(_load_pin, 1);
+    //the bit on QH is read before the rising clock edge shifts in the next
+    for(uint8_t r = 0; r < _bits / 8; r++) {
+        uint8_t byte = 0;
+        for(uint8_t k = 0; k < 8; k++) {
+            byte = (byte << 1) | (digitalRead(_data_pin) ? 1 : 0);
+            digitalWrite(_clock_pin, 1);
+            digitalWrite(_clock_pin, 0);
+        }
+        bytes[r] = byte;
+    }
+    _transactions++;
+    return assemble(bytes);
+}
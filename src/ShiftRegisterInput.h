@@ -0,0 +1,138 @@
+/**
+ * @file ShiftRegisterInput.h
+ * @author Ed Ablan
+ * @version 1.0
+ * @date 10/17/2026
+ *
+ * @brief Reads buttons through a chain of parallel in, serial out shift
+ * registers (74HC165 and compatible) in one transaction per poll
+ *
+ * @details read() latches every input of the chain with the load pin and
+ * shifts the whole chain out, 8 inputs per register and at most 32. Pass the
+ * word to a ButtonBank (or a DebounceBank) instead of reading the chain once
+ * per button. ShiftRegisterSpi clocks the chain with the SPI peripheral,
+ * ShiftRegisterBitBang with any three pins. Bit 8 * r + k of the word is
+ * input Dk of register r, register 0 being the one whose QH output is wired
+ * to the MCU. CE of every register must be low (tied to ground)
+ *
+ * @copyright Copyright (c) 2020 Particle Industries, Inc.  All rights reserved.
+ */
+#pragma once
+
+#include "Particle.h"
+
+//Longest chain, 4 registers
+#define SHIFT_REGISTER_MAX_BITS 32
+
+#ifndef SHIFT_REGISTER_SPI_HZ
+#define SHIFT_REGISTER_SPI_HZ (4 * MHZ)
+#endif
+
+class ShiftRegisterTransport {
+public:
+    virtual ~ShiftRegisterTransport() {}
+
+    /**
+     * @brief Set up the pins, call from setup() before the first read()
+     */
+    virtual void begin() = 0;
+
+    /**
+     * @brief Latch the inputs and shift the whole chain out
+     *
+     * @return the inputs, bit 8 * r + k is input Dk of register r
+     */
+    virtual uint32_t read() = 0;
+
+    /**
+     * @brief Get the number of inputs of the chain
+     *
+     * @return 8 per register
+     */
+    uint8_t bits() const {
+        return _bits;
+    }
+
+    /**
+     * @brief Get the number of chain reads since begin(), to account for the
+     * bus time
+     *
+     * @return calls to read()
+     */
+    uint32_t transactions() const {
+        return _transactions;
+    }
+
+protected:
+
+    /**
+     * @brief Constructor for class
+     *
+     * @param[in] bits - number of inputs, rounded up to whole registers and
+     * capped at SHIFT_REGISTER_MAX_BITS
+     */
+    explicit ShiftRegisterTransport(uint8_t bits);
+
+    /**
+     * @brief Assemble the word from the bytes shifted out, MSB first
+     *
+     * @param[in] bytes - one byte per register, register 0 first
+     *
+     * @return the inputs
+     */
+    uint32_t assemble(const uint8_t* bytes) const;
+
+    uint8_t _bits;
+    uint32_t _transactions;
+};
+
+class ShiftRegisterSpi : public ShiftRegisterTransport {
+public:
+
+    /**
+     * @brief Constructor for class
+     *
+     * @details Wire CLK to SCK and QH of register 0 to MISO, MOSI is not used.
+     * The chain is read in SPI mode 2 so the first bit is sampled before the
+     * first shift
+     *
+     * @param[in] spi - SPI interface, e.g. SPI or SPI1
+     * @param[in] load_pin - pin wired to SH/LD of every register
+     * @param[in] bits - number of inputs, 8 per register
+     * @param[in] clock_hz - SPI clock, the 74HC165 runs up to about 25 MHz at
+     * 3.3 V
+     */
+    ShiftRegisterSpi(SPIClass& spi, pin_t load_pin, uint8_t bits,
+                    uint32_t clock_hz = SHIFT_REGISTER_SPI_HZ);
+
+    void begin() override;
+    uint32_t read() override;
+
+private:
+    SPIClass& _spi;
+    pin_t _load_pin;
+    uint32_t _clock_hz;
+};
+
+class ShiftRegisterBitBang : public ShiftRegisterTransport {
+public:
+
+    /**
+     * @brief Constructor for class
+     *
+     * @param[in] load_pin - pin wired to SH/LD of every register
+     * @param[in] clock_pin - pin wired to CLK of every register
+     * @param[in] data_pin - pin wired to QH of register 0
+     * @param[in] bits - number of inputs, 8 per register
+     */
+    ShiftRegisterBitBang(pin_t load_pin, pin_t clock_pin, pin_t data_pin,
+                        uint8_t bits);
+
+    void begin() override;
+    uint32_t read() override;
+
+private:
+    pin_t _load_pin;
+    pin_t _clock_pin;
+    pin_t _data_pin;
+};
@@ -10,9 +10,26 @@
  *
  * @copyright Copyright (c) 2020 Particle Industries, Inc.  All rights reserved.
  */
+#pragma once
+
+#include <stdint.h>
 
 //Describes active low or active high for inputs
 enum class ActiveLevel {
         LOW = 0,
         HIGH = 1,
+};
+
+//Stages of a press reported before the debounce interval has passed
+enum class PressPhase {
+        TENTATIVE = 0,  //first raw edge towards pressed
+        CONFIRMED = 1,  //the debounce confirmed the press
+        CANCELLED = 2,  //the signal settled back without a press
+};
+
+//A decoded button sequence with the time it terminated
+struct ButtonEvent {
+        uint32_t timestamp;     //milli secs when the sequence terminated
+        uint16_t button_id;     //id given to the button by its source
+        int16_t sequence;       //check_button() result, negative for long
 };
\ No newline at end of file
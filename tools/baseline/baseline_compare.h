@@ -0,0 +1,105 @@
+/**
+ * @file baseline_compare.h
+ * @author Ed Ablan
+ * @version 1.0
+ * @date 10/17/2026
+ *
+ * @brief Compares the results of a host tool against a baseline written with
+ * its --json option
+ *
+ * @details Shared by tools/bench and tools/golden. The baseline holds one
+ * case per line, {"name": "<case>", "<metric>": <value>, ...}, and each line
+ * is matched by name against the current results. A metric regressed when it
+ * grew past its threshold, in percent of the baseline; a metric with a
+ * negative threshold is only reported, e.g. timings that depend on the host
+ * and its load. Header only, add
+ * -Itools/baseline to the build line of the tool
+ *
+ * @copyright Copyright (c) 2020 Particle Industries, Inc.  All rights reserved.
+ */
+#pragma once
+
+#include <stdio.h>
+#include <string.h>
+
+#include <string>
+#include <vector>
+
+//A metric of the current results and how much it may grow
+struct BaselineMetric {
+    const char* name;
+    double value;
+    double threshold;       //percent, 0 for any growth, negative to report
+};
+
+//Find "key": value on a line of the JSON output
+inline bool baseline_json_number(const char* line, const char* key,
+                                    double& value)
+{
+    std::string pattern = std::string("\"") + key + "\": ";
+    const char* found = strstr(line, pattern.c_str());
+    return found && sscanf(found + pattern.size(), "%lf", &value) == 1;
+}
+
+inline bool baseline_json_name(const char* line, std::string& name)
+{
+    const char* found = strstr(line, "\"name\": \"");
+    if(!found) {
+        return false;
+    }
+    found += strlen("\"name\": \"");
+    const char* end = strchr(found, '"');
+    if(!end) {
+        return false;
+    }
+    name.assign(found, end - found);
+    return true;
+}
+
+/**
+ * @brief Compare against a baseline written with --json and print a line per
+ * metric
+ *
+ * @param[in] path - baseline file
+ * @param[in] kind - heading of the case column, e.g. "case" or "trace"
+ * @param[in] metrics - callable taking (const std::string& name,
+ * std::vector<BaselineMetric>& out), fills out with the current metrics of
+ * the case and returns false if there is no such case
+ *
+ * @return regressions found, -1 if the baseline cannot be read
+ */
+template <typename F>
+int baseline_compare(const char* path, const char* kind, F&& metrics)
+{
+    FILE* in = fopen(path, "r");
+    if(!in) {
+        fprintf(stderr, "cannot open baseline %s\n", path);
+        return -1;
+    }
+
+    int regressions = 0;
+    char line[1024];
+    printf("\n%-22s %-24s %12s %12s %8s\n", kind, "metric", "baseline",
+            "current", "change");
+    while(fgets(line, sizeof(line), in)) {
+        std::string name;
+        std::vector<BaselineMetric> current;
+        if(!baseline_json_name(line, name) || !metrics(name, current)) {
+            continue;
+        }
+        for(const BaselineMetric& m : current) {
+            double base;
+            if(!baseline_json_number(line, m.name, base) || base <= 0) {
+                continue;
+            }
+            double change = (m.value - base) * 100.0 / base;
+            bool regressed = m.threshold >= 0 && change > m.threshold;
+            regressions += regressed;
+            printf("%-22s %-24s %12.4f %12.4f %+7.1f%%%s\n", name.c_str(),
+                    m.name, base, m.value, change,
+                    (regressed) ? "  REGRESSION" : "");
+        }
+    }
+    fclose(in);
+    return regressions;
+}
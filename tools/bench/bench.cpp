@@ -0,0 +1,438 @@
+/** 
+ * @file bench.cpp
+ * @author Ed Ablan
+ * @version 1.0
+ * @date 10/17/2026
+ *
+ * @brief Host benchmarks of the debounce and sequence engine
+ *
+ * @details Runs each benchmark case for a fixed number of polls against the
+ * fake host clock and reports ns/poll. With --perf, cycles, instructions, 
+ * branch misses and L1 data cache read misses per poll are collected with 
+ * perf_event_open() (needs kernel.perf_event_paranoid <= 2, cases still run
+ * without them). Each counter is opened on its own, so one the host does not
+ * have only drops its column. When the PMU has fewer counters than asked
+ * for, the kernel multiplexes them; the counts are then scaled by the time
+ * enabled over the time running, marked with a *, and only reported by
+ * --compare. --json writes the results, --compare checks them against a 
+ * stored baseline and exits with 1 if a metric regressed past --threshold 
+ * percent.
+ *
+ * Build from the repository root:
+ *  g++ -O2 -std=c++14 -Itools/host -Isrc -Itools/baseline tools/host/host.cpp
+ *      src/Debounce.cpp src/ButtonSequence.cpp tools/bench/bench.cpp -o bench
+ *
+ * usage: bench [--perf] [--polls n] [--json out.json] 
+ *              [--compare baseline.json] [--threshold percent] [--filter name]
+ *
+ * @copyright Copyright (c) 2020 Particle Industries, Inc.  All rights reserved.
+ */
+
+#include <linux/perf_event.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <string>
+#include <vector>
+
+#include "ButtonSequence.h"
+#include "baseline_compare.h"
+
+#define BENCH_DEFAULT_POLLS 2000000
+#define BENCH_REPEATS 5
+#define BENCH_DEFAULT_THRESHOLD 10.0
+#define BENCH_PIN 1
+
+//Counters collected with --perf, in this order
+enum PerfCounter {
+    PERF_CYCLES,
+    PERF_INSTRUCTIONS,
+    PERF_BRANCH_MISSES,
+    PERF_L1D_MISSES,
+    PERF_COUNTERS,
+};
+
+static const char* const perf_names[PERF_COUNTERS] = {
+    "cycles_per_poll",
+    "instructions_per_poll",
+    "branch_misses_per_poll",
+    "l1d_misses_per_poll",
+};
+
+struct BenchResult {
+    std::string name;
+    uint64_t polls;
+    double ns_per_poll;
+    bool has_perf[PERF_COUNTERS];
+    bool multiplexed;       //a counter did not run the whole time, scaled
+    double perf[PERF_COUNTERS];
+};
+
+//Value of a counter read with the total times enabled and running
+struct PerfReading {
+    uint64_t value;
+    uint64_t time_enabled;
+    uint64_t time_running;
+};
+
+class PerfCounters {
+public:
+    PerfCounters() {
+        for(int i = 0; i < PERF_COUNTERS; i++) {_fds[i] = -1;}
+    }
+
+    ~PerfCounters() {
+        for(int i = 0; i < PERF_COUNTERS; i++) {
+            if(_fds[i] >= 0) {close(_fds[i]);}
+        }
+    }
+
+    //Opens every counter the host has, false if it has none
+    bool open() {
+        static const uint32_t types[PERF_COUNTERS] = {
+            PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE, 
+            PERF_TYPE_HW_CACHE,
+        };
+        static const uint64_t configs[PERF_COUNTERS] = {
+            PERF_COUNT_HW_CPU_CYCLES,
+            PERF_COUNT_HW_INSTRUCTIONS,
+            PERF_COUNT_HW_BRANCH_MISSES,
+            PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) | 
+                (PERF_COUNT_HW_CACHE_RESULT_MISS << 16),
+        };
+        bool opened = false;
+        for(int i = 0; i < PERF_COUNTERS; i++) {
+            struct perf_event_attr attr;
+            memset(&attr, 0, sizeof(attr));
+            attr.size = sizeof(attr);
+            attr.type = types[i];
+            attr.config = configs[i];
+            attr.disabled = 1;
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | 
+                                PERF_FORMAT_TOTAL_TIME_RUNNING;
+            _fds[i] = syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+            opened |= _fds[i] >= 0;
+        }
+        return opened;
+    }
+
+    void start() {
+        for(int i = 0; i < PERF_COUNTERS; i++) {
+            if(_fds[i] < 0) {continue;}
+            ioctl(_fds[i], PERF_EVENT_IOC_RESET, 0);
+            ioctl(_fds[i], PERF_EVENT_IOC_ENABLE, 0);
+        }
+    }
+
+    //Per poll counts of the counters that ran into the result
+    void stop(uint64_t polls, BenchResult& result) {
+        for(int i = 0; i < PERF_COUNTERS; i++) {
+            if(_fds[i] >= 0) {ioctl(_fds[i], PERF_EVENT_IOC_DISABLE, 0);}
+        }
+        result.multiplexed = false;
+        for(int i = 0; i < PERF_COUNTERS; i++) {
+            PerfReading reading;
+            result.has_perf[i] = _fds[i] >= 0 &&
+                read(_fds[i], &reading, sizeof(reading)) == sizeof(reading) &&
+                reading.time_running;
+            if(!result.has_perf[i]) {
+                continue;
+            }
+            double count = reading.value;
+            if(reading.time_running < reading.time_enabled) {
+                count = count * reading.time_enabled / reading.time_running;
+                result.multiplexed = true;
+            }
+            result.perf[i] = count / polls;
+        }
+    }
+
+private:
+    int _fds[PERF_COUNTERS];
+};
+
+//Level of a button at a given milli sec: a click with 3 ms of contact bounce
+//every 400 ms, held for 120 ms, and a 6 s hold every 10 s
+static bool click_pattern(uint32_t ms)
+{
+    uint32_t in_hold = ms % 10000;
+    if(in_hold >= 2000 && in_hold < 8000) {
+        return true;
+    }
+    uint32_t t = ms % 400;
+    if(t < 3) {return t & 1;}
+    if(t >= 120 && t < 123) {return !(t & 1);}
+    return t < 120;
+}
+
+static volatile int bench_sink;
+
+struct BenchCase {
+    const char* name;
+    void (*run)(uint64_t polls);
+};
+
+static void bench_debounce_steady(uint64_t polls)
+{
+    Debounce debounce;
+    debounce.attach([]() { return 0; }, DEFAULT_DEBOUNCE_MS);
+    int changes = 0;
+    for(uint64_t i = 0; i < polls; i++) {
+        changes += debounce.update(false, (uint32_t)i);
+    }
+    bench_sink = changes;
+}
+
+static void bench_debounce_clicks(uint64_t polls)
+{
+    Debounce debounce;
+    debounce.attach([]() { return 0; }, DEFAULT_DEBOUNCE_MS);
+    int changes = 0;
+    for(uint64_t i = 0; i < polls; i++) {
+        changes += debounce.update(click_pattern(i), (uint32_t)i);
+    }
+    bench_sink = changes;
+}
+
+static void bench_sequence_steady(uint64_t polls)
+{
+    ButtonSequence button([]() { return 0; }, ActiveLevel::HIGH);
+    int sequences = 0;
+    for(uint64_t i = 0; i < polls; i++) {
+        sequences += button.check_button(false, (system_tick_t)i);
+    }
+    bench_sink = sequences;
+}
+
+static void bench_sequence_clicks(uint64_t polls)
+{
+    ButtonSequence button([]() { return 0; }, ActiveLevel::HIGH);
+    int sequences = 0;
+    for(uint64_t i = 0; i < polls; i++) {
+        sequences += button.check_button(click_pattern(i), (system_tick_t)i);
+    }
+    bench_sink = sequences;
+}
+
+static void bench_sequence_pin(uint64_t polls)
+{
+    host_set_micros(0);
+    host_set_pin(BENCH_PIN, 0);
+    ButtonSequence button(BENCH_PIN, INPUT, ActiveLevel::HIGH);
+    int sequences = 0;
+    for(uint64_t i = 0; i < polls; i++) {
+        host_set_pin(BENCH_PIN, click_pattern(i));
+        host_advance_micros(1000);
+        sequences += button.check_button();
+    }
+    bench_sink = sequences;
+}
+
+static volatile int32_t bench_level;
+
+static int32_t bench_read_level(void* context)
+{
+    return *(volatile int32_t*)context;
+}
+
+//The two read sources differ only in how the level is fetched: through the
+//std::function the debounce keeps on the heap, or one call through a
+//function pointer
+static void bench_sequence_function(uint64_t polls)
+{
+    host_set_micros(0);
+    bench_level = 0;
+    ButtonSequence button([]() { return (int32_t)bench_level; }, 
+                            ActiveLevel::HIGH);
+    int sequences = 0;
+    for(uint64_t i = 0; i < polls; i++) {
+        bench_level = click_pattern(i);
+        host_advance_micros(1000);
+        sequences += button.check_button();
+    }
+    bench_sink = sequences;
+}
+
+static void bench_sequence_fnptr(uint64_t polls)
+{
+    host_set_micros(0);
+    bench_level = 0;
+    ButtonSequence button(bench_read_level, (void*)&bench_level, 
+                            ActiveLevel::HIGH);
+    int sequences = 0;
+    for(uint64_t i = 0; i < polls; i++) {
+        bench_level = click_pattern(i);
+        host_advance_micros(1000);
+        sequences += button.check_button();
+    }
+    bench_sink = sequences;
+}
+
+static const BenchCase bench_cases[] = {
+    {"debounce_steady", bench_debounce_steady},
+    {"debounce_clicks", bench_debounce_clicks},
+    {"sequence_steady", bench_sequence_steady},
+    {"sequence_clicks", bench_sequence_clicks},
+    {"sequence_pin", bench_sequence_pin},
+    {"sequence_function", bench_sequence_function},
+    {"sequence_fnptr", bench_sequence_fnptr},
+};
+
+static double now_ns()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static BenchResult run_case(const BenchCase& bench, uint64_t polls, 
+                            PerfCounters* perf)
+{
+    BenchResult result = {};
+    result.name = bench.name;
+    result.polls = polls;
+
+    //best of the repeats, the first run also warms up the caches
+    for(int r = 0; r < BENCH_REPEATS; r++) {
+        BenchResult run = result;
+        if(perf) {perf->start();}
+        double start = now_ns();
+        bench.run(polls);
+        run.ns_per_poll = (now_ns() - start) / polls;
+        if(perf) {perf->stop(polls, run);}
+
+        if(r == 0 || run.ns_per_poll < result.ns_per_poll) {
+            result = run;
+        }
+    }
+    return result;
+}
+
+static void write_json(FILE* out, const std::vector<BenchResult>& results)
+{
+    //one case per line, --compare relies on it
+    fprintf(out, "{\"cases\": [\n");
+    for(size_t i = 0; i < results.size(); i++) {
+        const BenchResult& r = results[i];
+        fprintf(out, "  {\"name\": \"%s\", \"polls\": %llu, \"ns_per_poll\": %.4f",
+                r.name.c_str(), (unsigned long long)r.polls, r.ns_per_poll);
+        for(int p = 0; p < PERF_COUNTERS; p++) {
+            if(r.has_perf[p]) {
+                fprintf(out, ", \"%s\": %.4f", perf_names[p], r.perf[p]);
+            }
+        }
+        if(r.multiplexed) {
+            fprintf(out, ", \"multiplexed\": 1");
+        }
+        fprintf(out, "}%s\n", (i + 1 < results.size()) ? "," : "");
+    }
+    fprintf(out, "]}\n");
+}
+
+//Compare against a baseline written with --json, returns regressions found
+static int compare(const char* path, const std::vector<BenchResult>& results,
+                    double threshold)
+{
+    return baseline_compare(path, "case", [&](const std::string& name,
+                                        std::vector<BaselineMetric>& out) {
+        for(const BenchResult& r : results) {
+            if(r.name != name) {continue;}
+            out.push_back({"ns_per_poll", r.ns_per_poll, threshold});
+            //scaled estimates of multiplexed counters are only reported
+            for(int p = 0; p < PERF_COUNTERS; p++) {
+                if(r.has_perf[p]) {
+                    out.push_back({perf_names[p], r.perf[p],
+                                    (r.multiplexed) ? -1 : threshold});
+                }
+            }
+            return true;
+        }
+        return false;
+    });
+}
+
+int main(int argc, char** argv)
+{
+    bool use_perf = false;
+    uint64_t polls = BENCH_DEFAULT_POLLS;
+    const char* json_path = NULL;
+    const char* baseline_path = NULL;
+    const char* filter = NULL;
+    double threshold = BENCH_DEFAULT_THRESHOLD;
+
+    for(int i = 1; i < argc; i++) {
+        bool has_value = i + 1 < argc;
+        if(!strcmp(argv[i], "--perf")) {use_perf = true;}
+        else if(!strcmp(argv[i], "--polls") && has_value) {
+            polls = strtoull(argv[++i], NULL, 0);
+        }
+        else if(!strcmp(argv[i], "--json") && has_value) {json_path = argv[++i];}
+        else if(!strcmp(argv[i], "--compare") && has_value) {
+            baseline_path = argv[++i];
+        }
+        else if(!strcmp(argv[i], "--threshold") && has_value) {
+            threshold = atof(argv[++i]);
+        }
+        else if(!strcmp(argv[i], "--filter") && has_value) {filter = argv[++i];}
+        else {
+            fprintf(stderr, "usage: %s [--perf] [--polls n] [--json out.json] "
+                "[--compare baseline.json] [--threshold percent] "
+                "[--filter name]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    PerfCounters perf_counters;
+    PerfCounters* perf = NULL;
+    if(use_perf) {
+        if(perf_counters.open()) {perf = &perf_counters;}
+        else {fprintf(stderr, "perf_event_open unavailable, timing only\n");}
+    }
+
+    std::vector<BenchResult> results;
+    bool multiplexed = false;
+    printf("%-20s %10s", "case", "ns/poll");
+    if(perf) {printf(" %10s %10s %10s %10s", "cyc", "instr", "br-miss", "l1d-miss");}
+    printf("\n");
+    for(size_t i = 0; i < sizeof(bench_cases) / sizeof(bench_cases[0]); i++) {
+        if(filter && !strstr(bench_cases[i].name, filter)) {continue;}
+        BenchResult r = run_case(bench_cases[i], polls, perf);
+        printf("%-20s %10.3f", r.name.c_str(), r.ns_per_poll);
+        for(int p = 0; perf && p < PERF_COUNTERS; p++) {
+            if(r.has_perf[p]) {printf(" %10.3f", r.perf[p]);}
+            else {printf(" %10s", "-");}
+        }
+        printf("%s\n", (r.multiplexed) ? " *" : "");
+        multiplexed |= r.multiplexed;
+        results.push_back(r);
+    }
+    if(multiplexed) {
+        printf("* counters multiplexed, scaled by time enabled / running\n");
+    }
+
+    if(json_path) {
+        FILE* out = fopen(json_path, "w");
+        if(!out) {
+            fprintf(stderr, "cannot write %s\n", json_path);
+            return 1;
+        }
+        write_json(out, results);
+        fclose(out);
+    }
+
+    if(baseline_path) {
+        int regressions = compare(baseline_path, results, threshold);
+        if(regressions) {
+            printf("%d regression(s) above %.1f%%\n", regressions, threshold);
+            return 1;
+        }
+    }
+    return 0;
+}
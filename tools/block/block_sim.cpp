@@ -0,0 +1,228 @@
+/**
+ * @file block_sim.cpp
+ * @author Ed Ablan
+ * @version 1.0
+ * @date 10/17/2026
+ *
+ * @brief Checks on the host that updateBlock() of Debounce and DebounceBank
+ * settles at the same samples as update() called for every sample
+ *
+ * @details Random bouncing traces are cut into blocks of random length and
+ * fed to updateBlock() with each of SIM_PERIODS, most of them not whole milli
+ * secs. A second instance is fed the same samples one at a time with
+ * update(value, start_millis + index * period / 1000). Every debounced change
+ * must happen at the same sample with the same timestamp and state, and the
+ * state left after the last block must be the same, which is checked by
+ * feeding both instances the same tail one sample at a time. Prints one line
+ * per period and kind, exits with 1 on a mismatch.
+ *
+ * Build from the repository root:
+ *  g++ -O2 -std=c++14 -Itools/host -Isrc tools/host/host.cpp
+ *      src/Debounce.cpp src/DebounceBank.cpp tools/block/block_sim.cpp
+ *      -o block_sim
+ *
+ * usage: block_sim [--traces n] [--seed n]
+ *
+ * @copyright Copyright (c) 2020 Particle Industries, Inc.  All rights reserved.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <vector>
+
+#include "Debounce.h"
+#include "DebounceBank.h"
+
+#define SIM_DEFAULT_TRACES 1000
+#define SIM_SAMPLES 4000
+#define SIM_INTERVAL_MS 5
+#define SIM_MAX_BLOCK 700
+#define SIM_TAIL 200
+#define SIM_MAX_EVENTS 1024
+
+static const uint32_t SIM_PERIODS[] = {300, 7, 33, 250, 999, 1000, 1500, 2700};
+
+struct SimChange {
+    uint32_t sample;        //index in the whole trace
+    uint32_t timestamp;
+    uint32_t state;
+};
+
+static uint32_t sim_seed = 1;
+
+static uint32_t sim_random(uint32_t range)
+{
+    sim_seed = sim_seed * 1103515245 + 12345;
+    return (sim_seed >> 8) % range;
+}
+
+//Holds of random length, short ones are bounces, for each of bits inputs
+static std::vector<uint32_t> sim_trace(size_t n, int bits)
+{
+    std::vector<uint32_t> samples(n);
+    for(int bit = 0; bit < bits; bit++) {
+        bool level = sim_random(2);
+        size_t i = 0;
+        while(i < n) {
+            size_t hold = (sim_random(4)) ? 1 + sim_random(20) :
+                                            1 + sim_random(400);
+            for(; hold && i < n; hold--, i++) {
+                samples[i] |= (uint32_t)level << bit;
+            }
+            level = !level;
+        }
+    }
+    return samples;
+}
+
+//Block boundaries, random lengths to cross changes pending between blocks
+static std::vector<size_t> sim_blocks(size_t n)
+{
+    std::vector<size_t> starts;
+    for(size_t i = 0; i < n; i += 1 + sim_random(SIM_MAX_BLOCK)) {
+        starts.push_back(i);
+    }
+    starts.push_back(n);
+    return starts;
+}
+
+static uint32_t sim_time(uint32_t start_millis, size_t index, uint32_t period)
+{
+    return start_millis + (uint32_t)((uint64_t)index * period / 1000);
+}
+
+static bool sim_same(const std::vector<SimChange>& a,
+                        const std::vector<SimChange>& b)
+{
+    if(a.size() != b.size()) {
+        return false;
+    }
+    for(size_t i = 0; i < a.size(); i++) {
+        if(a[i].sample != b[i].sample || a[i].timestamp != b[i].timestamp ||
+                a[i].state != b[i].state) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool check_single(uint32_t period)
+{
+    std::vector<uint32_t> trace = sim_trace(SIM_SAMPLES + SIM_TAIL, 1);
+    std::vector<uint8_t> samples(trace.begin(), trace.end());
+    std::vector<size_t> starts = sim_blocks(SIM_SAMPLES);
+    std::vector<SimChange> block, single;
+    static DebounceEvent events[SIM_MAX_EVENTS];
+    Debounce a, b;
+
+    host_set_micros(0);
+    a.attach([]() -> int32_t {return 0;}, SIM_INTERVAL_MS);
+    b.attach([]() -> int32_t {return 0;}, SIM_INTERVAL_MS);
+    for(size_t k = 0; k + 1 < starts.size(); k++) {
+        size_t first = starts[k];
+        size_t n = starts[k + 1] - first;
+        uint32_t start_millis = sim_time(0, first, period);
+        size_t count = a.updateBlock(&samples[first], n, start_millis, period,
+                                        events, SIM_MAX_EVENTS);
+        for(size_t e = 0; e < count && e < SIM_MAX_EVENTS; e++) {
+            block.push_back({(uint32_t)(first + events[e].sample),
+                            events[e].timestamp, events[e].state});
+        }
+        for(size_t i = 0; i < n; i++) {
+            uint32_t now = sim_time(start_millis, i, period);
+            if(b.update(samples[first + i], now)) {
+                single.push_back({(uint32_t)(first + i), now, b.read()});
+            }
+        }
+    }
+    //the state left by the blocks must carry on the same
+    uint32_t end_millis = sim_time(0, SIM_SAMPLES, period);
+    for(size_t i = 0; i < SIM_TAIL; i++) {
+        uint32_t now = sim_time(end_millis, i, period);
+        if(a.update(samples[SIM_SAMPLES + i], now)) {
+            block.push_back({(uint32_t)(SIM_SAMPLES + i), now, a.read()});
+        }
+        if(b.update(samples[SIM_SAMPLES + i], now)) {
+            single.push_back({(uint32_t)(SIM_SAMPLES + i), now, b.read()});
+        }
+    }
+    return sim_same(block, single);
+}
+
+static bool check_bank(uint32_t period)
+{
+    std::vector<uint32_t> samples = sim_trace(SIM_SAMPLES + SIM_TAIL, 32);
+    std::vector<size_t> starts = sim_blocks(SIM_SAMPLES);
+    std::vector<SimChange> block, single;
+    static DebounceBankEvent events[SIM_MAX_EVENTS];
+    DebounceBank a, b;
+
+    host_set_micros(0);
+    a.attach(0, SIM_INTERVAL_MS);
+    b.attach(0, SIM_INTERVAL_MS);
+    for(size_t k = 0; k + 1 < starts.size(); k++) {
+        size_t first = starts[k];
+        size_t n = starts[k + 1] - first;
+        uint32_t start_millis = sim_time(0, first, period);
+        size_t count = a.updateBlock(&samples[first], n, start_millis, period,
+                                        events, SIM_MAX_EVENTS);
+        for(size_t e = 0; e < count && e < SIM_MAX_EVENTS; e++) {
+            block.push_back({(uint32_t)(first + events[e].sample),
+                            events[e].timestamp, events[e].state});
+        }
+        for(size_t i = 0; i < n; i++) {
+            uint32_t now = sim_time(start_millis, i, period);
+            if(b.update(samples[first + i], now)) {
+                single.push_back({(uint32_t)(first + i), now, b.read()});
+            }
+        }
+    }
+    uint32_t end_millis = sim_time(0, SIM_SAMPLES, period);
+    for(size_t i = 0; i < SIM_TAIL; i++) {
+        uint32_t now = sim_time(end_millis, i, period);
+        if(a.update(samples[SIM_SAMPLES + i], now)) {
+            block.push_back({(uint32_t)(SIM_SAMPLES + i), now, a.read()});
+        }
+        if(b.update(samples[SIM_SAMPLES + i], now)) {
+            single.push_back({(uint32_t)(SIM_SAMPLES + i), now, b.read()});
+        }
+    }
+    return sim_same(block, single);
+}
+
+int main(int argc, char** argv)
+{
+    uint32_t traces = SIM_DEFAULT_TRACES;
+
+    for(int i = 1; i < argc; i++) {
+        bool has_value = i + 1 < argc;
+        if(!strcmp(argv[i], "--traces") && has_value) {
+            traces = strtoul(argv[++i], NULL, 0);
+        }
+        else if(!strcmp(argv[i], "--seed") && has_value) {
+            sim_seed = strtoul(argv[++i], NULL, 0);
+        }
+        else {
+            fprintf(stderr, "usage: %s [--traces n] [--seed n]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    bool ok = true;
+    for(uint32_t period : SIM_PERIODS) {
+        uint32_t single = 0, bank = 0;
+        for(uint32_t t = 0; t < traces; t++) {
+            single += !check_single(period);
+            bank += !check_bank(period);
+        }
+        printf("period %4lu us: single %lu/%lu bank %lu/%lu mismatched\n",
+                (unsigned long)period, (unsigned long)single,
+                (unsigned long)traces, (unsigned long)bank,
+                (unsigned long)traces);
+        ok &= !single && !bank;
+    }
+    printf("%s\n", (ok) ? "ok" : "MISMATCH");
+    return (ok) ? 0 : 1;
+}
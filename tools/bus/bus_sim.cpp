@@ -0,0 +1,234 @@
+/**
+ * @file bus_sim.cpp
+ * @author Ed Ablan
+ * @version 1.0
+ * @date 10/17/2026
+ *
+ * @brief Checks ButtonEventBus on the host, from one thread and with several
+ * producer threads racing one consumer
+ *
+ * @details From one thread: events are drained in the order published, in
+ * batches of at most max_events, ready() tells whether drain() has one, a
+ * full bus drops and counts the events past N and take_dropped() zeroes the
+ * count. Random bursts then run the ring through many laps against a model
+ * of the queue. After that --producers threads each publish --events events
+ * tagged with their producer and position while the main thread drains
+ * them: every producer's events must arrive in the order published, none
+ * twice, exactly those whose publish() returned true, and the events
+ * received plus dropped() must equal the events published. Exits with 1 on
+ * a failed check.
+ *
+ * Build from the repository root:
+ *  g++ -O2 -std=c++14 -pthread -Isrc tools/bus/bus_sim.cpp -o bus_sim
+ *
+ * usage: bus_sim [--events n] [--producers n] [--seed n]
+ *
+ * @copyright Copyright (c) 2020 Particle Industries, Inc.  All rights reserved.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <atomic>
+#include <deque>
+#include <thread>
+#include <vector>
+
+#include "ButtonEventBus.h"
+
+#define SIM_SLOTS 16
+#define SIM_DEFAULT_EVENTS 1000000
+#define SIM_DEFAULT_PRODUCERS 4
+#define SIM_MAX_PRODUCERS 64
+//Batch the consumer drains at once in the threaded run
+#define SIM_BATCH 8
+//Laps of the ring the single thread run goes through
+#define SIM_LAPS 100000
+
+typedef ButtonEventBus<SIM_SLOTS> SimBus;
+
+static uint32_t sim_seed = 1;
+
+static uint32_t sim_random(uint32_t range)
+{
+    sim_seed = sim_seed * 1103515245 + 12345;
+    return (sim_seed >> 8) % range;
+}
+
+//An event that tells its producer and position
+static ButtonEvent sim_event(uint16_t producer, uint32_t pos)
+{
+    return {pos, producer, (int16_t)(pos ^ producer)};
+}
+
+static bool sim_check(const char* what, bool ok)
+{
+    printf("%-36s %s\n", what, (ok) ? "ok" : "FAILED");
+    return ok;
+}
+
+static bool run_single()
+{
+    static SimBus bus;
+    ButtonEvent events[SIM_SLOTS];
+
+    bool ok = sim_check("empty", !bus.ready() && !bus.drain(events, SIM_SLOTS));
+    bool published = true;
+    for(uint32_t i = 0; i < SIM_SLOTS; i++) {
+        published &= bus.publish(sim_event(0, i));
+    }
+    ok &= sim_check("publish up to N", published && bus.ready());
+    ok &= sim_check("drop when full", !bus.publish(sim_event(0, SIM_SLOTS)) &&
+                    !bus.publish(sim_event(0, SIM_SLOTS)) &&
+                    bus.dropped() == 2);
+    ok &= sim_check("take_dropped", bus.take_dropped() == 2 && !bus.dropped());
+
+    size_t first = bus.drain(events, 3);
+    bool ordered = first == 3;
+    size_t rest = bus.drain(events + first, SIM_SLOTS);
+    ordered &= first + rest == SIM_SLOTS;
+    for(uint32_t i = 0; ordered && i < SIM_SLOTS; i++) {
+        ordered = events[i].timestamp == i;
+    }
+    ok &= sim_check("drain in order in batches", ordered);
+    ok &= sim_check("drained", !bus.ready() && !bus.drain(events, SIM_SLOTS));
+
+    //random bursts through many laps, against a model of the queue
+    std::deque<uint32_t> queue;
+    uint32_t next = 0;
+    uint32_t dropped = 0;
+    uint32_t mismatches = 0;
+    while(next < SIM_LAPS * SIM_SLOTS) {
+        uint32_t burst = sim_random(2 * SIM_SLOTS);
+        for(uint32_t i = 0; i < burst; i++) {
+            bool full = queue.size() == SIM_SLOTS;
+            mismatches += bus.publish(sim_event(0, next)) == full;
+            if(full) {
+                dropped++;
+            }
+            else {
+                queue.push_back(next);
+            }
+            next++;
+        }
+        mismatches += bus.ready() == queue.empty();
+        size_t count = bus.drain(events, sim_random(SIM_SLOTS + 1));
+        for(size_t i = 0; i < count; i++) {
+            mismatches += queue.empty() || events[i].timestamp != queue.front();
+            if(!queue.empty()) {
+                queue.pop_front();
+            }
+        }
+    }
+    mismatches += bus.dropped() != dropped;
+    printf("%lu events, dropped %lu\n", (unsigned long)next,
+            (unsigned long)dropped);
+    ok &= sim_check("laps", !mismatches && dropped > 0);
+    return ok;
+}
+
+static bool run_threads(uint32_t events, uint32_t producers)
+{
+    static SimBus bus;
+    std::vector<std::thread> threads;
+    std::vector<uint32_t> accepted(producers), received(producers);
+    std::vector<int64_t> last(producers, -1);
+    std::atomic<uint32_t> running(producers);
+    uint32_t duplicates = 0;
+    uint32_t misordered = 0;
+    uint32_t foreign = 0;
+
+    bus.take_dropped();
+    for(uint32_t p = 0; p < producers; p++) {
+        threads.emplace_back([&, p]() {
+            for(uint32_t i = 0; i < events; i++) {
+                if(bus.publish(sim_event(p, i))) {
+                    accepted[p]++;
+                }
+                else {
+                    //let the consumer run on single core hosts
+                    std::this_thread::yield();
+                }
+            }
+            running.fetch_sub(1, std::memory_order_release);
+        });
+    }
+
+    ButtonEvent batch[SIM_BATCH];
+    for(;;) {
+        bool done = !running.load(std::memory_order_acquire);
+        size_t count = bus.drain(batch, SIM_BATCH);
+        for(size_t i = 0; i < count; i++) {
+            uint16_t p = batch[i].button_id;
+            if(p >= producers ||
+                    batch[i].sequence != (int16_t)(batch[i].timestamp ^ p)) {
+                foreign++;
+                continue;
+            }
+            duplicates += batch[i].timestamp == last[p];
+            misordered += (int64_t)batch[i].timestamp < last[p];
+            last[p] = batch[i].timestamp;
+            received[p]++;
+        }
+        if(!count) {
+            if(done) {
+                break;
+            }
+            std::this_thread::yield();
+        }
+    }
+    for(auto& thread : threads) {
+        thread.join();
+    }
+
+    uint64_t total = 0;
+    uint32_t unaccounted = 0;
+    for(uint32_t p = 0; p < producers; p++) {
+        total += received[p];
+        unaccounted += received[p] != accepted[p];
+    }
+    uint64_t published = (uint64_t)events * producers;
+    printf("%llu events from %lu producers, received %llu, dropped %lu\n",
+            (unsigned long long)published, (unsigned long)producers,
+            (unsigned long long)total, (unsigned long)bus.dropped());
+    bool ok = sim_check("events whole", !foreign);
+    ok &= sim_check("producer order", !misordered);
+    ok &= sim_check("no duplicates", !duplicates);
+    ok &= sim_check("received what was accepted", !unaccounted);
+    ok &= sim_check("events accounted", total + bus.dropped() == published);
+    return ok;
+}
+
+int main(int argc, char** argv)
+{
+    uint32_t events = SIM_DEFAULT_EVENTS;
+    uint32_t producers = SIM_DEFAULT_PRODUCERS;
+
+    for(int i = 1; i < argc; i++) {
+        bool has_value = i + 1 < argc;
+        if(!strcmp(argv[i], "--events") && has_value) {
+            events = strtoul(argv[++i], NULL, 0);
+        }
+        else if(!strcmp(argv[i], "--producers") && has_value) {
+            producers = strtoul(argv[++i], NULL, 0);
+        }
+        else if(!strcmp(argv[i], "--seed") && has_value) {
+            sim_seed = strtoul(argv[++i], NULL, 0);
+        }
+        else {
+            fprintf(stderr, "usage: %s [--events n] [--producers n] "
+                "[--seed n]\n", argv[0]);
+            return 2;
+        }
+    }
+    if(!producers || producers > SIM_MAX_PRODUCERS) {
+        fprintf(stderr, "producers must be 1 to %d\n", SIM_MAX_PRODUCERS);
+        return 2;
+    }
+
+    bool ok = run_single();
+    ok &= run_threads(events, producers);
+    printf("%s\n", (ok) ? "ok" : "FAILED");
+    return (ok) ? 0 : 1;
+}
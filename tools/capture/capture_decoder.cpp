@@ -0,0 +1,186 @@
+/**
+ * @file capture_decoder.cpp
+ * @author Ed Ablan
+ * @version 1.0
+ * @date 10/17/2026
+ *
+ * @brief Decodes the channels of a capture with one ButtonSequence each
+ *
+ * @details Please read the header file for more details
+ *
+ * @copyright Copyright (c) 2020 Particle Industries, Inc.  All rights reserved.
+ */
+
+#include "capture_decoder.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+const char* const capture_usage =
+    "[--format vcd|csv] [--channel name[:high|:low]]... [--debounce ms] "
+    "[--long ms] [--majority window] [--tail ms] [--samplerate hz] "
+    "[--time-column name]";
+
+int capture_option(int argc, char** argv, int index, CaptureOptions& options)
+{
+    if(index + 1 >= argc) {
+        return 0;
+    }
+    const char* option = argv[index];
+    const char* value = argv[index + 1];
+
+    if(!strcmp(option, "--format")) {options.format = value;}
+    else if(!strcmp(option, "--channel")) {options.channels.push_back(value);}
+    else if(!strcmp(option, "--debounce")) {
+        options.debounce = strtoul(value, NULL, 0);
+    }
+    else if(!strcmp(option, "--long")) {
+        options.long_click = strtoul(value, NULL, 0);
+    }
+    else if(!strcmp(option, "--majority")) {
+        options.majority = strtoul(value, NULL, 0);
+    }
+    else if(!strcmp(option, "--tail")) {options.tail = strtoul(value, NULL, 0);}
+    else if(!strcmp(option, "--samplerate")) {
+        options.samplerate = strtoull(value, NULL, 0);
+    }
+    else if(!strcmp(option, "--time-column")) {options.time_column = value;}
+    else {
+        return 0;
+    }
+    return 2;
+}
+
+std::unique_ptr<CaptureParser> capture_parser(const CaptureOptions& options,
+                                                const std::string& path)
+{
+    std::string format = options.format;
+    if(format.empty()) {
+        size_t dot = path.rfind('.');
+        format = (dot != std::string::npos && path.substr(dot) == ".csv") ?
+                    "csv" : "vcd";
+    }
+    if(format == "csv") {
+        CsvParser* csv = new CsvParser();
+        if(options.samplerate) {csv->set_samplerate(options.samplerate);}
+        if(!options.time_column.empty()) {csv->time_column(options.time_column);}
+        return std::unique_ptr<CaptureParser>(csv);
+    }
+    return std::unique_ptr<CaptureParser>(new VcdParser());
+}
+
+//Splits name[:high|:low], active low when no level is given
+static bool is_active_low(const std::string& spec, std::string& name)
+{
+    size_t colon = spec.rfind(':');
+    if(colon != std::string::npos) {
+        std::string level = spec.substr(colon + 1);
+        if(level == "high" || level == "low") {
+            name = spec.substr(0, colon);
+            return level == "low";
+        }
+    }
+    name = spec;
+    return true;
+}
+
+CaptureDecoder::CaptureDecoder(const CaptureOptions& options)
+    : _options(options)
+    , _time(0)
+{}
+
+void CaptureDecoder::set_sequence_callback(
+        std::function<void(system_tick_t, const std::string&, int)> sequence_cb)
+{
+    _sequence_cb = sequence_cb;
+}
+
+bool CaptureDecoder::attach(const std::vector<std::string>& names,
+                            CaptureParser& parser)
+{
+    bool found = true;
+    std::vector<std::string> wanted = _options.channels;
+    if(wanted.empty()) {wanted = names;}
+    _channel_of.assign(names.size(), -1);
+
+    for(auto& spec : wanted) {
+        std::string name;
+        bool active_low = is_active_low(spec, name);
+        size_t column = 0;
+        while(column < names.size() && names[column] != name) {column++;}
+        if(column == names.size()) {
+            fprintf(stderr, "channel %s not in capture\n", name.c_str());
+            found = false;
+            continue;
+        }
+
+        Channel channel;
+        channel.name = name;
+        //until the capture shows a level the button is released
+        channel.level = active_low;
+        channel.time = _time;
+        channel.button.reset(new ButtonSequence(
+                    [active_low]() { return (int32_t)active_low; },
+                    active_low ? ActiveLevel::LOW : ActiveLevel::HIGH,
+                    _options.debounce, _options.long_click));
+        if(_options.majority) {
+            channel.button->set_majority_filter(_options.majority);
+        }
+        _channel_of[column] = _channels.size();
+        _channels.push_back(std::move(channel));
+    }
+    for(size_t column = 0; column < names.size(); column++) {
+        parser.select(column, _channel_of[column] >= 0);
+    }
+    return found;
+}
+
+void CaptureDecoder::advance(Channel& channel, system_tick_t now)
+{
+    ButtonEvent events[BUTTON_RUN_MAX_EVENTS];
+    size_t count = channel.button->feed_run(channel.level, now - channel.time,
+                                            events, BUTTON_RUN_MAX_EVENTS);
+    if(count > BUTTON_RUN_MAX_EVENTS) {count = BUTTON_RUN_MAX_EVENTS;}
+    for(size_t i = 0; _sequence_cb && i < count; i++) {
+        _sequence_cb(events[i].timestamp, channel.name, events[i].sequence);
+    }
+    channel.time = now;
+}
+
+void CaptureDecoder::advance_all(system_tick_t now)
+{
+    for(auto& channel : _channels) {
+        advance(channel, now);
+    }
+    _time = now;
+}
+
+void CaptureDecoder::edge(size_t column, uint64_t time_ns, bool level)
+{
+    int index = (column < _channel_of.size()) ? _channel_of[column] : -1;
+    if(index < 0) {
+        return;
+    }
+    system_tick_t now = time_ns / 1000000;
+    if(now != _time) {
+        advance_all(now);
+    }
+
+    Channel& channel = _channels[index];
+    int sequence = channel.button->check_button(level, now);
+    if(sequence && _sequence_cb) {
+        _sequence_cb(now, channel.name, sequence);
+    }
+    channel.level = level;
+}
+
+void CaptureDecoder::finish(uint64_t end_ns)
+{
+    advance_all(end_ns / 1000000 + _options.tail);
+}
+
+size_t CaptureDecoder::size()
+{
+    return _channels.size();
+}
@@ -0,0 +1,116 @@
+/**
+ * @file capture_decoder.h
+ * @author Ed Ablan
+ * @version 1.0
+ * @date 10/17/2026
+ *
+ * @brief Decodes the channels of a capture with one ButtonSequence each, and
+ * the command line options shared by the capture tools
+ *
+ * @details The level between two edges is passed with feed_run(), so the cost
+ * follows the number of edges rather than the length of the capture, and the
+ * result is the one check_button() would return polled every milli sec.
+ * Every channel is brought up to the time of an edge before it is applied,
+ * so the sequences of all channels are reported in time order
+ *
+ * @copyright Copyright (c) 2020 Particle Industries, Inc.  All rights reserved.
+ */
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "ButtonSequence.h"
+#include "capture_parser.h"
+
+//Milli secs the channels run after the last sample so pending sequences end
+#define CAPTURE_DEFAULT_TAIL_MS 1000
+
+struct CaptureOptions {
+    //name[:high|:low] of the channels to decode, all of them active low if
+    //empty
+    std::vector<std::string> channels;
+    system_tick_t debounce = DEFAULT_DEBOUNCE_MS;
+    system_tick_t long_click = DEFAULT_LONG_CLICK_MS;
+    uint8_t majority = 0;
+    system_tick_t tail = CAPTURE_DEFAULT_TAIL_MS;
+    //vcd or csv, from the file extension if empty
+    std::string format;
+    uint64_t samplerate = 0;
+    std::string time_column;
+};
+
+/**
+ * @brief Parses one of the decoder options at argv[index]
+ *
+ * @return number of arguments used, 0 if argv[index] is not a decoder option
+ */
+int capture_option(int argc, char** argv, int index, CaptureOptions& options);
+
+//Usage text of the decoder options
+extern const char* const capture_usage;
+
+/**
+ * @brief Creates the parser for a capture from its options and path
+ */
+std::unique_ptr<CaptureParser> capture_parser(const CaptureOptions& options,
+                                                const std::string& path);
+
+class CaptureDecoder {
+public:
+    CaptureDecoder(const CaptureOptions& options);
+
+    /**
+     * @brief Sets the callback called with the time, channel name and
+     * result of every decoded sequence
+     */
+    void set_sequence_callback(
+        std::function<void(system_tick_t, const std::string&, int)> sequence_cb);
+
+    /**
+     * @brief Creates the decoders of the channels in options, call from the
+     * header callback of the parser
+     *
+     * @param[in] names - channel names of the capture
+     * @param[in] parser - parser whose channels are selected
+     *
+     * @return false if a channel in options is not in the capture
+     */
+    bool attach(const std::vector<std::string>& names, CaptureParser& parser);
+
+    /**
+     * @brief Applies a level change, pass from the change callback of the
+     * parser
+     */
+    void edge(size_t column, uint64_t time_ns, bool level);
+
+    /**
+     * @brief Runs every channel up to the end of the capture plus the tail
+     *
+     * @param[in] end_ns - time of the last sample in nano secs
+     */
+    void finish(uint64_t end_ns);
+
+    //number of channels decoded
+    size_t size();
+
+private:
+    struct Channel {
+        std::string name;
+        std::unique_ptr<ButtonSequence> button;
+        bool level;
+        system_tick_t time;
+    };
+
+    void advance(Channel& channel, system_tick_t now);
+    void advance_all(system_tick_t now);
+
+    CaptureOptions _options;
+    std::function<void(system_tick_t, const std::string&, int)> _sequence_cb;
+    std::vector<Channel> _channels;
+    //channel of every capture column, -1 if not decoded
+    std::vector<int> _channel_of;
+    system_tick_t _time;
+};
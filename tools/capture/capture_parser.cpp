@@ -0,0 +1,474 @@
+/**
+ * @file capture_parser.cpp
+ * @author Ed Ablan
+ * @version 1.0
+ * @date 10/17/2026
+ *
+ * @brief Streaming parsers of logic analyzer captures
+ *
+ * @details Please read the header file for more details
+ *
+ * @copyright Copyright (c) 2020 Particle Industries, Inc.  All rights reserved.
+ */
+
+#include "capture_parser.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+
+//Blanks and control characters separate VCD tokens, one compare per byte
+static inline bool is_space(char c)
+{
+    return (uint8_t)c <= ' ';
+}
+
+static inline bool is_digit(char c)
+{
+    return c >= '0' && c <= '9';
+}
+
+static uint64_t power_of_ten(int exponent)
+{
+    uint64_t value = 1;
+    while(exponent-- > 0) {value *= 10;}
+    return value;
+}
+
+//Decimal seconds ("0.000125", "1.25e-4") to nano secs without a float round
+//trip, so sample times of long captures stay exact
+static bool parse_seconds(const char* begin, const char* end, uint64_t& nanos)
+{
+    uint64_t mantissa = 0;
+    int exponent = 9;
+    int digits = 0;
+    bool fraction = false;
+    const char* p = begin;
+
+    for(; p < end; p++) {
+        if(is_digit(*p)) {
+            //digits past what 64 bits hold only scale the value
+            if(digits < 19) {
+                mantissa = mantissa * 10 + (*p - '0');
+                digits += (mantissa != 0);
+                exponent -= fraction;
+            }
+            else if(!fraction) {
+                exponent++;
+            }
+        }
+        else if(*p == '.' && !fraction) {fraction = true;}
+        else {break;}
+    }
+    if(p == begin) {
+        return false;
+    }
+    if(p < end && (*p == 'e' || *p == 'E')) {
+        p++;
+        bool negative = (p < end && *p == '-');
+        if(p < end && (*p == '-' || *p == '+')) {p++;}
+        int value = 0;
+        for(; p < end && is_digit(*p); p++) {value = value * 10 + (*p - '0');}
+        exponent += negative ? -value : value;
+    }
+    if(p != end) {
+        return false;
+    }
+    nanos = (exponent >= 0) ? mantissa * power_of_ten(exponent) :
+                                mantissa / power_of_ten(-exponent);
+    return true;
+}
+
+void CaptureParser::set_header_callback(
+                std::function<void(const std::vector<std::string>&)> header_cb)
+{
+    _header_cb = header_cb;
+}
+
+void CaptureParser::set_change_callback(
+                std::function<void(size_t, uint64_t, bool)> change_cb)
+{
+    _change_cb = change_cb;
+}
+
+void CaptureParser::select(size_t channel, bool selected)
+{
+    if(channel < _selected.size()) {
+        _selected[channel] = selected;
+    }
+}
+
+bool CaptureParser::parse(int fd)
+{
+    //one more byte for the 0 that ends every chunk
+    std::vector<char> buffer(CAPTURE_BUFFER_SIZE + 1);
+    size_t len = 0;
+    bool eof = false;
+
+    (void)posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+    while(!eof) {
+        ssize_t count = read(fd, &buffer[len], CAPTURE_BUFFER_SIZE - len);
+        if(count < 0) {
+            if(errno == EINTR) {continue;}
+            return fail(strerror(errno));
+        }
+        eof = (count == 0);
+        _bytes += count;
+        len += count;
+        buffer[len] = 0;
+
+        ptrdiff_t used = consume(buffer.data(), buffer.data() + len, eof);
+        if(used < 0) {
+            return false;
+        }
+        memmove(buffer.data(), &buffer[used], len - used);
+        len -= used;
+        if(!eof && len == CAPTURE_BUFFER_SIZE) {
+            return fail("token or row longer than CAPTURE_BUFFER_SIZE");
+        }
+    }
+    if(_names.empty()) {
+        return fail("no channels found");
+    }
+    return true;
+}
+
+const std::vector<std::string>& CaptureParser::channels()
+{
+    return _names;
+}
+
+const std::string& CaptureParser::error()
+{
+    return _error;
+}
+
+uint64_t CaptureParser::bytes()
+{
+    return _bytes;
+}
+
+uint64_t CaptureParser::changes()
+{
+    return _changes;
+}
+
+uint64_t CaptureParser::end_time()
+{
+    return _end_time;
+}
+
+void CaptureParser::declare(std::vector<std::string> names)
+{
+    _names = names;
+    _levels.assign(names.size(), -1);
+    _selected.assign(names.size(), true);
+    if(_header_cb) {
+        _header_cb(_names);
+    }
+}
+
+bool CaptureParser::fail(const std::string& message)
+{
+    _error = message;
+    return false;
+}
+
+VcdParser::VcdParser()
+{
+    for(size_t i = 0; i < sizeof(_short_ids) / sizeof(_short_ids[0]); i++) {
+        _short_ids[i] = -1;
+    }
+}
+
+ptrdiff_t VcdParser::consume(const char* begin, const char* end, bool last)
+{
+    const char* p = begin;
+
+    for(;;) {
+        while(p < end && is_space(*p)) {p++;}
+        const char* token = p;
+        //the 0 after the chunk ends the last token
+        while(!is_space(*p)) {p++;}
+        //a token touching the end of the chunk may continue in the next one
+        if(token == p || (p == end && !last)) {
+            return token - begin;
+        }
+        size_t len = p - token;
+
+        switch(_state) {
+        case BODY:
+            switch(*token) {
+            case '#': {
+                uint64_t time = 0;
+                for(size_t i = 1; i < len; i++) {
+                    if(!is_digit(token[i])) {
+                        fail("bad timestamp");
+                        return -1;
+                    }
+                    time = time * 10 + (token[i] - '0');
+                }
+                _time = (_divide == 1) ? time * _multiply :
+                                            time * _multiply / _divide;
+                if(_time > _end_time) {_end_time = _time;}
+                break;
+            }
+            case '0':
+            case '1':
+                value(token + 1, len - 1, *token == '1');
+                break;
+            case 'x': case 'X': case 'z': case 'Z':
+                break;
+            case 'b': case 'B':
+                //only 1 bit vectors are channels, wider ones never match an id
+                _vector_level = (token[len - 1] == '1');
+                _state = VECTOR_ID;
+                break;
+            case 'r': case 'R':
+                _vector_level = -1;
+                _state = VECTOR_ID;
+                break;
+            case '$':
+                if(len == 8 && !memcmp(token, "$comment", 8)) {_state = SKIP;}
+                //$dumpvars, $dumpall, $dumpon, $dumpoff and their $end
+                break;
+            default:
+                fail("unexpected token " + std::string(token, len));
+                return -1;
+            }
+            break;
+
+        case VECTOR_ID:
+            if(_vector_level >= 0) {
+                value(token, len, _vector_level);
+            }
+            _state = BODY;
+            break;
+
+        case SKIP:
+            if(len == 4 && !memcmp(token, "$end", 4)) {_state = BODY;}
+            break;
+
+        case HEADER:
+            if(!header_token(std::string(token, len))) {
+                return -1;
+            }
+            break;
+        }
+    }
+}
+
+bool VcdParser::header_token(const std::string& token)
+{
+    if(_tokens.empty() && token[0] != '$') {
+        return fail("unexpected token " + token + " in header");
+    }
+    if(token != "$end") {
+        _tokens.push_back(token);
+        return true;
+    }
+    bool ok = declaration();
+    _tokens.clear();
+    return ok;
+}
+
+bool VcdParser::declaration()
+{
+    const std::string& keyword = _tokens[0];
+
+    if(keyword == "$timescale") {
+        std::string scale;
+        for(size_t i = 1; i < _tokens.size(); i++) {scale += _tokens[i];}
+        size_t unit = 0;
+        uint64_t number = 0;
+        for(; unit < scale.size() && is_digit(scale[unit]); unit++) {
+            number = number * 10 + (scale[unit] - '0');
+        }
+        static const struct {const char* unit; uint64_t multiply, divide;}
+        units[] = {
+            {"s", 1000000000, 1}, {"ms", 1000000, 1}, {"us", 1000, 1},
+            {"ns", 1, 1}, {"ps", 1, 1000}, {"fs", 1, 1000000},
+        };
+        for(auto& entry : units) {
+            if(number && scale.compare(unit, std::string::npos, entry.unit) == 0) {
+                _multiply = number * entry.multiply;
+                _divide = entry.divide;
+                //keep 10ps as 1/100 ns rather than 10/1000
+                while(_multiply % 10 == 0 && _divide % 10 == 0) {
+                    _multiply /= 10;
+                    _divide /= 10;
+                }
+                return true;
+            }
+        }
+        return fail("bad timescale " + scale);
+    }
+    if(keyword == "$var") {
+        //$var type width id reference [bit select] $end
+        if(_tokens.size() < 5) {
+            return fail("bad $var");
+        }
+        if(_tokens[2] != "1") {
+            return true;
+        }
+        const std::string& id = _tokens[3];
+        int32_t channel = _names.size();
+        if(id.size() == 1 && (uint8_t)id[0] < 128) {
+            if(_short_ids[(uint8_t)id[0]] >= 0) {return true;}
+            _short_ids[(uint8_t)id[0]] = channel;
+        }
+        else if(!_long_ids.emplace(id, channel).second) {
+            return true;
+        }
+        _names.push_back(_tokens[4]);
+        return true;
+    }
+    if(keyword == "$enddefinitions") {
+        declare(_names);
+        _state = BODY;
+        return true;
+    }
+    //$date, $version, $comment, $scope and $upscope carry nothing we use
+    return true;
+}
+
+void VcdParser::value(const char* id, size_t len, bool level)
+{
+    int32_t channel = -1;
+    if(len == 1) {
+        channel = _short_ids[(uint8_t)id[0] & 0x7F];
+    }
+    else {
+        auto entry = _long_ids.find(std::string(id, len));
+        if(entry != _long_ids.end()) {channel = entry->second;}
+    }
+    if(channel >= 0) {
+        change(channel, _time, level);
+    }
+}
+
+void CsvParser::time_column(const std::string& name)
+{
+    _time_name = name;
+}
+
+void CsvParser::set_samplerate(uint64_t hertz)
+{
+    _samplerate = hertz;
+}
+
+ptrdiff_t CsvParser::consume(const char* begin, const char* end, bool last)
+{
+    const char* p = begin;
+
+    for(;;) {
+        const char* line_end = (const char*)memchr(p, '\n', end - p);
+        if(!line_end) {
+            if(last && p < end) {
+                return row(p, end) ? end - begin : -1;
+            }
+            return p - begin;
+        }
+        if(!row(p, line_end)) {
+            return -1;
+        }
+        p = line_end + 1;
+    }
+}
+
+bool CsvParser::row(const char* begin, const char* end)
+{
+    if(end > begin && end[-1] == '\r') {end--;}
+    if(begin == end || *begin == ';') {
+        return true;
+    }
+
+    if(!_declared) {
+        char first = *begin;
+        bool named = !(is_digit(first) || first == '.' || first == '-');
+        if(!columns(begin, end, named)) {
+            return false;
+        }
+        if(named) {
+            return true;
+        }
+    }
+
+    uint64_t time;
+    if(_samplerate) {
+        //the sample period in whole nano secs and a remainder in 1/samplerate
+        //nano secs, exact without a division per row
+        time = _sample_time;
+        _sample_time += 1000000000ULL / _samplerate;
+        _sample_rest += 1000000000ULL % _samplerate;
+        if(_sample_rest >= _samplerate) {
+            _sample_rest -= _samplerate;
+            _sample_time++;
+        }
+    }
+    else {
+        const char* field = begin;
+        for(int32_t column = 0; column < _time_index && field; column++) {
+            field = (const char*)memchr(field, ',', end - field);
+            if(field) {field++;}
+        }
+        const char* field_end = field ?
+                        (const char*)memchr(field, ',', end - field) : NULL;
+        if(!field || !parse_seconds(field, field_end ? field_end : end, time)) {
+            return fail("bad time in row " + std::to_string(_row + 1));
+        }
+    }
+    _row++;
+    if(time > _end_time) {_end_time = time;}
+
+    const char* field = begin;
+    for(size_t column = 0; column < _column_channel.size() && field <= end;
+                                                                    column++) {
+        //fields are a character or two, a call to memchr() costs more
+        const char* field_end = field;
+        while(field_end < end && *field_end != ',') {field_end++;}
+        int32_t channel = _column_channel[column];
+        if(channel >= 0 && field_end - field == 1 &&
+                                        (*field == '0' || *field == '1')) {
+            change(channel, time, *field == '1');
+        }
+        field = field_end + 1;
+    }
+    return true;
+}
+
+bool CsvParser::columns(const char* begin, const char* end, bool named)
+{
+    std::vector<std::string> names;
+    _column_channel.clear();
+    _time_index = -1;
+
+    int32_t column = 0;
+    for(const char* field = begin; field <= end; column++) {
+        const char* field_end = (const char*)memchr(field, ',', end - field);
+        if(!field_end) {field_end = end;}
+        std::string name = named ? std::string(field, field_end) :
+                                    "col" + std::to_string(column);
+        while(!name.empty() && name[0] == ' ') {name.erase(0, 1);}
+
+        //without a header the first column is the time
+        bool is_time = !_samplerate && _time_index < 0 &&
+                        (named ? name == _time_name : column == 0);
+        if(is_time) {
+            _time_index = column;
+            _column_channel.push_back(-1);
+        }
+        else {
+            _column_channel.push_back(names.size());
+            names.push_back(name);
+        }
+        field = field_end + 1;
+    }
+    if(!_samplerate && _time_index < 0) {
+        return fail("no " + _time_name + " column, set a samplerate");
+    }
+    _declared = true;
+    declare(names);
+    return true;
+}
@@ -0,0 +1,171 @@
+/**
+ * @file capture_parser.h
+ * @author Ed Ablan
+ * @version 1.0
+ * @date 10/17/2026
+ *
+ * @brief Streaming parsers of logic analyzer captures (VCD and sigrok style
+ * CSV) for the host tools
+ *
+ * @details The file is read in CAPTURE_BUFFER_SIZE chunks and only the
+ * channel names and last levels are kept, so memory does not grow with the
+ * capture. The parsers report the channels found in the header, the caller
+ * selects the ones it wants with select(), and every level change of a
+ * selected channel is passed to the change callback with its time in nano
+ * secs. Value changes are scanned in place without copies or allocations
+ *
+ * VCD: 1 bit wires and 1 bit vectors, $timescale from s to fs, x and z
+ * values keep the previous level.
+ * CSV: one row per sample, ';' lines are comments, an optional header row
+ * names the columns. The time column (seconds, named "Time" or chosen with
+ * time_column()) gives the sample time, or set_samplerate() derives it from
+ * the row number. Any other column holding 0 or 1 is a channel
+ *
+ * @copyright Copyright (c) 2020 Particle Industries, Inc.  All rights reserved.
+ */
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+//Bytes read per chunk, also the longest token or CSV row accepted
+#ifndef CAPTURE_BUFFER_SIZE
+#define CAPTURE_BUFFER_SIZE (1 << 20)
+#endif
+
+class CaptureParser {
+public:
+    virtual ~CaptureParser() {}
+
+    /**
+     * @brief Sets the callback called once the channel names are known,
+     * before the first change. Channels can be selected from it
+     */
+    void set_header_callback(
+                std::function<void(const std::vector<std::string>&)> header_cb);
+
+    /**
+     * @brief Sets the callback called for every level change of a selected
+     * channel, in time order
+     */
+    void set_change_callback(
+                std::function<void(size_t, uint64_t, bool)> change_cb);
+
+    /**
+     * @brief Selects a channel for the change callback, all channels are
+     * selected by default
+     */
+    void select(size_t channel, bool selected);
+
+    /**
+     * @brief Parses a whole capture
+     *
+     * @param[in] fd - file descriptor to read until end of file
+     *
+     * @return true on success, false with error() set on a read or format
+     * error
+     */
+    bool parse(int fd);
+
+    const std::vector<std::string>& channels();
+    const std::string& error();
+    //bytes read, changes reported and time of the last sample in nano secs
+    uint64_t bytes();
+    uint64_t changes();
+    uint64_t end_time();
+
+protected:
+    /**
+     * @brief Consumes complete tokens or lines of a chunk
+     *
+     * @param[in] begin - first byte of the chunk
+     * @param[in] end - one past the last byte, always a readable 0
+     * @param[in] last - true if no more data follows
+     *
+     * @return bytes consumed, the rest is passed again with the next chunk,
+     * or -1 on a format error
+     */
+    virtual ptrdiff_t consume(const char* begin, const char* end, bool last) = 0;
+
+    //called by the parsers once the header is complete
+    void declare(std::vector<std::string> names);
+    //called by the parsers for every sampled level of a channel
+    inline void change(size_t channel, uint64_t time, bool level) {
+        if(channel >= _levels.size() || _levels[channel] == (int8_t)level) {
+            return;
+        }
+        _levels[channel] = level;
+        if(_selected[channel] && _change_cb) {
+            _changes++;
+            _change_cb(channel, time, level);
+        }
+    }
+    bool fail(const std::string& message);
+
+    uint64_t _end_time = 0;
+
+private:
+    std::function<void(const std::vector<std::string>&)> _header_cb;
+    std::function<void(size_t, uint64_t, bool)> _change_cb;
+    std::vector<std::string> _names;
+    std::vector<int8_t> _levels;
+    std::vector<bool> _selected;
+    std::string _error;
+    uint64_t _bytes = 0;
+    uint64_t _changes = 0;
+};
+
+class VcdParser : public CaptureParser {
+public:
+    VcdParser();
+
+protected:
+    ptrdiff_t consume(const char* begin, const char* end, bool last) override;
+
+private:
+    bool header_token(const std::string& token);
+    bool declaration();
+    void value(const char* id, size_t len, bool level);
+
+    enum State {HEADER, BODY, SKIP, VECTOR_ID};
+
+    State _state = HEADER;
+    std::vector<std::string> _tokens;
+    std::vector<std::string> _names;
+    int32_t _short_ids[128];
+    std::unordered_map<std::string, int32_t> _long_ids;
+    uint64_t _multiply = 1;
+    uint64_t _divide = 1;
+    uint64_t _time = 0;
+    int8_t _vector_level = -1;
+};
+
+class CsvParser : public CaptureParser {
+public:
+    //name of the time column, "Time" by default
+    void time_column(const std::string& name);
+    //derive sample times from the row number instead of a time column
+    void set_samplerate(uint64_t hertz);
+
+protected:
+    ptrdiff_t consume(const char* begin, const char* end, bool last) override;
+
+private:
+    bool row(const char* begin, const char* end);
+    bool columns(const char* begin, const char* end, bool named);
+
+    std::string _time_name = "Time";
+    uint64_t _samplerate = 0;
+    uint64_t _row = 0;
+    uint64_t _sample_time = 0;
+    uint64_t _sample_rest = 0;
+    bool _declared = false;
+    int32_t _time_index = -1;
+    //channel of every column, -1 for the time and unused columns
+    std::vector<int32_t> _column_channel;
+};
@@ -0,0 +1,101 @@
+/**
+ * @file capture_replay.cpp
+ * @author Ed Ablan
+ * @version 1.0
+ * @date 10/17/2026
+ *
+ * @brief Runs logic analyzer captures through ButtonSequence
+ *
+ * @details Streams a VCD or sigrok style CSV capture (see capture_parser.h),
+ * gives every selected channel its own ButtonSequence (see capture_decoder.h)
+ * and prints the decoded sequences as "time_ms,channel,sequence" rows in time
+ * order. After the last sample the channels run for --tail milli secs so
+ * pending sequences end. --stats prints the parse rate to stderr. Use - to
+ * read from stdin, e.g. zcat capture.vcd.gz | capture_replay --format vcd -
+ *
+ * Build from the repository root:
+ *  g++ -O2 -std=c++14 -Itools/host -Isrc tools/host/host.cpp src/Debounce.cpp
+ *      src/ButtonSequence.cpp tools/capture/capture_parser.cpp
+ *      tools/capture/capture_decoder.cpp tools/capture/capture_replay.cpp
+ *      -o capture_replay
+ *
+ * usage: capture_replay [--format vcd|csv] [--channel name[:high|:low]]...
+ *              [--debounce ms] [--long ms] [--majority window] [--tail ms]
+ *              [--samplerate hz] [--time-column name] [--stats] capture|-
+ *
+ * @copyright Copyright (c) 2020 Particle Industries, Inc.  All rights reserved.
+ */
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "capture_decoder.h"
+
+int main(int argc, char** argv)
+{
+    CaptureOptions options;
+    const char* path = NULL;
+    bool stats = false;
+
+    for(int i = 1; i < argc; i++) {
+        int used = capture_option(argc, argv, i, options);
+        if(used) {i += used - 1;}
+        else if(!strcmp(argv[i], "--stats")) {stats = true;}
+        else if(!path && (argv[i][0] != '-' || !strcmp(argv[i], "-"))) {
+            path = argv[i];
+        }
+        else {
+            path = NULL;
+            break;
+        }
+    }
+    if(!path) {
+        fprintf(stderr, "usage: %s %s [--stats] capture|-\n", argv[0],
+                capture_usage);
+        return 2;
+    }
+
+    std::unique_ptr<CaptureParser> parser = capture_parser(options, path);
+    CaptureDecoder decoder(options);
+    bool found = true;
+    decoder.set_sequence_callback(
+            [](system_tick_t time, const std::string& name, int sequence) {
+        printf("%u,%s,%d\n", (unsigned)time, name.c_str(), sequence);
+    });
+    parser->set_header_callback([&](const std::vector<std::string>& names) {
+        found = decoder.attach(names, *parser);
+    });
+    parser->set_change_callback([&](size_t column, uint64_t time, bool level) {
+        decoder.edge(column, time, level);
+    });
+
+    int fd = strcmp(path, "-") ? open(path, O_RDONLY) : STDIN_FILENO;
+    if(fd < 0) {
+        perror(path);
+        return 1;
+    }
+
+    struct timespec start, stop;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    bool ok = parser->parse(fd);
+    clock_gettime(CLOCK_MONOTONIC, &stop);
+    if(!ok) {
+        fprintf(stderr, "%s: %s\n", path, parser->error().c_str());
+        return 1;
+    }
+    decoder.finish(parser->end_time());
+    fflush(stdout);
+
+    if(stats) {
+        double seconds = (stop.tv_sec - start.tv_sec) +
+                            (stop.tv_nsec - start.tv_nsec) / 1e9;
+        fprintf(stderr, "%llu bytes, %llu changes, %.3f s, %.1f MB/s\n",
+                (unsigned long long)parser->bytes(),
+                (unsigned long long)parser->changes(), seconds,
+                parser->bytes() / seconds / 1e6);
+    }
+    return found ? 0 : 1;
+}
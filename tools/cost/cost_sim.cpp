@@ -0,0 +1,193 @@
+/**
+ * @file cost_sim.cpp
+ * @author Ed Ablan
+ * @version 1.0
+ * @date 10/17/2026
+ *
+ * @brief Counts the work of one button under the loop polled, fixed rate and
+ * interrupt driven configurations on the host
+ *
+ * @details The same hour of presses (gestures per hour, each click with
+ * contact bounce) is played on a fake pin three times: checked every loop
+ * (--loop-us), checked by a timer every --rate-ms, and checked on every pin
+ * edge plus at next_deadline(). Each run prints the COST line of
+ * button_cost_print(), pipe the output to tools/cost_model.py for the active
+ * time per hour of each configuration. The configurations must decode the
+ * same sequences, the count is printed to stderr.
+ *
+ * Build from the repository root:
+ *  g++ -O2 -std=c++14 -DBUTTON_COST_ENABLE -Itools/host -Isrc
+ *      tools/host/host.cpp src/Debounce.cpp src/ButtonSequence.cpp
+ *      src/ButtonCost.cpp src/ButtonPrint.cpp tools/cost/cost_sim.cpp
+ *      -o cost_sim
+ *
+ * usage: cost_sim [--gestures per_hour] [--loop-us us] [--rate-ms ms]
+ *              | tools/cost_model.py
+ *
+ * @copyright Copyright (c) 2020 Particle Industries, Inc.  All rights reserved.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <vector>
+
+#include "ButtonSequence.h"
+#include "ButtonCost.h"
+
+#define SIM_PIN 1
+#define SIM_HOUR_US 3600000000ULL
+#define SIM_DEFAULT_GESTURES 60
+#define SIM_DEFAULT_LOOP_US 1000
+#define SIM_DEFAULT_RATE_MS 10
+
+struct SimEdge {
+    uint64_t time;
+    bool level;
+};
+
+class StdoutPrint : public Print {
+public:
+    size_t write(uint8_t c) override {
+        return fputc(c, stdout) == EOF ? 0 : 1;
+    }
+};
+
+static uint32_t sim_seed = 1;
+
+static uint32_t sim_random(uint32_t range)
+{
+    sim_seed = sim_seed * 1103515245 + 12345;
+    return (sim_seed >> 8) % range;
+}
+
+//An active low button: gestures of 1 to 3 clicks or a long press spread over
+//the hour, every edge chatters 0 to 4 times over a few milli secs
+static std::vector<SimEdge> sim_pattern(uint32_t gestures)
+{
+    std::vector<SimEdge> edges;
+    uint64_t spacing = SIM_HOUR_US / (gestures + 1);
+    auto settle = [&](uint64_t t, bool level) {
+        uint32_t bounces = sim_random(5);
+        for(uint32_t b = 0; b < bounces; b++) {
+            edges.push_back({t, (b & 1) ? !level : level});
+            t += 200 + sim_random(800);
+        }
+        edges.push_back({t, level});
+    };
+
+    for(uint32_t g = 0; g < gestures; g++) {
+        uint64_t t = spacing * (g + 1);
+        bool long_press = sim_random(4) == 0;
+        uint32_t clicks = long_press ? 1 : 1 + sim_random(3);
+        for(uint32_t c = 0; c < clicks; c++) {
+            settle(t, false);
+            t += long_press ? 6000000 : 100000 + sim_random(150000);
+            settle(t, true);
+            t += 150000 + sim_random(150000);
+        }
+    }
+    return edges;
+}
+
+//Checks the button every period micro secs, the loop and fixed rate runs
+static int run_periodic(const std::vector<SimEdge>& edges, uint64_t period,
+                        ButtonCost& cost)
+{
+    host_set_micros(0);
+    host_set_pin(SIM_PIN, 1);
+    ButtonSequence button(SIM_PIN, INPUT, ActiveLevel::LOW);
+    size_t next = 0;
+    int sequences = 0;
+
+    for(uint64_t now = 0; now < SIM_HOUR_US; now += period) {
+        for(; next < edges.size() && edges[next].time <= now; next++) {
+            host_set_pin(SIM_PIN, edges[next].level);
+        }
+        host_set_micros(now);
+        sequences += button.check_button() != 0;
+    }
+    host_set_micros(SIM_HOUR_US);
+    cost = button.cost();
+    return sequences;
+}
+
+//Checks the button on every edge and at its deadlines only
+static int run_interrupt(const std::vector<SimEdge>& edges, ButtonCost& cost)
+{
+    host_set_micros(0);
+    host_set_pin(SIM_PIN, 1);
+    ButtonSequence button(SIM_PIN, INPUT, ActiveLevel::LOW);
+    size_t next = 0;
+    int sequences = 0;
+    uint64_t last = 0;
+
+    for(;;) {
+        uint64_t now = SIM_HOUR_US;
+        system_tick_t deadline;
+        if(button.next_deadline(deadline)) {
+            now = (uint64_t)deadline * 1000;
+            //a deadline in the milli sec already checked waits for the next
+            if(now <= last) {now = last + 1000;}
+        }
+        bool edge = next < edges.size() && edges[next].time < now;
+        if(edge) {now = edges[next].time;}
+        if(now >= SIM_HOUR_US) {break;}
+
+        host_set_micros(now);
+        last = now;
+        if(edge) {host_set_pin(SIM_PIN, edges[next++].level);}
+        sequences += button.check_button() != 0;
+    }
+    host_set_micros(SIM_HOUR_US);
+    cost = button.cost();
+    return sequences;
+}
+
+int main(int argc, char** argv)
+{
+    uint32_t gestures = SIM_DEFAULT_GESTURES;
+    uint64_t loop_us = SIM_DEFAULT_LOOP_US;
+    uint64_t rate_ms = SIM_DEFAULT_RATE_MS;
+
+    for(int i = 1; i < argc; i++) {
+        bool has_value = i + 1 < argc;
+        if(!strcmp(argv[i], "--gestures") && has_value) {
+            gestures = strtoul(argv[++i], NULL, 0);
+        }
+        else if(!strcmp(argv[i], "--loop-us") && has_value) {
+            loop_us = strtoull(argv[++i], NULL, 0);
+        }
+        else if(!strcmp(argv[i], "--rate-ms") && has_value) {
+            rate_ms = strtoull(argv[++i], NULL, 0);
+        }
+        else {
+            fprintf(stderr, "usage: %s [--gestures per_hour] [--loop-us us] "
+                "[--rate-ms ms]\n", argv[0]);
+            return 2;
+        }
+    }
+    if(!loop_us || !rate_ms) {
+        fprintf(stderr, "periods must be at least 1\n");
+        return 2;
+    }
+
+    std::vector<SimEdge> edges = sim_pattern(gestures);
+    StdoutPrint out;
+    ButtonCost cost;
+    int decoded;
+
+    decoded = run_periodic(edges, loop_us, cost);
+    button_cost_print(out, "loop", ButtonCostMode::LOOP, cost);
+    fprintf(stderr, "loop: %d sequences\n", decoded);
+
+    decoded = run_periodic(edges, rate_ms * 1000, cost);
+    button_cost_print(out, "fixed_rate", ButtonCostMode::FIXED_RATE, cost);
+    fprintf(stderr, "fixed_rate: %d sequences\n", decoded);
+
+    decoded = run_interrupt(edges, cost);
+    button_cost_print(out, "interrupt", ButtonCostMode::INTERRUPT, cost);
+    fprintf(stderr, "interrupt: %d sequences\n", decoded);
+    return 0;
+}
@@ -0,0 +1,120 @@
+#!/usr/bin/env python3
+"""
+Estimate the active CPU time per hour of button configurations from the
+COST lines printed by button_cost_print() (src/ButtonCost.h).
+
+Every counter is multiplied by the cost of one operation in micro seconds and
+scaled to one hour of the measured interval. What wakes the CPU depends on
+the mode of the line:
+
+  loop       the buttons ride on loop(), the CPU is awake anyway
+  fixed      every poll is a timer wakeup from sleep
+  interrupt  every poll is a wakeup (pin interrupt or next_deadline() timer)
+             and every raw edge enters the pin interrupt
+
+The default costs are rough figures for a Cortex-M device at around 100 MHz
+running Device OS; measure the real ones on the target (e.g. toggle a pin
+around 10000 calls) and pass them with --cost name=us. With --active-ma the
+charge spent awake is also printed.
+
+The input can be a raw serial log, lines that are not COST lines are skipped.
+
+usage: cost_model.py [log file] [--cost name=us]... [--active-ma mA]
+"""
+
+import sys
+
+# micro seconds per operation, see --cost
+DEFAULT_COSTS = {
+    "poll": 0.6,        # check_button() without reads or transitions
+    "read": 0.5,        # digitalRead() through the HAL, or a read callback
+    "clock": 0.15,      # millis()
+    "transition": 0.3,  # debounced change or sequence state change
+    "isr": 1.5,         # pin interrupt entry, dispatch and exit
+    "wakeup": 60.0,     # leave and re-enter sleep, clocks restored
+}
+
+HOUR_MS = 3600000.0
+
+
+def parse_line(line):
+    """COST label mode elapsed_ms polls reads clock_reads edges transitions"""
+    fields = line.split()
+    if len(fields) != 9 or fields[0] != "COST":
+        return None
+    try:
+        counts = [int(f) for f in fields[3:]]
+    except ValueError:
+        return None
+    keys = ("elapsed_ms", "polls", "reads", "clock_reads", "edges",
+            "transitions")
+    record = dict(zip(keys, counts))
+    record["label"] = fields[1]
+    record["mode"] = fields[2]
+    return record
+
+
+def estimate(record, costs):
+    """Active micro seconds per hour of each kind of work"""
+    scale = HOUR_MS / record["elapsed_ms"] if record["elapsed_ms"] else 0.0
+    work = {
+        "poll": record["polls"] * costs["poll"],
+        "read": record["reads"] * costs["read"],
+        "clock": record["clock_reads"] * costs["clock"],
+        "transition": record["transitions"] * costs["transition"],
+        "isr": 0.0,
+        "wakeup": 0.0,
+    }
+    wakeups = 0
+    if record["mode"] in ("fixed", "interrupt"):
+        wakeups = record["polls"]
+    if record["mode"] == "interrupt":
+        work["isr"] = record["edges"] * costs["isr"]
+    work["wakeup"] = wakeups * costs["wakeup"]
+    return {k: v * scale for k, v in work.items()}, wakeups * scale
+
+
+def main(argv):
+    costs = dict(DEFAULT_COSTS)
+    active_ma = None
+    path = None
+
+    args = iter(argv[1:])
+    for arg in args:
+        if arg == "--cost":
+            name, _, value = next(args, "").partition("=")
+            if name not in costs:
+                sys.exit("unknown cost %s, one of %s" % (name, ", ".join(costs)))
+            costs[name] = float(value)
+        elif arg == "--active-ma":
+            active_ma = float(next(args, "0"))
+        elif path is None and not arg.startswith("--"):
+            path = arg
+        else:
+            sys.exit(__doc__.strip())
+
+    stream = open(path) if path else sys.stdin
+    records = [r for r in (parse_line(line) for line in stream) if r]
+    if not records:
+        sys.exit("no COST lines found")
+
+    header = "%-16s %-9s %12s %10s %12s" % ("config", "mode", "active ms/h",
+                                             "duty %", "wakeups/h")
+    if active_ma is not None:
+        header += " %10s" % "mAh/h"
+    print(header + "  breakdown ms/h")
+    for record in records:
+        work, wakeups = estimate(record, costs)
+        total_ms = sum(work.values()) / 1000.0
+        line = "%-16s %-9s %12.2f %10.4f %12.0f" % (
+            record["label"], record["mode"], total_ms,
+            total_ms * 100.0 / HOUR_MS, wakeups)
+        if active_ma is not None:
+            line += " %10.5f" % (active_ma * total_ms / HOUR_MS)
+        breakdown = " ".join("%s=%.2f" % (k, v / 1000.0)
+                             for k, v in work.items() if v)
+        print(line + "  " + breakdown)
+
+
+if __name__ == "__main__":
+    main(sys.argv)
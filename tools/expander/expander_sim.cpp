@@ -0,0 +1,387 @@
+/**
+ * @file expander_sim.cpp
+ * @author Ed Ablan
+ * @version 1.0
+ * @date 10/17/2026
+ *
+ * @brief Runs button banks behind fake input chips on the host and checks
+ * them against one ButtonSequence per button
+ *
+ * @details Random gestures with contact bounce are played on 16 buttons for
+ * --seconds. The inputs are read every --poll-ms through a fake 74HC165 
+ * chain, with ShiftRegisterSpi alone and on a bus shared with a mode 0
+ * device, with ShiftRegisterBitBang, and through a fake MCP23017, gated by its INT pin and polled without it, and decoded by
+ * a ButtonBank. The same levels are decoded by 16 independent 
+ * ButtonSequence instances as the reference; every run must decode the same
+ * sequences at the same times. Prints the sequences, the chain transactions
+ * and the button checks of each run (counted with BUTTON_COST_ENABLE).
+ *
+ * Then SIM_GROUPS expanders with their own patterns share a bus scanned by a
+ * ScanScheduler with --budget transactions per second, the last one gated by
+ * INT; the scheduler report is printed and every group must decode the
+ * sequences of its reference, later but in the same order. A budget below
+ * what the polled groups use while active, 3 x 4 scans per 50 ms or about
+ * 240, delays scans past the active interval and short presses are lost, so
+ * those runs mismatch. Exits with 1 on a mismatch.
+ *
+ * Build from the repository root:
+ *  g++ -O2 -std=c++14 -DBUTTON_COST_ENABLE -Itools/host -Isrc
+ *      tools/host/host.cpp src/Debounce.cpp src/DebounceBank.cpp src/ButtonSequence.cpp
+ *      src/ShiftRegisterInput.cpp src/Mcp23017Input.cpp 
+ *      src/ScanScheduler.cpp src/ButtonPrint.cpp
+ *      tools/expander/expander_sim.cpp -o expander_sim
+ *
+ * usage: expander_sim [--seconds s] [--poll-ms ms] [--budget per_second]
+ *                     [--seed n]
+ *
+ * @copyright Copyright (c) 2020 Particle Industries, Inc.  All rights reserved.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "ButtonBank.h"
+#include "ShiftRegisterInput.h"
+#include "Mcp23017Input.h"
+#include "ScanScheduler.h"
+#include "fake_hc165.h"
+#include "fake_mcp23017.h"
+
+#define SIM_BUTTONS 16
+#define SIM_LOAD_PIN 1
+#define SIM_CLOCK_PIN 2
+#define SIM_DATA_PIN 3
+#define SIM_INT_PIN 4
+//Clock of the mode 0 device sharing the bus of the chain
+#define SIM_SHARED_HZ (8 * MHZ)
+#define SIM_DEFAULT_SECONDS 120
+#define SIM_DEFAULT_POLL_MS 1
+#define SIM_DEFAULT_BUDGET 400
+//Time played after the last gesture starts, so every sequence terminates
+#define SIM_TAIL_MS 10000
+//Expanders sharing the bus in the scheduled run, the last one with INT
+#define SIM_GROUPS 4
+
+struct SimEdge {
+    uint32_t time;      //milli secs
+    uint8_t button;
+    bool level;
+};
+
+class StdoutPrint : public Print {
+public:
+    size_t write(uint8_t c) override {
+        return fputc(c, stdout) == EOF ? 0 : 1;
+    }
+};
+
+//The chain on a bus shared with a mode 0 device that is used between reads
+struct SimSharedSpi {
+    ShiftRegisterSpi& spi;
+
+    void begin() {
+        spi.begin();
+    }
+    uint32_t read() {
+        SPI.beginTransaction(SPISettings(SIM_SHARED_HZ, MSBFIRST, SPI_MODE0));
+        SPI.endTransaction();
+        return spi.read();
+    }
+    uint32_t transactions() const {
+        return spi.transactions();
+    }
+};
+
+struct SimResult {
+    std::vector<std::string> sequences;
+    uint32_t transactions;
+    uint32_t checks;
+};
+
+static uint32_t sim_seed = 1;
+
+static uint32_t sim_random(uint32_t range)
+{
+    sim_seed = sim_seed * 1103515245 + 12345;
+    return (sim_seed >> 8) % range;
+}
+
+//Active low buttons: gestures of 1 to 3 clicks or a long press at random 
+//times, every edge chatters 0 to 4 times over a few milli secs
+static std::vector<SimEdge> sim_pattern(uint32_t seconds)
+{
+    std::vector<SimEdge> edges;
+    for(uint8_t b = 0; b < SIM_BUTTONS; b++) {
+        uint32_t t = 100 + sim_random(3000);
+        auto settle = [&](bool level) {
+            uint32_t bounces = sim_random(5);
+            for(uint32_t i = 0; i < bounces; i++) {
+                edges.push_back({t, b, (i & 1) ? !level : level});
+                t += 1 + sim_random(3);
+            }
+            edges.push_back({t, b, level});
+        };
+        while(t < seconds * 1000) {
+            bool long_press = sim_random(4) == 0;
+            uint32_t clicks = long_press ? 1 : 1 + sim_random(3);
+            for(uint32_t c = 0; c < clicks; c++) {
+                settle(false);
+                //the shortest tap a scheduled group is sure to see
+                t += long_press ? 5500 + sim_random(1000) : 
+                                    100 + sim_random(130);
+                settle(true);
+                t += 150 + sim_random(200);
+            }
+            t += 1000 + sim_random(8000);
+        }
+    }
+    std::stable_sort(edges.begin(), edges.end(), 
+        [](const SimEdge& a, const SimEdge& b) {return a.time < b.time;});
+    return edges;
+}
+
+static std::string sim_format(uint32_t time, size_t button, int sequence)
+{
+    char line[48];
+    snprintf(line, sizeof(line), "%lu %u %d", (unsigned long)time, 
+                (unsigned)button, sequence);
+    return line;
+}
+
+//Plays the pattern and calls poll(levels, now) every poll_ms
+template <typename F>
+static void sim_play(const std::vector<SimEdge>& edges, uint32_t seconds,
+                    uint32_t poll_ms, F&& poll)
+{
+    uint32_t levels = (1UL << SIM_BUTTONS) - 1;
+    size_t next = 0;
+    for(uint32_t now = 0; now < seconds * 1000 + SIM_TAIL_MS; now += poll_ms) {
+        for(; next < edges.size() && edges[next].time <= now; next++) {
+            uint32_t bit = 1UL << edges[next].button;
+            levels = (edges[next].level) ? (levels | bit) : (levels & ~bit);
+        }
+        host_set_micros((uint64_t)now * 1000);
+        poll(levels, now);
+    }
+}
+
+static SimResult run_reference(const std::vector<SimEdge>& edges, 
+                                uint32_t seconds, uint32_t poll_ms)
+{
+    SimResult result = {};
+    host_set_micros(0);
+    std::vector<ButtonSequence> buttons;
+    buttons.reserve(SIM_BUTTONS);
+    for(int b = 0; b < SIM_BUTTONS; b++) {
+        buttons.emplace_back([]{return 1;}, ActiveLevel::LOW);
+    }
+    sim_play(edges, seconds, poll_ms, [&](uint32_t levels, uint32_t now) {
+        for(size_t b = 0; b < SIM_BUTTONS; b++) {
+            int sequence = buttons[b].check_button((levels >> b) & 1, now);
+            result.checks++;
+            if(sequence) {
+                result.sequences.push_back(sim_format(now, b, sequence));
+            }
+        }
+    });
+    return result;
+}
+
+//Runs a bank behind an input with begin(), read() and transactions(), the
+//levels of the pattern are given to the fake chip with set_inputs()
+template <typename Input, typename Fake>
+static SimResult run_bank(Input& input, Fake& fake,
+                            const std::vector<SimEdge>& edges, 
+                            uint32_t seconds, uint32_t poll_ms)
+{
+    SimResult result = {};
+    ButtonBank<SIM_BUTTONS> bank(ActiveLevel::LOW);
+
+    host_set_micros(0);
+    fake.set_inputs((1UL << SIM_BUTTONS) - 1);
+    input.begin();
+    bank.begin(input.read());
+    sim_play(edges, seconds, poll_ms, [&](uint32_t levels, uint32_t now) {
+        fake.set_inputs(levels);
+        bank.update(input.read(), now, [&](size_t index, int sequence) {
+            result.sequences.push_back(sim_format(now, index, sequence));
+        });
+        for(size_t b = 0; b < SIM_BUTTONS; b++) {
+            result.checks += bank.at(b)->cost().polls;
+            bank.at(b)->reset_cost();
+        }
+    });
+    result.transactions = input.transactions();
+    return result;
+}
+
+static bool sim_report(const char* name, const SimResult& result,
+                        const SimResult& reference)
+{
+    bool match = result.sequences == reference.sequences;
+    printf("%-10s %10zu %14lu %12lu  %s\n", name, result.sequences.size(),
+            (unsigned long)result.transactions, (unsigned long)result.checks,
+            (match) ? "ok" : "MISMATCH");
+    return match;
+}
+
+//The sequences of a run without their times in button order, a scheduled
+//scan decodes the same sequences of each button later, so sequences of
+//different buttons may swap
+static std::vector<std::string> sim_untimed(
+                                    const std::vector<std::string>& sequences)
+{
+    std::vector<std::string> untimed;
+    for(const std::string& line : sequences) {
+        untimed.push_back(line.substr(line.find(' ') + 1));
+    }
+    std::stable_sort(untimed.begin(), untimed.end(),
+        [](const std::string& a, const std::string& b) {
+            return atoi(a.c_str()) < atoi(b.c_str());
+        });
+    return untimed;
+}
+
+struct SimGroup {
+    SimGroup(uint8_t address, pin_t int_pin)
+        : fake(address, int_pin), input(fake, address, int_pin),
+          bank(ActiveLevel::LOW), 
+          group(input, bank, [this](size_t index, int sequence) {
+              sequences.push_back(sim_format(millis(), index, sequence));
+          }) {}
+
+    FakeMcp23017 fake;
+    Mcp23017Input input;
+    ButtonBank<SIM_BUTTONS> bank;
+    BankScanGroup<SIM_BUTTONS, Mcp23017Input> group;
+    std::vector<SimEdge> edges;
+    std::vector<std::string> sequences;
+};
+
+//SIM_GROUPS expanders on one bus scanned by a ScanScheduler, each with its
+//own pattern, checked against the reference of the pattern
+static bool run_scheduled(uint32_t budget, uint32_t seconds)
+{
+    std::vector<std::unique_ptr<SimGroup>> groups;
+    std::vector<SimResult> references;
+    StdoutPrint out;
+    bool ok = true;
+
+    host_set_micros(0);
+    for(int g = 0; g < SIM_GROUPS; g++) {
+        pin_t int_pin = (g == SIM_GROUPS - 1) ? SIM_INT_PIN : 
+                                                MCP23017_NO_INT_PIN;
+        groups.emplace_back(new SimGroup(MCP23017_ADDRESS + g, int_pin));
+        groups[g]->edges = sim_pattern(seconds);
+        references.push_back(run_reference(groups[g]->edges, seconds, 1));
+    }
+    host_set_micros(0);
+    ScanScheduler scheduler(budget);
+    for(auto& group : groups) {
+        group->fake.set_inputs((1UL << SIM_BUTTONS) - 1);
+        group->input.begin();
+        group->bank.begin(group->input.read());
+        scheduler.add(&group->group);
+    }
+
+    std::vector<size_t> next(SIM_GROUPS, 0);
+    std::vector<uint32_t> levels(SIM_GROUPS, (1UL << SIM_BUTTONS) - 1);
+    for(uint32_t now = 0; now < seconds * 1000 + SIM_TAIL_MS; now++) {
+        host_set_micros((uint64_t)now * 1000);
+        for(int g = 0; g < SIM_GROUPS; g++) {
+            const std::vector<SimEdge>& edges = groups[g]->edges;
+            for(; next[g] < edges.size() && edges[next[g]].time <= now; 
+                    next[g]++) {
+                uint32_t bit = 1UL << edges[next[g]].button;
+                levels[g] = (edges[next[g]].level) ? (levels[g] | bit) : 
+                                                    (levels[g] & ~bit);
+            }
+            groups[g]->fake.set_inputs(levels[g]);
+        }
+        scheduler.run(now);
+    }
+
+    printf("\nscheduled, budget %lu transactions/s\n", (unsigned long)budget);
+    scheduler.print(out);
+    for(int g = 0; g < SIM_GROUPS; g++) {
+        bool match = sim_untimed(groups[g]->sequences) == 
+                        sim_untimed(references[g].sequences);
+        printf("group %d: %zu sequences %s\n", g, groups[g]->sequences.size(),
+                (match) ? "ok" : "MISMATCH");
+        ok &= match;
+    }
+    return ok;
+}
+
+int main(int argc, char** argv)
+{
+    uint32_t seconds = SIM_DEFAULT_SECONDS;
+    uint32_t poll_ms = SIM_DEFAULT_POLL_MS;
+    uint32_t budget = SIM_DEFAULT_BUDGET;
+
+    for(int i = 1; i < argc; i++) {
+        bool has_value = i + 1 < argc;
+        if(!strcmp(argv[i], "--seconds") && has_value) {
+            seconds = strtoul(argv[++i], NULL, 0);
+        }
+        else if(!strcmp(argv[i], "--poll-ms") && has_value) {
+            poll_ms = strtoul(argv[++i], NULL, 0);
+        }
+        else if(!strcmp(argv[i], "--budget") && has_value) {
+            budget = strtoul(argv[++i], NULL, 0);
+        }
+        else if(!strcmp(argv[i], "--seed") && has_value) {
+            sim_seed = strtoul(argv[++i], NULL, 0);
+        }
+        else {
+            fprintf(stderr, "usage: %s [--seconds s] [--poll-ms ms] "
+                "[--budget per_second] [--seed n]\n", argv[0]);
+            return 2;
+        }
+    }
+    if(!poll_ms) {
+        fprintf(stderr, "the poll period must be at least 1\n");
+        return 2;
+    }
+
+    std::vector<SimEdge> edges = sim_pattern(seconds);
+    SimResult reference = run_reference(edges, seconds, poll_ms);
+    bool ok = true;
+
+    printf("%-10s %10s %14s %12s\n", "run", "sequences", "transactions",
+            "checks");
+    sim_report("reference", reference, reference);
+
+    {
+        FakeHc165 fake(SIM_LOAD_PIN, SIM_CLOCK_PIN, SIM_DATA_PIN, SIM_BUTTONS);
+        ShiftRegisterSpi spi(SPI, SIM_LOAD_PIN, SIM_BUTTONS);
+        ok &= sim_report("spi", run_bank(spi, fake, edges, seconds, poll_ms),
+                            reference);
+        SimSharedSpi shared = {spi};
+        ok &= sim_report("spi_shared",
+                        run_bank(shared, fake, edges, seconds, poll_ms),
+                        reference);
+        ShiftRegisterBitBang bitbang(SIM_LOAD_PIN, SIM_CLOCK_PIN, SIM_DATA_PIN,
+                                    SIM_BUTTONS);
+        ok &= sim_report("bitbang", 
+                        run_bank(bitbang, fake, edges, seconds, poll_ms),
+                        reference);
+    }
+    {
+        FakeMcp23017 fake(MCP23017_ADDRESS, SIM_INT_PIN);
+        Mcp23017Input mcp(fake, MCP23017_ADDRESS, SIM_INT_PIN);
+        ok &= sim_report("mcp_int", run_bank(mcp, fake, edges, seconds, 
+                                                poll_ms), reference);
+        Mcp23017Input polled(fake, MCP23017_ADDRESS);
+        ok &= sim_report("mcp_polled", run_bank(polled, fake, edges, seconds,
+                                                poll_ms), reference);
+    }
+    ok &= run_scheduled(budget, seconds);
+    return (ok) ? 0 : 1;
+}
@@ -0,0 +1,110 @@
+/**
+ * @file fake_hc165.h
+ * @author Ed Ablan
+ * @version 1.0
+ * @date 10/17/2026
+ *
+ * @brief Host fake of a chain of 74HC165 shift registers
+ *
+ * @details The chain answers the pin writes of ShiftRegisterBitBang and the
+ * SPI transfers of ShiftRegisterSpi through the hooks of the host shim
+ * (tools/host/Particle.h). A low level on the load pin latches the inputs,
+ * the data pin then holds D7 of register 0 and every rising clock edge
+ * shifts the next bit out, including SCK rising to its idle level when a
+ * transaction switches the bus from mode 0 to mode 2. Only one fake can be
+ * attached at a time
+ *
+ * @copyright Copyright (c) 2020 Particle Industries, Inc.  All rights reserved.
+ */
+#pragma once
+
+#include "Particle.h"
+
+class FakeHc165 {
+public:
+
+    /**
+     * @brief Constructor for class, attaches the fake to the pins and SPI
+     *
+     * @param[in] load_pin - pin of SH/LD
+     * @param[in] clock_pin - pin of CLK, unused with SPI
+     * @param[in] data_pin - pin of QH, unused with SPI
+     * @param[in] bits - number of inputs, 8 per register
+     */
+    FakeHc165(pin_t load_pin, pin_t clock_pin, pin_t data_pin, uint8_t bits)
+        : _load_pin(load_pin), _clock_pin(clock_pin), _data_pin(data_pin),
+          _bits(bits), _inputs(0), _shift(0), _position(0), _clock(0) {
+        host_on_pin_write([this](pin_t pin, int32_t level) {
+            on_pin_write(pin, level);
+        });
+        //SCK rising to the mode 2 idle level is a clock edge like any other
+        host_on_spi_clock([this](int32_t level) {
+            if(level) {_position++;}
+        });
+        host_on_spi([this](const uint8_t* tx, uint8_t* rx, size_t length) {
+            (void)tx;
+            for(size_t i = 0; i < length; i++) {
+                uint8_t byte = 0;
+                for(int k = 0; k < 8; k++) {
+                    byte = (byte << 1) | next_bit();
+                }
+                if(rx) {rx[i] = byte;}
+            }
+        });
+    }
+
+    ~FakeHc165() {
+        host_on_pin_write(nullptr);
+        host_on_spi(nullptr);
+        host_on_spi_clock(nullptr);
+    }
+
+    /**
+     * @brief Set the level of the inputs
+     *
+     * @param[in] inputs - bit 8 * r + k is input Dk of register r
+     */
+    void set_inputs(uint32_t inputs) {
+        _inputs = inputs;
+    }
+
+private:
+    void on_pin_write(pin_t pin, int32_t level) {
+        if(pin == _load_pin && !level) {
+            _shift = _inputs;
+            _position = 0;
+            host_set_pin(_data_pin, current_bit());
+        }
+        else if(pin == _clock_pin) {
+            if(level && !_clock) {
+                _position++;
+                host_set_pin(_data_pin, current_bit());
+            }
+            _clock = level;
+        }
+    }
+
+    //QH of register 0 shifts out D7 first, then the registers behind it
+    uint8_t current_bit() {
+        if(_position >= _bits) {
+            return 0;
+        }
+        uint8_t bit = (_position / 8) * 8 + 7 - (_position % 8);
+        return (_shift >> bit) & 1;
+    }
+
+    uint8_t next_bit() {
+        uint8_t bit = current_bit();
+        _position++;
+        return bit;
+    }
+
+    pin_t _load_pin;
+    pin_t _clock_pin;
+    pin_t _data_pin;
+    uint8_t _bits;
+    uint32_t _inputs;
+    uint32_t _shift;
+    uint8_t _position;
+    int32_t _clock;
+};
@@ -0,0 +1,139 @@
+/**
+ * @file fake_mcp23017.h
+ * @author Ed Ablan
+ * @version 1.0
+ * @date 10/17/2026
+ *
+ * @brief Host fake of an MCP23017 expander behind an I2cTransport
+ *
+ * @details Holds the register file with IOCON.BANK = 0 and sequential
+ * addressing. A change of an input with GPINTEN set, compared with the
+ * previous value (INTCON = 0), sets INTF, captures INTCAP while INTF was
+ * clear and pulls the INT pin low. Reading INTCAP or GPIO of a port clears
+ * its INTF and releases INT once both ports are clear. Only the interrupt
+ * on change mode used by Mcp23017Input is modelled
+ *
+ * @copyright Copyright (c) 2020 Particle Industries, Inc.  All rights reserved.
+ */
+#pragma once
+
+#include "Mcp23017Input.h"
+
+class FakeMcp23017 : public I2cTransport {
+public:
+
+    /**
+     * @brief Constructor for class
+     *
+     * @param[in] address - 7 bit address the fake answers
+     * @param[in] int_pin - host pin driven as INTA and INTB, 
+     * MCP23017_NO_INT_PIN for none
+     */
+    FakeMcp23017(uint8_t address, pin_t int_pin)
+        : _address(address), _int_pin(int_pin), _inputs(0xFFFF) {
+        memset(_regs, 0, sizeof(_regs));
+        _regs[REG_IODIRA] = 0xFF;
+        _regs[REG_IODIRB] = 0xFF;
+        update_int();
+    }
+
+    /**
+     * @brief Set the level of the inputs
+     *
+     * @param[in] inputs - GPA in the low byte, GPB in the high byte
+     */
+    void set_inputs(uint16_t inputs) {
+        uint16_t changed = (inputs ^ _inputs) & enabled();
+        _inputs = inputs;
+        for(int port = 0; port < 2; port++) {
+            uint8_t bits = changed >> (8 * port);
+            if(!bits) {
+                continue;
+            }
+            if(!_regs[REG_INTFA + port]) {
+                _regs[REG_INTCAPA + port] = inputs >> (8 * port);
+            }
+            _regs[REG_INTFA + port] |= bits;
+        }
+        update_int();
+    }
+
+    bool write(uint8_t address, uint8_t reg, const uint8_t* data,
+                size_t length) override {
+        if(address != _address) {
+            return false;
+        }
+        for(size_t i = 0; i < length; i++) {
+            uint8_t r = (reg + i) % REG_COUNT;
+            if(r >= REG_INTFA && r <= REG_INTCAPB) {
+                continue;
+            }
+            _regs[r] = data[i];
+        }
+        update_int();
+        return true;
+    }
+
+    bool read(uint8_t address, uint8_t reg, uint8_t* data,
+                size_t length) override {
+        if(address != _address) {
+            return false;
+        }
+        _reads++;
+        for(size_t i = 0; i < length; i++) {
+            uint8_t r = (reg + i) % REG_COUNT;
+            if(r == REG_GPIOA || r == REG_GPIOB) {
+                data[i] = _inputs >> (8 * (r - REG_GPIOA));
+                _regs[REG_INTFA + r - REG_GPIOA] = 0;
+            }
+            else {
+                data[i] = _regs[r];
+                if(r == REG_INTCAPA || r == REG_INTCAPB) {
+                    _regs[REG_INTFA + r - REG_INTCAPA] = 0;
+                }
+            }
+        }
+        update_int();
+        return true;
+    }
+
+    /**
+     * @brief Get the number of register reads the fake answered
+     *
+     * @return read transactions
+     */
+    uint32_t reads() const {
+        return _reads;
+    }
+
+private:
+    enum {
+        REG_IODIRA = 0x00,
+        REG_IODIRB = 0x01,
+        REG_GPINTENA = 0x04,
+        REG_INTFA = 0x0E,
+        REG_INTCAPA = 0x10,
+        REG_INTCAPB = 0x11,
+        REG_GPIOA = 0x12,
+        REG_GPIOB = 0x13,
+        REG_COUNT = 0x16,
+    };
+
+    uint16_t enabled() const {
+        return _regs[REG_GPINTENA] | (_regs[REG_GPINTENA + 1] << 8);
+    }
+
+    //INT is active low, open drain with the pull up of the host pin
+    void update_int() {
+        if(_int_pin != MCP23017_NO_INT_PIN) {
+            host_set_pin(_int_pin, 
+                        !(_regs[REG_INTFA] || _regs[REG_INTFA + 1]));
+        }
+    }
+
+    uint8_t _address;
+    pin_t _int_pin;
+    uint16_t _inputs;
+    uint8_t _regs[REG_COUNT];
+    uint32_t _reads = 0;
+};
@@ -0,0 +1,121 @@
+#!/usr/bin/env python3
+"""
+Write the synthetic traces of the golden corpus.
+
+The traces come from a fixed seed so they are the same on every run. Each
+one exercises a part of the decoder: clean gestures, heavy contact bounce,
+many channels in sigrok's VCD layout, spikes for the majority filter, a stuck
+button and a CSV with a time column. Recorded captures go in the corpus next
+to them, with a line in corpus.txt. After changing a trace regenerate the
+expected output with golden --update and review the diff.
+
+usage: gen_corpus.py [corpus dir]
+"""
+
+import os
+import random
+import sys
+
+SEED = 20261017
+
+
+def bounce(rng, t, level, max_bounces, max_us):
+    """Edges of a contact that chatters before it settles at level"""
+    edges = []
+    for i in range(rng.randint(0, max_bounces)):
+        t += rng.randint(20, max_us)
+        edges.append((t, level if i % 2 == 0 else 1 - level))
+    edges.append((t + rng.randint(20, max_us), level))
+    return edges
+
+
+def gestures(rng, count, bounces=3, bounce_us=900, long_ms=5000):
+    """Edges in micro secs of random gestures of an active low button"""
+    edges = [(0, 1)]
+    t = 200000
+    for _ in range(count):
+        kind = rng.random()
+        clicks = rng.randint(1, 4)
+        for c in range(clicks):
+            edges += bounce(rng, t, 0, bounces, bounce_us)
+            held = rng.randint(80, 300) * 1000
+            if kind > 0.8 and c == clicks - 1:
+                held = (long_ms + rng.randint(100, 2000)) * 1000
+            t += held
+            edges += bounce(rng, t, 1, bounces, bounce_us)
+            t += rng.randint(120, 400) * 1000
+        t += rng.randint(700, 3000) * 1000
+    return edges
+
+
+def write_vcd(path, channels, timescale_ns=1000, ids=None):
+    """channels: list of (name, edges in micro secs)"""
+    ids = ids or [chr(ord('!') + i) for i in range(len(channels))]
+    changes = []
+    for index, (_, edges) in enumerate(channels):
+        changes += [(t * 1000 // timescale_ns, index, level) for t, level in edges]
+    changes.sort()
+    unit = {1: '1 ns', 1000: '1 us', 1000000: '1 ms'}[timescale_ns]
+    with open(path, 'w') as out:
+        out.write('$date generated $end\n$version gen_corpus.py $end\n')
+        out.write('$timescale %s $end\n$scope module libsigrok $end\n' % unit)
+        for index, (name, _) in enumerate(channels):
+            out.write('$var wire 1 %s %s $end\n' % (ids[index], name))
+        out.write('$upscope $end\n$enddefinitions $end\n')
+        last = None
+        line = []
+        for t, index, level in changes:
+            if t != last:
+                if line:
+                    out.write(' '.join(line) + '\n')
+                line = ['#%d' % t]
+                last = t
+            line.append('%d%s' % (level, ids[index]))
+        if line:
+            out.write(' '.join(line) + '\n')
+
+
+def main():
+    corpus = sys.argv[1] if len(sys.argv) > 1 else os.path.join(
+        os.path.dirname(os.path.abspath(__file__)), 'corpus')
+    rng = random.Random(SEED)
+
+    write_vcd(os.path.join(corpus, 'clicks.vcd'),
+              [('BTN', gestures(rng, 60, bounces=2, bounce_us=500))])
+
+    write_vcd(os.path.join(corpus, 'bounce_heavy.vcd'),
+              [('BTN', gestures(rng, 60, bounces=12, bounce_us=4000))])
+
+    write_vcd(os.path.join(corpus, 'multi_channel.vcd'),
+              [('D%d' % i, gestures(rng, 25)) for i in range(8)],
+              timescale_ns=1)
+
+    # a press held past the stuck interval, then normal clicks
+    stuck = [(0, 1), (500000, 0), (26000000, 1)]
+    stuck += [(t + 27000000, level) for t, level in gestures(rng, 6)[1:]]
+    write_vcd(os.path.join(corpus, 'stuck.vcd'), [('BTN', stuck)])
+
+    # 1 kHz samples with single sample spikes on both levels
+    clean = gestures(rng, 20)
+    end_ms = clean[-1][0] // 1000 + 1500
+    with open(os.path.join(corpus, 'noisy_majority.csv'), 'w') as out:
+        out.write('; sampled at 1 kHz\nBTN\n')
+        index = 0
+        level = 1
+        for ms in range(end_ms):
+            while index < len(clean) and clean[index][0] <= ms * 1000:
+                level = clean[index][1]
+                index += 1
+            spike = rng.random() < 0.03
+            out.write('%d\n' % (level ^ spike))
+
+    # time column in seconds, an active high switch
+    edges = [(t, 1 - level) for t, level in gestures(rng, 30, long_ms=1000)]
+    with open(os.path.join(corpus, 'timed.csv'), 'w') as out:
+        out.write('; sigrok style csv\nTime,SW\n')
+        for t, level in edges:
+            out.write('%d.%06d,%d\n' % (t // 1000000, t % 1000000, level))
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,370 @@
+/**
+ * @file golden.cpp
+ * @author Ed Ablan
+ * @version 1.0
+ * @date 10/17/2026
+ *
+ * @brief Golden trace runner: checks the decoder output of every trace in the
+ * corpus and measures its cost
+ *
+ * @details Each trace listed in corpus.txt is decoded with its options (see
+ * tools/capture/capture_decoder.h) and the sequences must match
+ * <trace>.expected line for line. The edges of the trace are then decoded
+ * again from memory for at least GOLDEN_MIN_NS per repeat, and ns/edge is
+ * the median of GOLDEN_REPEATS repeats. bytes/instance is the size of a
+ * ButtonSequence plus what its constructor allocates. --json writes the
+ * results, --compare fails when bytes/instance grew against a baseline
+ * written with --json and prints the change of ns/edge. ns/edge depends on
+ * the host and its load, it only fails the compare when --threshold percent
+ * is given, for a baseline written on the same quiet machine. --update
+ * rewrites the expected outputs after an intended change of behaviour. Exits
+ * with 1 on any mismatch or regression.
+ *
+ * Build from the repository root:
+ *  g++ -O2 -std=c++14 -Itools/host -Isrc -Itools/capture -Itools/baseline
+ *      tools/host/host.cpp src/Debounce.cpp src/ButtonSequence.cpp
+ *      tools/capture/capture_parser.cpp tools/capture/capture_decoder.cpp
+ *      tools/golden/golden.cpp -o golden
+ *
+ * usage: golden [--corpus dir] [--update] [--json out.json]
+ *              [--compare baseline.json] [--threshold percent] [--filter name]
+ *
+ * @copyright Copyright (c) 2020 Particle Industries, Inc.  All rights reserved.
+ */
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <new>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "baseline_compare.h"
+#include "capture_decoder.h"
+
+#define GOLDEN_DEFAULT_CORPUS "tools/golden/corpus"
+#define GOLDEN_REPEATS 11
+//Time decoded per repeat at least, small traces are decoded many times
+#define GOLDEN_MIN_NS 20000000.0
+
+//Heap bytes allocated since start, to measure what a button allocates
+static size_t heap_bytes;
+
+void* operator new(size_t size)
+{
+    heap_bytes += size;
+    void* ptr = malloc(size ? size : 1);
+    if(!ptr) {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+void operator delete(void* ptr) noexcept
+{
+    free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept
+{
+    free(ptr);
+}
+
+struct GoldenEdge {
+    uint64_t time;
+    uint32_t column;
+    bool level;
+};
+
+struct GoldenResult {
+    std::string name;
+    bool passed;
+    uint64_t edges;
+    double ns_per_edge;
+    double bytes_per_instance;
+};
+
+static double now_ns()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static bool read_file(const std::string& path, std::string& text)
+{
+    FILE* in = fopen(path.c_str(), "r");
+    if(!in) {
+        return false;
+    }
+    char buf[4096];
+    size_t len;
+    text.clear();
+    while((len = fread(buf, 1, sizeof(buf), in)) > 0) {
+        text.append(buf, len);
+    }
+    fclose(in);
+    return true;
+}
+
+//Prints the first line that differs, returns true if the outputs match
+static bool same_output(const std::string& name, const std::string& expected,
+                        const std::string& actual)
+{
+    if(expected == actual) {
+        return true;
+    }
+    std::istringstream want(expected), got(actual);
+    std::string want_line, got_line;
+    for(int line = 1; ; line++) {
+        bool more_want = (bool)std::getline(want, want_line);
+        bool more_got = (bool)std::getline(got, got_line);
+        if(!more_want && !more_got) {break;}
+        if(!more_want || !more_got || want_line != got_line) {
+            printf("%s: line %d expected \"%s\" got \"%s\"\n", name.c_str(),
+                    line, more_want ? want_line.c_str() : "<end>",
+                    more_got ? got_line.c_str() : "<end>");
+            break;
+        }
+    }
+    return false;
+}
+
+static size_t bytes_per_instance(const CaptureOptions& options)
+{
+    //on the stack, so the heap only counts what the button allocates
+    size_t before = heap_bytes;
+    ButtonSequence button([]() { return 1; }, ActiveLevel::LOW,
+                            options.debounce, options.long_click);
+    if(options.majority) {
+        button.set_majority_filter(options.majority);
+    }
+    return sizeof(button) + heap_bytes - before;
+}
+
+static bool run_trace(const std::string& dir, const std::string& line,
+                        bool update, GoldenResult& result)
+{
+    std::istringstream words(line);
+    std::vector<std::string> args;
+    std::string word;
+    while(words >> word) {args.push_back(word);}
+
+    std::vector<char*> argv;
+    for(auto& arg : args) {argv.push_back(&arg[0]);}
+    CaptureOptions options;
+    for(size_t i = 1; i < argv.size(); i++) {
+        int used = capture_option(argv.size(), argv.data(), i, options);
+        if(!used) {
+            printf("%s: unknown option %s\n", args[0].c_str(), argv[i]);
+            return false;
+        }
+        i += used - 1;
+    }
+
+    result.name = args[0];
+    std::string path = dir + "/" + args[0];
+    int fd = open(path.c_str(), O_RDONLY);
+    if(fd < 0) {
+        printf("%s: cannot open\n", path.c_str());
+        return false;
+    }
+
+    //decode while streaming, as capture_replay does, and keep the edges
+    std::unique_ptr<CaptureParser> parser = capture_parser(options, path);
+    CaptureDecoder decoder(options);
+    std::vector<std::string> names;
+    std::vector<GoldenEdge> edges;
+    std::string output;
+    bool found = true;
+    decoder.set_sequence_callback(
+            [&](system_tick_t time, const std::string& name, int sequence) {
+        output += std::to_string(time) + "," + name + "," +
+                    std::to_string(sequence) + "\n";
+    });
+    parser->set_header_callback([&](const std::vector<std::string>& header) {
+        names = header;
+        found = decoder.attach(header, *parser);
+    });
+    parser->set_change_callback([&](size_t column, uint64_t time, bool level) {
+        edges.push_back({time, (uint32_t)column, level});
+        decoder.edge(column, time, level);
+    });
+    bool parsed = parser->parse(fd);
+    close(fd);
+    if(!parsed || !found) {
+        printf("%s: %s\n", path.c_str(), parsed ? "missing channel" :
+                                                parser->error().c_str());
+        return false;
+    }
+    decoder.finish(parser->end_time());
+
+    std::string expected_path = path + ".expected";
+    if(update) {
+        FILE* out = fopen(expected_path.c_str(), "w");
+        if(!out) {
+            printf("cannot write %s\n", expected_path.c_str());
+            return false;
+        }
+        fputs(output.c_str(), out);
+        fclose(out);
+        result.passed = true;
+    }
+    else {
+        std::string expected;
+        if(!read_file(expected_path, expected)) {
+            printf("%s: no expected output, run with --update\n",
+                    args[0].c_str());
+            return false;
+        }
+        result.passed = same_output(args[0], expected, output);
+    }
+
+    //only the edges are timed, each loop decodes with a fresh decoder built
+    //before its clock starts
+    result.edges = edges.size();
+    volatile int sink = 0;
+    std::vector<double> repeats;
+    for(int r = 0; r < GOLDEN_REPEATS && !edges.empty(); r++) {
+        double elapsed = 0;
+        size_t loops = 0;
+        for(; elapsed < GOLDEN_MIN_NS; loops++) {
+            CaptureDecoder timed(options);
+            timed.attach(names, *parser);
+            timed.set_sequence_callback(
+                    [&](system_tick_t, const std::string&, int sequence) {
+                sink += sequence;
+            });
+            double start = now_ns();
+            for(const GoldenEdge& edge : edges) {
+                timed.edge(edge.column, edge.time, edge.level);
+            }
+            timed.finish(parser->end_time());
+            elapsed += now_ns() - start;
+        }
+        repeats.push_back(elapsed / (loops * edges.size()));
+    }
+    //the median, one preempted or unusually lucky repeat does not move it
+    std::sort(repeats.begin(), repeats.end());
+    result.ns_per_edge = (repeats.empty()) ? 0 : repeats[repeats.size() / 2];
+    result.bytes_per_instance = bytes_per_instance(options);
+    return true;
+}
+
+static void write_json(FILE* out, const std::vector<GoldenResult>& results)
+{
+    //one trace per line, --compare relies on it
+    fprintf(out, "{\"cases\": [\n");
+    for(size_t i = 0; i < results.size(); i++) {
+        const GoldenResult& r = results[i];
+        fprintf(out, "  {\"name\": \"%s\", \"edges\": %llu, "
+                "\"ns_per_edge\": %.4f, \"bytes_per_instance\": %.0f}%s\n",
+                r.name.c_str(), (unsigned long long)r.edges, r.ns_per_edge,
+                r.bytes_per_instance, (i + 1 < results.size()) ? "," : "");
+    }
+    fprintf(out, "]}\n");
+}
+
+//Compare against a baseline written with --json, returns regressions found.
+//ns/edge is only reported unless threshold is at least 0
+static int compare(const char* path, const std::vector<GoldenResult>& results,
+                    double threshold)
+{
+    return baseline_compare(path, "trace", [&](const std::string& name,
+                                        std::vector<BaselineMetric>& out) {
+        for(const GoldenResult& r : results) {
+            if(r.name != name) {continue;}
+            //memory is exact, any growth counts
+            out.push_back({"ns_per_edge", r.ns_per_edge, threshold});
+            out.push_back({"bytes_per_instance", r.bytes_per_instance, 0});
+            return true;
+        }
+        return false;
+    });
+}
+
+int main(int argc, char** argv)
+{
+    std::string corpus = GOLDEN_DEFAULT_CORPUS;
+    bool update = false;
+    const char* json_path = NULL;
+    const char* baseline_path = NULL;
+    const char* filter = NULL;
+    double threshold = -1;
+
+    for(int i = 1; i < argc; i++) {
+        bool has_value = i + 1 < argc;
+        if(!strcmp(argv[i], "--corpus") && has_value) {corpus = argv[++i];}
+        else if(!strcmp(argv[i], "--update")) {update = true;}
+        else if(!strcmp(argv[i], "--json") && has_value) {json_path = argv[++i];}
+        else if(!strcmp(argv[i], "--compare") && has_value) {
+            baseline_path = argv[++i];
+        }
+        else if(!strcmp(argv[i], "--threshold") && has_value) {
+            threshold = atof(argv[++i]);
+        }
+        else if(!strcmp(argv[i], "--filter") && has_value) {filter = argv[++i];}
+        else {
+            fprintf(stderr, "usage: %s [--corpus dir] [--update] "
+                "[--json out.json] [--compare baseline.json] "
+                "[--threshold percent] [--filter name]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    std::string manifest;
+    if(!read_file(corpus + "/corpus.txt", manifest)) {
+        fprintf(stderr, "cannot read %s/corpus.txt\n", corpus.c_str());
+        return 2;
+    }
+
+    std::vector<GoldenResult> results;
+    int failures = 0;
+    std::istringstream lines(manifest);
+    std::string line;
+    printf("%-22s %6s %10s %8s %12s\n", "trace", "result", "edges", "ns/edge",
+            "bytes/inst");
+    while(std::getline(lines, line)) {
+        if(line.empty() || line[0] == '#') {continue;}
+        if(filter && !strstr(line.c_str(), filter)) {continue;}
+
+        GoldenResult r = {};
+        if(!run_trace(corpus, line, update, r)) {
+            failures++;
+            continue;
+        }
+        failures += !r.passed;
+        printf("%-22s %6s %10llu %8.2f %12.0f\n", r.name.c_str(),
+                r.passed ? "ok" : "FAIL", (unsigned long long)r.edges,
+                r.ns_per_edge, r.bytes_per_instance);
+        results.push_back(r);
+    }
+
+    if(json_path) {
+        FILE* out = fopen(json_path, "w");
+        if(!out) {
+            fprintf(stderr, "cannot write %s\n", json_path);
+            return 1;
+        }
+        write_json(out, results);
+        fclose(out);
+    }
+
+    int regressions = 0;
+    if(baseline_path) {
+        regressions = compare(baseline_path, results, threshold);
+        if(regressions) {
+            printf("%d regression(s)\n", regressions);
+        }
+    }
+    if(failures) {
+        printf("%d trace(s) failed\n", failures);
+    }
+    return (failures || regressions) ? 1 : 0;
+}
@@ -0,0 +1,245 @@
+/**
+ * @file governor_sim.cpp
+ * @author Ed Ablan
+ * @version 1.0
+ * @date 10/17/2026
+ *
+ * @brief Checks PollGovernor on the host against buttons checked every milli
+ * sec
+ *
+ * @details Random gestures with contact bounce are played on SIM_BUTTONS fake
+ * pins for --seconds, with presses longer than the idle interval plus the
+ * debounce interval so an idle sample always catches them. The loop runs
+ * every milli sec and checks the governed buttons only when poll_due() says
+ * so; a second set of buttons on the same pins is checked every milli sec as
+ * the reference. The governed buttons must decode the same sequences, each
+ * no later than the idle interval after the reference. While any button is
+ * active every loop must poll, while all are idle polls must be the idle
+ * interval apart. Also checks is_idle() and the button limit of add(). Prints
+ * the polls per second against the loop rate, exits with 1 on a failed
+ * check.
+ *
+ * Build from the repository root:
+ *  g++ -O2 -std=c++14 -Itools/host -Isrc tools/host/host.cpp
+ *      src/Debounce.cpp src/ButtonSequence.cpp src/PollGovernor.cpp
+ *      tools/governor/governor_sim.cpp -o governor_sim
+ *
+ * usage: governor_sim [--seconds s] [--idle-ms ms] [--seed n]
+ *
+ * @copyright Copyright (c) 2020 Particle Industries, Inc.  All rights reserved.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#include "PollGovernor.h"
+
+#define SIM_BUTTONS 4
+#define SIM_FIRST_PIN 1
+#define SIM_DEFAULT_SECONDS 300
+//Time played after the last gesture starts, so every sequence terminates
+#define SIM_TAIL_MS 10000
+
+struct SimEdge {
+    uint32_t time;      //milli secs
+    uint8_t button;
+    bool level;
+};
+
+struct SimSequence {
+    uint32_t time;
+    int sequence;
+};
+
+static uint32_t sim_seed = 1;
+
+static uint32_t sim_random(uint32_t range)
+{
+    sim_seed = sim_seed * 1103515245 + 12345;
+    return (sim_seed >> 8) % range;
+}
+
+//Active low buttons: gestures of 1 to 3 clicks or a long press at random
+//times, every edge chatters 0 to 4 times over a few milli secs. The first
+//press of a gesture outlasts an idle sample plus the debounce
+static std::vector<SimEdge> sim_pattern(uint32_t seconds, uint32_t idle_ms)
+{
+    std::vector<SimEdge> edges;
+    for(uint8_t b = 0; b < SIM_BUTTONS; b++) {
+        uint32_t t = 100 + sim_random(5000);
+        auto settle = [&](bool level) {
+            uint32_t bounces = sim_random(5);
+            for(uint32_t i = 0; i < bounces; i++) {
+                edges.push_back({t, b, (i & 1) ? !level : level});
+                t += 1 + sim_random(3);
+            }
+            edges.push_back({t, b, level});
+        };
+        while(t < seconds * 1000) {
+            bool long_press = sim_random(4) == 0;
+            uint32_t clicks = long_press ? 1 : 1 + sim_random(3);
+            for(uint32_t c = 0; c < clicks; c++) {
+                uint32_t hold = (c) ? 100 : idle_ms + 2 * DEFAULT_DEBOUNCE_MS;
+                settle(false);
+                t += long_press ? 5500 + sim_random(1000) :
+                                    hold + sim_random(130);
+                settle(true);
+                t += 150 + sim_random(200);
+            }
+            t += 2000 + sim_random(20000);
+        }
+    }
+    std::stable_sort(edges.begin(), edges.end(),
+        [](const SimEdge& a, const SimEdge& b) {return a.time < b.time;});
+    return edges;
+}
+
+static bool sim_check(const char* what, bool ok)
+{
+    printf("%-36s %s\n", what, (ok) ? "ok" : "FAILED");
+    return ok;
+}
+
+static bool run_limit()
+{
+    std::vector<std::unique_ptr<ButtonSequence>> buttons;
+    PollGovernor governor;
+    bool ok = sim_check("idle without buttons", governor.is_idle());
+    bool added = true;
+    for(size_t i = 0; i < POLL_GOVERNOR_MAX_BUTTONS; i++) {
+        buttons.emplace_back(new ButtonSequence(SIM_FIRST_PIN, INPUT,
+                                                ActiveLevel::LOW));
+        added &= governor.add(buttons.back().get());
+    }
+    ok &= sim_check("add up to the limit", added);
+    ok &= sim_check("add past the limit", !governor.add(buttons[0].get()));
+    return ok;
+}
+
+static bool run_gestures(uint32_t seconds, uint32_t idle_ms)
+{
+    std::vector<SimEdge> edges = sim_pattern(seconds, idle_ms);
+    std::vector<std::unique_ptr<ButtonSequence>> governed, reference;
+    std::vector<SimSequence> got[SIM_BUTTONS], want[SIM_BUTTONS];
+
+    host_set_micros(0);
+    for(uint8_t b = 0; b < SIM_BUTTONS; b++) {
+        host_set_pin(SIM_FIRST_PIN + b, 1);
+        governed.emplace_back(new ButtonSequence(SIM_FIRST_PIN + b, INPUT,
+                                                    ActiveLevel::LOW));
+        reference.emplace_back(new ButtonSequence(SIM_FIRST_PIN + b, INPUT,
+                                                    ActiveLevel::LOW));
+    }
+    PollGovernor governor(DEFAULT_ACTIVE_POLL_MS, idle_ms);
+    for(auto& button : governed) {
+        governor.add(button.get());
+    }
+
+    size_t next = 0;
+    uint32_t polls = 0;
+    uint32_t active_skips = 0;
+    uint32_t idle_early = 0;
+    uint32_t active_ms = 0;
+    uint32_t idle_polls = 0;
+    uint32_t end = seconds * 1000 + SIM_TAIL_MS;
+    int64_t last_poll = -1;
+    for(uint32_t ms = 1; ms <= end; ms++) {
+        host_set_micros((uint64_t)ms * 1000);
+        for(; next < edges.size() && edges[next].time <= ms; next++) {
+            host_set_pin(SIM_FIRST_PIN + edges[next].button,
+                            edges[next].level);
+        }
+        for(uint8_t b = 0; b < SIM_BUTTONS; b++) {
+            int sequence = reference[b]->check_button();
+            if(sequence) {
+                want[b].push_back({ms, sequence});
+            }
+        }
+
+        //the state left by the last poll decides the interval
+        bool idle = governor.is_idle();
+        active_ms += !idle;
+        if(!governor.poll_due()) {
+            active_skips += !idle;
+            continue;
+        }
+        if(idle) {
+            idle_polls++;
+            idle_early += last_poll >= 0 && ms - last_poll < idle_ms;
+        }
+        last_poll = ms;
+        polls++;
+        for(uint8_t b = 0; b < SIM_BUTTONS; b++) {
+            int sequence = governed[b]->check_button();
+            if(sequence) {
+                got[b].push_back({ms, sequence});
+            }
+        }
+    }
+
+    uint32_t sequences = 0;
+    uint32_t mismatches = 0;
+    for(uint8_t b = 0; b < SIM_BUTTONS; b++) {
+        sequences += want[b].size();
+        if(got[b].size() != want[b].size()) {
+            mismatches++;
+            continue;
+        }
+        for(size_t i = 0; i < want[b].size(); i++) {
+            uint32_t late = got[b][i].time - want[b][i].time;
+            mismatches += got[b][i].sequence != want[b][i].sequence ||
+                            got[b][i].time < want[b][i].time ||
+                            late > idle_ms;
+        }
+    }
+
+    printf("%lu ms, %lu active, %lu polls (%lu while idle), %lu sequences\n",
+            (unsigned long)end, (unsigned long)active_ms,
+            (unsigned long)polls, (unsigned long)idle_polls,
+            (unsigned long)sequences);
+    bool ok = sim_check("sequences", sequences > 0 && !mismatches);
+    ok &= sim_check("every loop polled while active", !active_skips);
+    ok &= sim_check("idle polls an idle interval apart", !idle_early);
+    ok &= sim_check("idle polls",
+                    idle_polls <= (end - active_ms) / idle_ms + sequences + 1);
+    ok &= sim_check("idle at the end", governor.is_idle());
+    return ok;
+}
+
+int main(int argc, char** argv)
+{
+    uint32_t seconds = SIM_DEFAULT_SECONDS;
+    uint32_t idle_ms = DEFAULT_IDLE_POLL_MS;
+
+    for(int i = 1; i < argc; i++) {
+        bool has_value = i + 1 < argc;
+        if(!strcmp(argv[i], "--seconds") && has_value) {
+            seconds = strtoul(argv[++i], NULL, 0);
+        }
+        else if(!strcmp(argv[i], "--idle-ms") && has_value) {
+            idle_ms = strtoul(argv[++i], NULL, 0);
+        }
+        else if(!strcmp(argv[i], "--seed") && has_value) {
+            sim_seed = strtoul(argv[++i], NULL, 0);
+        }
+        else {
+            fprintf(stderr, "usage: %s [--seconds s] [--idle-ms ms] "
+                "[--seed n]\n", argv[0]);
+            return 2;
+        }
+    }
+    if(!idle_ms) {
+        fprintf(stderr, "idle-ms must be at least 1\n");
+        return 2;
+    }
+
+    bool ok = run_limit();
+    ok &= run_gestures(seconds, idle_ms);
+    printf("%s\n", (ok) ? "ok" : "FAILED");
+    return (ok) ? 0 : 1;
+}
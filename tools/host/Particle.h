@@ -0,0 +1,125 @@
+/** 
+ * @file Particle.h
+ * @author Ed Ablan
+ * @version 1.0
+ * @date 10/17/2026
+ *
+ * @brief Host build shim of the Device OS API used by the library
+ *
+ * @details Lets the host tools (benchmarks, capture importer, trace runners)
+ * compile src/ with a regular Linux compiler. Time is a fake clock that only
+ * moves when the tool advances it, so runs are deterministic, and pins are a 
+ * table the tool writes. Pin writes and SPI transfers can be routed to a fake
+ * chip with host_on_pin_write(), host_on_spi() and host_on_spi_clock(). Not
+ * used for device builds
+ *
+ * @copyright Copyright (c) 2020 Particle Industries, Inc.  All rights reserved.
+ */
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <functional>
+
+typedef uint32_t system_tick_t;
+typedef uint16_t pin_t;
+
+enum PinMode {
+    INPUT,
+    OUTPUT,
+    INPUT_PULLUP,
+    INPUT_PULLDOWN,
+};
+
+#define HOST_MAX_PINS 64
+
+system_tick_t millis();
+uint32_t micros();
+int32_t digitalRead(pin_t pin);
+void digitalWrite(pin_t pin, uint8_t value);
+void pinMode(pin_t pin, PinMode mode);
+
+class Print {
+public:
+    virtual ~Print() {}
+    virtual size_t write(uint8_t c) = 0;
+    virtual size_t write(const uint8_t* buffer, size_t size) {
+        for(size_t i = 0; i < size; i++) {write(buffer[i]);}
+        return size;
+    }
+};
+
+#define MHZ 1000000
+#define MSBFIRST 1
+#define SPI_MODE0 0x00
+#define SPI_MODE1 0x01
+#define SPI_MODE2 0x02
+#define SPI_MODE3 0x03
+
+class SPISettings {
+public:
+    SPISettings(unsigned clock = 0, uint8_t bitOrder = MSBFIRST, 
+                uint8_t dataMode = SPI_MODE0)
+        : clock(clock), bitOrder(bitOrder), dataMode(dataMode) {}
+    unsigned clock;
+    uint8_t bitOrder;
+    uint8_t dataMode;
+};
+
+class SPIClass {
+public:
+    void begin() {}
+    int32_t beginTransaction(const SPISettings& settings);
+    void endTransaction() {}
+    void transfer(const void* tx_buffer, void* rx_buffer, size_t length,
+                    void (*user_callback)(void));
+};
+
+extern SPIClass SPI;
+
+//Wire API without a bus, every transfer fails. Host tools give the library a
+//fake I2cTransport instead
+class TwoWire {
+public:
+    void begin() {}
+    void beginTransmission(uint8_t address) {(void)address;}
+    size_t write(uint8_t data) {
+        (void)data;
+        return 1;
+    }
+    size_t write(const uint8_t* data, size_t length) {
+        (void)data;
+        return length;
+    }
+    uint8_t endTransmission(uint8_t stop = true) {
+        (void)stop;
+        return 2;
+    }
+    size_t requestFrom(uint8_t address, size_t quantity, uint8_t stop = true) {
+        (void)address;
+        (void)quantity;
+        (void)stop;
+        return 0;
+    }
+    int available() {return 0;}
+    int read() {return -1;}
+};
+
+extern TwoWire Wire;
+
+//Host only: drive the fake clock and pins
+void host_set_micros(uint64_t now);
+void host_advance_micros(uint64_t delta);
+void host_set_pin(pin_t pin, int32_t level);
+
+//Host only: called on every digitalWrite(), after the pin is set
+void host_on_pin_write(std::function<void(pin_t, int32_t)> on_write);
+
+//Host only: answers SPI.transfer(), rx is NULL when the caller reads nothing
+void host_on_spi(std::function<void(const uint8_t* tx, uint8_t* rx, 
+                                    size_t length)> on_transfer);
+
+//Host only: called when SPI.beginTransaction() moves SCK to the idle level
+//of a new mode, SCK idles low until the first mode 2 or 3 transaction
+void host_on_spi_clock(std::function<void(int32_t level)> on_clock);
@@ -0,0 +1,106 @@
+/** 
+ * @file host.cpp
+ * @author Ed Ablan
+ * @version 1.0
+ * @date 10/17/2026
+ *
+ * @brief Fake clock and pins for host builds
+ *
+ * @details Please read Particle.h in this directory for more details
+ *
+ * @copyright Copyright (c) 2020 Particle Industries, Inc.  All rights reserved.
+ */
+
+#include "Particle.h"
+
+static uint64_t host_micros = 0;
+static int32_t host_pins[HOST_MAX_PINS];
+static std::function<void(pin_t, int32_t)> host_pin_write;
+static std::function<void(const uint8_t*, uint8_t*, size_t)> host_spi;
+static std::function<void(int32_t)> host_spi_clock;
+//idle level of SCK, set by the mode of the last transaction
+static int32_t host_spi_idle = 0;
+
+SPIClass SPI;
+TwoWire Wire;
+
+system_tick_t millis()
+{
+    return (system_tick_t)(host_micros / 1000);
+}
+
+uint32_t micros()
+{
+    return (uint32_t)host_micros;
+}
+
+int32_t digitalRead(pin_t pin)
+{
+    return (pin < HOST_MAX_PINS) ? host_pins[pin] : 0;
+}
+
+void digitalWrite(pin_t pin, uint8_t value)
+{
+    host_set_pin(pin, value);
+    if(host_pin_write) {host_pin_write(pin, value);}
+}
+
+void pinMode(pin_t pin, PinMode mode)
+{
+    (void)pin;
+    (void)mode;
+}
+
+void host_set_micros(uint64_t now)
+{
+    host_micros = now;
+}
+
+void host_advance_micros(uint64_t delta)
+{
+    host_micros += delta;
+}
+
+void host_set_pin(pin_t pin, int32_t level)
+{
+    if(pin < HOST_MAX_PINS) {host_pins[pin] = level;}
+}
+
+void host_on_pin_write(std::function<void(pin_t, int32_t)> on_write)
+{
+    host_pin_write = on_write;
+}
+
+void host_on_spi(std::function<void(const uint8_t*, uint8_t*, size_t)> 
+                    on_transfer)
+{
+    host_spi = on_transfer;
+}
+
+void host_on_spi_clock(std::function<void(int32_t)> on_clock)
+{
+    host_spi_clock = on_clock;
+}
+
+int32_t SPIClass::beginTransaction(const SPISettings& settings)
+{
+    //CPOL is bit 1 of the mode
+    int32_t idle = (settings.dataMode & SPI_MODE2) ? 1 : 0;
+    if(idle != host_spi_idle) {
+        host_spi_idle = idle;
+        if(host_spi_clock) {host_spi_clock(idle);}
+    }
+    return 0;
+}
+
+void SPIClass::transfer(const void* tx_buffer, void* rx_buffer, size_t length,
+                        void (*user_callback)(void))
+{
+    if(host_spi) {
+        host_spi((const uint8_t*)tx_buffer, (uint8_t*)rx_buffer, length);
+    }
+    else if(rx_buffer) {
+        memset(rx_buffer, 0, length);
+    }
+    if(user_callback) {user_callback();}
+}
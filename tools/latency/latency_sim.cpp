@@ -0,0 +1,219 @@
+/**
+ * @file latency_sim.cpp
+ * @author Ed Ablan
+ * @version 1.0
+ * @date 10/17/2026
+ *
+ * @brief Checks the latency tags of ButtonSequence and the histograms of
+ * ButtonLatencyStats on the host
+ *
+ * @details Bounced presses and releases are fed every milli sec through
+ * check_button(state, now): a short click, a long press and a press after a
+ * glitch that settled back. The tag of every sequence must hold the first
+ * raw edge of the transition that ended it, the time the debounce confirmed
+ * it, its last bounce plus the debounce interval, and the time the short or
+ * long click timeout returned it. Then latencies of 1 to 100 milli secs are
+ * recorded and the count, mean, p50, p90, p99 and max of each stage, the
+ * bucket bounds, the last bucket and the printed line must match the values
+ * worked out by hand. Exits with 1 on a failed check.
+ *
+ * Build from the repository root:
+ *  g++ -O2 -std=c++14 -DBUTTON_LATENCY_ENABLE -Itools/host -Isrc
+ *      tools/host/host.cpp src/Debounce.cpp src/ButtonSequence.cpp
+ *      src/ButtonLatency.cpp src/ButtonPrint.cpp
+ *      tools/latency/latency_sim.cpp -o latency_sim
+ *
+ * usage: latency_sim
+ *
+ * @copyright Copyright (c) 2020 Particle Industries, Inc.  All rights reserved.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include <string>
+#include <vector>
+
+#include "ButtonLatency.h"
+#include "ButtonSequence.h"
+
+#ifndef BUTTON_LATENCY_ENABLE
+#error "build latency_sim with -DBUTTON_LATENCY_ENABLE"
+#endif
+
+//Short click timeout of ButtonSequence.cpp
+#define SIM_SHORT_CLICK_MS 500
+//The debounce stage of the stats run records 1 to SIM_SAMPLES milli secs
+#define SIM_SAMPLES 100
+
+struct SimEdge {
+    uint32_t time;      //milli secs
+    bool level;
+};
+
+struct SimTag {
+    int sequence;
+    ButtonLatency latency;
+};
+
+class StringPrint : public Print {
+public:
+    size_t write(uint8_t c) override {
+        text += (char)c;
+        return 1;
+    }
+    std::string text;
+};
+
+static bool sim_check(const char* what, bool ok)
+{
+    printf("%-36s %s\n", what, (ok) ? "ok" : "FAILED");
+    return ok;
+}
+
+static int32_t sim_released()
+{
+    return 1;
+}
+
+//Feeds the active low levels every milli sec up to end, keeps the tags
+static std::vector<SimTag> sim_play(const std::vector<SimEdge>& edges,
+                                    uint32_t end)
+{
+    std::vector<SimTag> tags;
+    ButtonSequence button(sim_released, ActiveLevel::LOW);
+    bool level = true;
+    size_t next = 0;
+    for(uint32_t now = 1; now <= end; now++) {
+        for(; next < edges.size() && edges[next].time <= now; next++) {
+            level = edges[next].level;
+        }
+        int sequence = button.check_button(level, now);
+        if(sequence) {
+            tags.push_back({sequence, button.latency()});
+        }
+    }
+    return tags;
+}
+
+static bool sim_tag(const SimTag& tag, int sequence, system_tick_t edge,
+                    system_tick_t confirmed, system_tick_t emitted)
+{
+    return tag.sequence == sequence && tag.latency.edge == edge &&
+            tag.latency.confirmed == confirmed &&
+            tag.latency.emitted == emitted;
+}
+
+static bool run_tags()
+{
+    const uint32_t debounce = DEFAULT_DEBOUNCE_MS;
+    const uint32_t long_click = DEFAULT_LONG_CLICK_MS;
+    std::vector<SimEdge> edges = {
+        //short click, the release bounces from 1200 to 1203
+        {1000, false}, {1001, true}, {1003, false},
+        {1200, true}, {1201, false}, {1203, true},
+        //a glitch shorter than the debounce settles back and is forgotten
+        {3000, false}, {3002, true},
+        //long press, the press bounces from 3500 to 3504
+        {3500, false}, {3502, true}, {3504, false},
+        {3504 + long_click + 1000, true},
+    };
+    std::vector<SimTag> tags = sim_play(edges, 3504 + long_click + 3000);
+
+    bool ok = sim_check("two sequences", tags.size() == 2);
+    if(tags.size() != 2) {
+        return false;
+    }
+    uint32_t confirmed = 1203 + debounce;
+    ok &= sim_check("short click tag", sim_tag(tags[0], 1, 1200, confirmed,
+                    confirmed + SIM_SHORT_CLICK_MS + 1));
+    confirmed = 3504 + debounce;
+    ok &= sim_check("long press tag after a glitch", sim_tag(tags[1], -1, 3500,
+                    confirmed, confirmed + long_click + 1));
+    return ok;
+}
+
+static bool run_stats()
+{
+    ButtonLatencyStats stats;
+    bool ok = sim_check("empty", !stats.percentile(LatencyStage::TOTAL, 50) &&
+                        !stats.histogram(LatencyStage::TOTAL).count);
+
+    //debounce 1 to 100, gap 0, queue 10, total 11 to 110
+    for(uint32_t i = 1; i <= SIM_SAMPLES; i++) {
+        stats.record({1000, 1000 + i, 1000 + i}, 1010 + i);
+    }
+    const LatencyHistogram& debounce = stats.histogram(LatencyStage::DEBOUNCE);
+    ok &= sim_check("count, sum and max", debounce.count == SIM_SAMPLES &&
+                    debounce.sum == 5050 && debounce.max == 100);
+    //1 | 2-3 | 4-7 | 8-15 | 16-31 | 32-63 | 64-127
+    static const uint32_t expected[] = {0, 1, 2, 4, 8, 16, 32, 37};
+    bool buckets = true;
+    for(size_t i = 0; i < sizeof(expected) / sizeof(expected[0]); i++) {
+        buckets &= debounce.buckets[i] == expected[i];
+    }
+    ok &= sim_check("bucket bounds", buckets);
+    //p50 is 50, in the 32 to 63 bucket, p90 and p99 are in the 64 to 127
+    //bucket, capped at the max
+    ok &= sim_check("percentiles",
+                    stats.percentile(LatencyStage::DEBOUNCE, 50) == 63 &&
+                    stats.percentile(LatencyStage::DEBOUNCE, 90) == 100 &&
+                    stats.percentile(LatencyStage::DEBOUNCE, 99) == 100 &&
+                    stats.percentile(LatencyStage::DEBOUNCE, 100) == 100 &&
+                    stats.percentile(LatencyStage::DEBOUNCE, 1) == 1);
+    ok &= sim_check("zero stage",
+                    stats.histogram(LatencyStage::GAP).buckets[0] ==
+                    SIM_SAMPLES && !stats.percentile(LatencyStage::GAP, 99));
+    ok &= sim_check("queue stage",
+                    stats.percentile(LatencyStage::QUEUE, 99) == 10 &&
+                    stats.histogram(LatencyStage::QUEUE).buckets[4] ==
+                    SIM_SAMPLES);
+
+    StringPrint out;
+    stats.print(out);
+    const char* printed =
+        "LATENCY debounce 100 50 63 100 100 100\r\n"
+        "LATENCY gap 100 0 0 0 0 0\r\n"
+        "LATENCY queue 100 10 10 10 10 10\r\n"
+        "LATENCY total 100 60 63 110 110 110\r\n";
+    ok &= sim_check("print", out.text == printed);
+    if(out.text != printed) {
+        printf("%s", out.text.c_str());
+    }
+
+    //the rank rounds up, p50 of 1, 2 and 100 is the second sample
+    stats.reset();
+    stats.record({0, 1, 1}, 1);
+    stats.record({0, 2, 2}, 2);
+    stats.record({0, 100, 100}, 100);
+    ok &= sim_check("rank rounds up",
+                    stats.percentile(LatencyStage::DEBOUNCE, 50) == 3 &&
+                    stats.percentile(LatencyStage::DEBOUNCE, 34) == 3 &&
+                    stats.percentile(LatencyStage::DEBOUNCE, 33) == 1);
+
+    //handled before emitted counts as 0, past 2^(LATENCY_BUCKETS - 1) the
+    //last bucket
+    stats.reset();
+    stats.record({0, 0, 100}, 50);
+    stats.record({0, 1UL << 20, 1UL << 20}, 1UL << 20);
+    ok &= sim_check("backwards and overflow",
+                    stats.histogram(LatencyStage::QUEUE).buckets[0] == 2 &&
+                    stats.histogram(LatencyStage::DEBOUNCE).
+                        buckets[LATENCY_BUCKETS - 1] == 1 &&
+                    stats.percentile(LatencyStage::DEBOUNCE, 100) ==
+                        (1UL << 20));
+    return ok;
+}
+
+int main(int argc, char** argv)
+{
+    if(argc > 1) {
+        fprintf(stderr, "usage: %s\n", argv[0]);
+        return 2;
+    }
+
+    bool ok = run_tags();
+    ok &= run_stats();
+    printf("%s\n", (ok) ? "ok" : "FAILED");
+    return (ok) ? 0 : 1;
+}
@@ -0,0 +1,196 @@
+/**
+ * @file notifier_sim.cpp
+ * @author Ed Ablan
+ * @version 1.0
+ * @date 10/17/2026
+ *
+ * @brief Checks LinuxButtonNotifier on the host with a real eventfd and
+ * timerfd
+ *
+ * @details begin() is called twice and must not open more descriptors. The
+ * eventfd must be readable exactly while events are queued: after the first
+ * push(), through pops that leave events behind, and no longer once pop()
+ * took the last one; events come out in the order pushed and a full queue
+ * drops and counts the events past LINUX_NOTIFIER_QUEUE_SIZE. Buttons fed
+ * their state are added and rearm() must arm the timerfd to the earliest
+ * next_deadline() of any button, which then fires, and disarm it once every
+ * button is idle. The destructor must close both descriptors. Exits with 1 on
+ * a failed check.
+ *
+ * Build from the repository root:
+ *  g++ -O2 -std=c++14 -Itools/host -Isrc tools/host/host.cpp
+ *      src/Debounce.cpp src/ButtonSequence.cpp src/LinuxInputSource.cpp
+ *      src/LinuxButtonNotifier.cpp tools/linux/notifier_sim.cpp
+ *      -o notifier_sim
+ *
+ * usage: notifier_sim
+ *
+ * @copyright Copyright (c) 2020 Particle Industries, Inc.  All rights reserved.
+ */
+
+#include <dirent.h>
+#include <poll.h>
+#include <stdio.h>
+#include <sys/timerfd.h>
+
+#include <memory>
+
+#include "LinuxButtonNotifier.h"
+#include "LinuxInputSource.h"
+
+//Milli secs a deadline may fire late on a loaded host
+#define SIM_TIMER_SLACK_MS 200
+//Milli secs the second button is pressed before the first, within the
+//debounce interval so both are pending
+#define SIM_PRESS_LEAD_MS 5
+
+static int32_t sim_released()
+{
+    return 1;
+}
+
+static bool sim_check(const char* what, bool ok)
+{
+    printf("%-36s %s\n", what, (ok) ? "ok" : "FAILED");
+    return ok;
+}
+
+//Open descriptors of this process
+static int sim_open_fds()
+{
+    DIR* dir = opendir("/proc/self/fd");
+    if(!dir) {
+        return -1;
+    }
+    int count = 0;
+    while(readdir(dir)) {
+        count++;
+    }
+    closedir(dir);
+    return count;
+}
+
+static bool sim_readable(int fd, int timeout_ms)
+{
+    struct pollfd pfd = {fd, POLLIN, 0};
+    return poll(&pfd, 1, timeout_ms) == 1 && (pfd.revents & POLLIN);
+}
+
+//Milli secs until the timerfd expires, -1 if it is disarmed
+static int32_t sim_armed_ms(int fd)
+{
+    struct itimerspec spec;
+    if(timerfd_gettime(fd, &spec) < 0 ||
+            (!spec.it_value.tv_sec && !spec.it_value.tv_nsec)) {
+        return -1;
+    }
+    return spec.it_value.tv_sec * 1000 + spec.it_value.tv_nsec / 1000000;
+}
+
+static bool run_begin(int& fds)
+{
+    fds = sim_open_fds();
+    LinuxButtonNotifier notifier;
+    bool ok = sim_check("begin", notifier.begin());
+    int event_fd = notifier.event_fd();
+    int timer_fd = notifier.timer_fd();
+    int opened = sim_open_fds();
+    ok &= sim_check("begin again", notifier.begin() &&
+                    notifier.event_fd() == event_fd &&
+                    notifier.timer_fd() == timer_fd &&
+                    sim_open_fds() == opened && opened == fds + 2);
+    return ok;
+}
+
+static bool run_queue()
+{
+    LinuxButtonNotifier notifier;
+    ButtonEvent event;
+    bool ok = notifier.begin();
+    int fd = notifier.event_fd();
+
+    ok &= sim_check("idle eventfd", !sim_readable(fd, 0) &&
+                    !notifier.pop(event));
+    ok &= notifier.push({1, 0, 1}) && notifier.push({2, 1, -2});
+    ok &= sim_check("readable after push", sim_readable(fd, 0));
+    ok &= notifier.pop(event) && event.timestamp == 1;
+    ok &= sim_check("readable while queued", sim_readable(fd, 0));
+    ok &= notifier.pop(event) && event.timestamp == 2 && event.sequence == -2;
+    ok &= sim_check("cleared once drained", !sim_readable(fd, 0) &&
+                    !notifier.pop(event));
+
+    bool pushed = true;
+    for(uint32_t i = 0; i < LINUX_NOTIFIER_QUEUE_SIZE; i++) {
+        pushed &= notifier.push({100 + i, 0, 1});
+    }
+    ok &= sim_check("push up to the queue size", pushed);
+    ok &= sim_check("drop when full", !notifier.push({999, 0, 1}) &&
+                    !notifier.push({999, 0, 1}) && notifier.dropped() == 2);
+    bool ordered = true;
+    for(uint32_t i = 0; i < LINUX_NOTIFIER_QUEUE_SIZE; i++) {
+        ordered &= notifier.pop(event) && event.timestamp == 100 + i;
+    }
+    ok &= sim_check("pop in order", ordered && !notifier.pop(event) &&
+                    !sim_readable(fd, 0));
+    return ok;
+}
+
+static bool run_timer()
+{
+    LinuxButtonNotifier notifier;
+    std::unique_ptr<ButtonSequence> first(new ButtonSequence(sim_released,
+                                                        ActiveLevel::LOW));
+    std::unique_ptr<ButtonSequence> second(new ButtonSequence(sim_released,
+                                                        ActiveLevel::LOW));
+    bool ok = notifier.begin() && notifier.add(first.get()) &&
+                notifier.add(second.get());
+    int fd = notifier.timer_fd();
+
+    notifier.rearm();
+    ok &= sim_check("disarmed while idle", sim_armed_ms(fd) < 0);
+
+    //the second press settles first, its deadline is the earliest
+    system_tick_t now = LinuxInputSource::now();
+    second->check_button(false, now - SIM_PRESS_LEAD_MS);
+    first->check_button(false, now);
+    system_tick_t deadline, earliest;
+    ok &= second->next_deadline(earliest) && first->next_deadline(deadline) &&
+            (int32_t)(earliest - deadline) < 0;
+    notifier.rearm();
+    int32_t armed = sim_armed_ms(fd);
+    int32_t expected = (int32_t)(earliest - LinuxInputSource::now());
+    if(expected < 0) {expected = 0;}
+    ok &= sim_check("armed to the earliest deadline",
+                    armed >= 0 && armed <= expected + 1 &&
+                    armed + SIM_TIMER_SLACK_MS >= expected);
+    ok &= sim_check("fires", sim_readable(fd, expected + SIM_TIMER_SLACK_MS) &&
+                    notifier.timer_expired() && !sim_readable(fd, 0));
+
+    //released and every timeout run, nothing is left to wait for
+    system_tick_t later = LinuxInputSource::now() + 100;
+    first->check_button(true, later);
+    second->check_button(true, later);
+    for(system_tick_t t = later; t < later + 10000; t += 10) {
+        first->check_button(true, t);
+        second->check_button(true, t);
+    }
+    notifier.rearm();
+    ok &= sim_check("disarmed once idle", sim_armed_ms(fd) < 0);
+    return ok;
+}
+
+int main(int argc, char** argv)
+{
+    if(argc > 1) {
+        fprintf(stderr, "usage: %s\n", argv[0]);
+        return 2;
+    }
+
+    int fds = 0;
+    bool ok = run_begin(fds);
+    ok &= sim_check("destructor closes", sim_open_fds() == fds);
+    ok &= run_queue();
+    ok &= run_timer();
+    printf("%s\n", (ok) ? "ok" : "FAILED");
+    return (ok) ? 0 : 1;
+}
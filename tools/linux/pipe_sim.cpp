@@ -0,0 +1,439 @@
+/**
+ * @file pipe_sim.cpp
+ * @author Ed Ablan
+ * @version 1.0
+ * @date 10/17/2026
+ *
+ * @brief Checks LinuxGpioSource and LinuxEvdevSource on the host by writing
+ * their records into a pipe
+ *
+ * @details Random gestures with contact bounce are played on SIM_LINES lines
+ * for --seconds. The edges are written into a pipe as GpioLineEvent records,
+ * or as input_event key events mixed with EV_SYN reports and auto repeat, in
+ * chunks of random length that split records, with events of a line or key
+ * that is not attached in between, and dispatch() is called after every
+ * chunk. check_timeouts() is called at random times between the edges. The
+ * same levels are fed to one ButtonSequence per line every milli sec as the
+ * reference; the source must decode the same sequences at the same times.
+ * timeout_ms() must wait for the debounce interval after an edge and forever
+ * once every line is idle or stuck, the release of a stuck button must be
+ * taken as soon as it is debounced, dispatch() must report the end of file
+ * once the pipe is closed, and now() must match CLOCK_MONOTONIC. Exits with
+ * 1 on a failed check.
+ *
+ * Build from the repository root:
+ *  g++ -O2 -std=c++14 -Itools/host -Isrc tools/host/host.cpp
+ *      src/Debounce.cpp src/ButtonSequence.cpp src/LinuxInputSource.cpp
+ *      src/LinuxGpioSource.cpp src/LinuxEvdevSource.cpp
+ *      tools/linux/pipe_sim.cpp -o pipe_sim
+ *
+ * usage: pipe_sim [--seconds s] [--seed n]
+ *
+ * @copyright Copyright (c) 2020 Particle Industries, Inc.  All rights reserved.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#include "LinuxEvdevSource.h"
+#include "LinuxGpioSource.h"
+
+#define SIM_LINES 4
+//Offset of a line that has events but no button
+#define SIM_UNKNOWN_OFFSET 99
+//Key code of the first line, the key codes follow
+#define SIM_FIRST_KEY BTN_0
+#define SIM_UNKNOWN_KEY KEY_A
+#define SIM_DEFAULT_SECONDS 120
+//Time played after the last gesture starts, so every sequence terminates
+#define SIM_TAIL_MS 10000
+#define SIM_MAX_CHUNK 300
+//Stuck interval of the stuck button check
+#define SIM_STUCK_MS 1000
+
+struct SimEdge {
+    uint32_t time;      //milli secs from the start
+    uint32_t line;
+    bool pressed;
+};
+
+static uint32_t sim_seed = 1;
+
+static uint32_t sim_random(uint32_t range)
+{
+    sim_seed = sim_seed * 1103515245 + 12345;
+    return (sim_seed >> 8) % range;
+}
+
+static void sim_append(std::vector<uint8_t>& bytes, const void* record,
+                        size_t size)
+{
+    const uint8_t* data = (const uint8_t*)record;
+    bytes.insert(bytes.end(), data, data + size);
+}
+
+//Lines of a GPIO line request, active low with a pull up
+struct SimGpio {
+    typedef LinuxGpioSource Source;
+    static const char* name() {return "gpio";}
+    static ActiveLevel active_level() {return ActiveLevel::LOW;}
+    static uint32_t id(uint32_t line) {return line;}
+    static bool level(bool pressed) {return !pressed;}
+    //read by the constructor of the buttons
+    static int32_t released() {return level(false);}
+
+    static void add(Source& source, uint32_t line, ButtonSequence* button) {
+        source.add_line(id(line), button, level(false));
+    }
+
+    static GpioLineEvent event(system_tick_t time, uint32_t offset,
+                                bool level) {
+        GpioLineEvent event = {};
+        event.timestamp_ns = (uint64_t)time * 1000000 + sim_random(1000000);
+        event.id = (level) ? GPIO_LINE_EVENT_RISING_EDGE :
+                                GPIO_LINE_EVENT_FALLING_EDGE;
+        event.offset = offset;
+        return event;
+    }
+
+    //the edge and sometimes one of a line without a button, returns records
+    static size_t write(std::vector<uint8_t>& bytes, system_tick_t time,
+                        uint32_t line, bool pressed) {
+        GpioLineEvent edge = event(time, id(line), level(pressed));
+        sim_append(bytes, &edge, sizeof(edge));
+        if(sim_random(8)) {
+            return 1;
+        }
+        edge = event(time, SIM_UNKNOWN_OFFSET, sim_random(2));
+        sim_append(bytes, &edge, sizeof(edge));
+        return 2;
+    }
+};
+
+//Keys of an input device, key down is high
+struct SimEvdev {
+    typedef LinuxEvdevSource Source;
+    static const char* name() {return "evdev";}
+    static ActiveLevel active_level() {return ActiveLevel::HIGH;}
+    static uint32_t id(uint32_t line) {return SIM_FIRST_KEY + line;}
+    static bool level(bool pressed) {return pressed;}
+    //read by the constructor of the buttons
+    static int32_t released() {return level(false);}
+
+    static void add(Source& source, uint32_t line, ButtonSequence* button) {
+        source.add_key(id(line), button);
+    }
+
+    static struct input_event event(system_tick_t time, uint16_t type,
+                                    uint16_t code, int32_t value) {
+        struct input_event event = {};
+        event.input_event_sec = time / 1000;
+        event.input_event_usec = (time % 1000) * 1000 + sim_random(1000);
+        event.type = type;
+        event.code = code;
+        event.value = value;
+        return event;
+    }
+
+    //the key event and its report, sometimes with auto repeat or a key
+    //without a button in between, returns records
+    static size_t write(std::vector<uint8_t>& bytes, system_tick_t time,
+                        uint32_t line, bool pressed) {
+        size_t count = 0;
+        struct input_event record[4];
+        record[count++] = event(time, EV_KEY, id(line), pressed);
+        if(!sim_random(8)) {
+            record[count++] = event(time, EV_KEY, SIM_UNKNOWN_KEY,
+                                    sim_random(2));
+        }
+        if(pressed && !sim_random(4)) {
+            record[count++] = event(time, EV_KEY, id(line), 2);
+        }
+        record[count++] = event(time, EV_SYN, SYN_REPORT, 0);
+        sim_append(bytes, record, count * sizeof(record[0]));
+        return count;
+    }
+};
+
+//Gestures of 1 to 3 clicks or a long press at random times, every edge
+//chatters 0 to 4 times over a few milli secs
+static std::vector<SimEdge> sim_pattern(uint32_t seconds)
+{
+    std::vector<SimEdge> edges;
+    for(uint32_t line = 0; line < SIM_LINES; line++) {
+        uint32_t t = 100 + sim_random(3000);
+        auto settle = [&](bool pressed) {
+            uint32_t bounces = sim_random(5);
+            for(uint32_t i = 0; i < bounces; i++) {
+                edges.push_back({t, line, (i & 1) ? !pressed : pressed});
+                t += 1 + sim_random(3);
+            }
+            edges.push_back({t, line, pressed});
+        };
+        while(t < seconds * 1000) {
+            bool long_press = sim_random(4) == 0;
+            uint32_t clicks = long_press ? 1 : 1 + sim_random(3);
+            for(uint32_t c = 0; c < clicks; c++) {
+                settle(true);
+                t += long_press ? 5500 + sim_random(1000) :
+                                    100 + sim_random(130);
+                settle(false);
+                t += 150 + sim_random(200);
+            }
+            t += 1000 + sim_random(5000);
+        }
+    }
+    std::stable_sort(edges.begin(), edges.end(),
+        [](const SimEdge& a, const SimEdge& b) {return a.time < b.time;});
+    return edges;
+}
+
+static bool sim_same(const ButtonEvent& a, const ButtonEvent& b)
+{
+    return a.timestamp == b.timestamp && a.button_id == b.button_id &&
+            a.sequence == b.sequence;
+}
+
+static bool sim_check(const char* what, bool ok)
+{
+    printf("%-36s %s\n", what, (ok) ? "ok" : "FAILED");
+    return ok;
+}
+
+//The same levels decoded every milli sec by one ButtonSequence per line
+template <typename Kind>
+static std::vector<ButtonEvent> sim_reference(const std::vector<SimEdge>& edges,
+                                        system_tick_t base, uint32_t end)
+{
+    std::vector<ButtonEvent> events;
+    std::vector<std::unique_ptr<ButtonSequence>> buttons;
+    bool levels[SIM_LINES];
+    for(uint32_t line = 0; line < SIM_LINES; line++) {
+        buttons.emplace_back(new ButtonSequence(Kind::released,
+                                                Kind::active_level()));
+        levels[line] = Kind::level(false);
+        buttons[line]->check_button(levels[line], base);
+    }
+    size_t next = 0;
+    for(uint32_t t = 1; t <= end; t++) {
+        for(; next < edges.size() && edges[next].time <= t; next++) {
+            levels[edges[next].line] = Kind::level(edges[next].pressed);
+        }
+        for(uint32_t line = 0; line < SIM_LINES; line++) {
+            int sequence = buttons[line]->check_button(levels[line], base + t);
+            if(sequence) {
+                events.push_back({base + t, (uint16_t)Kind::id(line),
+                                    (int16_t)sequence});
+            }
+        }
+    }
+    return events;
+}
+
+template <typename Kind>
+static bool run_gestures(uint32_t seconds)
+{
+    std::vector<SimEdge> edges = sim_pattern(seconds);
+    uint32_t end = seconds * 1000 + SIM_TAIL_MS;
+    std::vector<std::unique_ptr<ButtonSequence>> buttons;
+    std::vector<ButtonEvent> got;
+    typename Kind::Source source;
+    int fds[2];
+    if(pipe(fds) < 0) {
+        perror("pipe");
+        return false;
+    }
+    source.attach(fds[0]);
+    source.set_event_callback([&](const ButtonEvent& event) {
+        got.push_back(event);
+    });
+    //the reference starts at base too, the lines are idle until the first
+    //edge so a milli sec tick while adding them changes nothing
+    system_tick_t base = LinuxInputSource::now();
+    for(uint32_t line = 0; line < SIM_LINES; line++) {
+        buttons.emplace_back(new ButtonSequence(Kind::released,
+                                                Kind::active_level()));
+        Kind::add(source, line, buttons[line].get());
+    }
+
+    //time of every record, for the timeout checks
+    std::vector<uint8_t> bytes;
+    std::vector<uint32_t> times;
+    for(const SimEdge& edge : edges) {
+        size_t records = Kind::write(bytes, base + edge.time, edge.line,
+                                        edge.pressed);
+        times.insert(times.end(), records, edge.time);
+    }
+    size_t record_size = bytes.size() / times.size();
+
+    //split records are carried over to the next read
+    bool ok = true;
+    size_t written = 0;
+    int decoded = 0;
+    while(written < bytes.size()) {
+        size_t chunk = 1 + sim_random(SIM_MAX_CHUNK);
+        if(chunk > bytes.size() - written) {chunk = bytes.size() - written;}
+        if(write(fds[1], &bytes[written], chunk) != (ssize_t)chunk) {
+            perror("write");
+            return false;
+        }
+        written += chunk;
+        int result = source.dispatch();
+        ok &= result >= 0;
+        decoded += result;
+
+        //a timeout check before the next edge, never past it
+        size_t done = written / record_size;
+        if(done && done < times.size() && !sim_random(3)) {
+            uint32_t from = times[done - 1];
+            uint32_t t = from + sim_random(times[done] - from + 1);
+            decoded += source.check_timeouts(base + t);
+        }
+    }
+    decoded += source.check_timeouts(base + end);
+    ok &= sim_check("dispatch", ok);
+
+    std::vector<ButtonEvent> want = sim_reference<Kind>(edges, base, end);
+    auto order = [](const ButtonEvent& a, const ButtonEvent& b) {
+        return (a.timestamp != b.timestamp) ? a.timestamp < b.timestamp :
+                                                a.button_id < b.button_id;
+    };
+    std::stable_sort(got.begin(), got.end(), order);
+    printf("%zu edges, %zu sequences, reference %zu\n", edges.size(),
+            got.size(), want.size());
+    ok &= sim_check("decoded count", decoded == (int)got.size());
+    ok &= sim_check("sequences", !want.empty() && got.size() == want.size() &&
+                    std::equal(got.begin(), got.end(), want.begin(), sim_same));
+    ok &= sim_check("idle timeout", source.timeout_ms() == -1);
+
+    close(fds[1]);
+    ok &= sim_check("end of file", source.dispatch() == -1);
+    close(fds[0]);
+    return ok;
+}
+
+//timeout_ms() against the real clock, edges are stamped with now()
+template <typename Kind>
+static bool run_timeout()
+{
+    ButtonSequence button(Kind::released, Kind::active_level());
+    typename Kind::Source source;
+    int fds[2];
+    if(pipe(fds) < 0) {
+        perror("pipe");
+        return false;
+    }
+    source.attach(fds[0]);
+    Kind::add(source, 0, &button);
+    bool ok = sim_check("timeout before an edge", source.timeout_ms() == -1);
+
+    //stamped within the milli sec, the debounce is not shortened
+    system_tick_t pressed = LinuxInputSource::now();
+    std::vector<uint8_t> bytes;
+    Kind::write(bytes, pressed, 0, true);
+    ok &= write(fds[1], bytes.data(), bytes.size()) == (ssize_t)bytes.size();
+    source.dispatch();
+    int timeout = source.timeout_ms();
+    ok &= sim_check("timeout after an edge",
+                    timeout >= 0 && timeout <= DEFAULT_DEBOUNCE_MS);
+
+    //released and every timeout run, nothing is left to wait for
+    bytes.clear();
+    Kind::write(bytes, pressed + 200, 0, false);
+    ok &= write(fds[1], bytes.data(), bytes.size()) == (ssize_t)bytes.size();
+    source.dispatch();
+    source.check_timeouts(pressed + SIM_TAIL_MS);
+    ok &= sim_check("timeout once idle", source.timeout_ms() == -1);
+    close(fds[1]);
+    close(fds[0]);
+    return ok;
+}
+
+//A stuck button has no deadline and its release is taken at once
+template <typename Kind>
+static bool run_stuck()
+{
+    ButtonSequence button(Kind::released, Kind::active_level());
+    typename Kind::Source source;
+    int fds[2];
+    if(pipe(fds) < 0) {
+        perror("pipe");
+        return false;
+    }
+    button.set_stuck_interval(SIM_STUCK_MS);
+    source.attach(fds[0]);
+    Kind::add(source, 0, &button);
+
+    system_tick_t pressed = LinuxInputSource::now();
+    std::vector<uint8_t> bytes;
+    Kind::write(bytes, pressed, 0, true);
+    bool ok = write(fds[1], bytes.data(), bytes.size()) ==
+                (ssize_t)bytes.size();
+    source.dispatch();
+    system_tick_t stuck = pressed + DEFAULT_DEBOUNCE_MS + SIM_STUCK_MS + 1;
+    source.check_timeouts(stuck);
+    ok &= sim_check("stuck", button.is_stuck());
+    ok &= sim_check("no timeout while stuck", source.timeout_ms() == -1);
+
+    //released well within the stuck poll interval
+    bytes.clear();
+    Kind::write(bytes, stuck + 10, 0, false);
+    ok &= write(fds[1], bytes.data(), bytes.size()) == (ssize_t)bytes.size();
+    source.dispatch();
+    source.check_timeouts(stuck + 10 + DEFAULT_DEBOUNCE_MS);
+    ok &= sim_check("release of a stuck button", !button.is_stuck());
+    close(fds[1]);
+    close(fds[0]);
+    return ok;
+}
+
+template <typename Kind>
+static bool run(uint32_t seconds)
+{
+    printf("%s\n", Kind::name());
+    bool ok = run_gestures<Kind>(seconds);
+    ok &= run_timeout<Kind>();
+    ok &= run_stuck<Kind>();
+    return ok;
+}
+
+static bool run_clock()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    system_tick_t expected = (uint64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+    return sim_check("now", LinuxInputSource::now() - expected <= 1);
+}
+
+int main(int argc, char** argv)
+{
+    uint32_t seconds = SIM_DEFAULT_SECONDS;
+
+    for(int i = 1; i < argc; i++) {
+        bool has_value = i + 1 < argc;
+        if(!strcmp(argv[i], "--seconds") && has_value) {
+            seconds = strtoul(argv[++i], NULL, 0);
+        }
+        else if(!strcmp(argv[i], "--seed") && has_value) {
+            sim_seed = strtoul(argv[++i], NULL, 0);
+        }
+        else {
+            fprintf(stderr, "usage: %s [--seconds s] [--seed n]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    bool ok = true;
+    ok &= run<SimGpio>(seconds);
+    ok &= run<SimEvdev>(seconds);
+    ok &= run_clock();
+    printf("%s\n", (ok) ? "ok" : "FAILED");
+    return (ok) ? 0 : 1;
+}
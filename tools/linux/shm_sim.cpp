@@ -0,0 +1,321 @@
+/**
+ * @file shm_sim.cpp
+ * @author Ed Ablan
+ * @version 1.0
+ * @date 10/17/2026
+ *
+ * @brief Checks LinuxShmEventPublisher and LinuxShmEventReader with a
+ * publisher and a reader process running together
+ *
+ * @details The publisher writes --events events into a ring of --capacity
+ * slots while a forked reader follows it and stalls now and then, so the
+ * writer laps it many times and overwrites slots while they are copied out.
+ * Every event carries its position in all three fields, the reader checks
+ * that each one it gets is whole and is the one at its cursor, the events it
+ * got plus lost() so far, so a slot overwritten while it was read is never
+ * returned, and that in the end every event published is accounted for.
+ * The same is checked in one process with bursts of random length against a
+ * model of the cursor, so laps are covered on a single core host too, where
+ * the reader is rarely preempted in the middle of a copy. Before
+ * that, begin() is called again on the same name: the ring must stay mapped
+ * once, refuse to shrink and keep publishing, and may grow, and a reader
+ * opened before the rebuild must lose only the events it had not read and
+ * then follow the new ring. Exits with 1 on a failed check.
+ *
+ * Build from the repository root:
+ *  g++ -O2 -std=c++14 -Isrc src/LinuxShmEventRing.cpp
+ *      tools/linux/shm_sim.cpp -o shm_sim -lrt
+ *
+ * usage: shm_sim [--events n] [--capacity n] [--seed n]
+ *
+ * @copyright Copyright (c) 2020 Particle Industries, Inc.  All rights reserved.
+ */
+
+#include <fcntl.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "LinuxShmEventRing.h"
+
+#define SIM_DEFAULT_EVENTS 2000000
+#define SIM_DEFAULT_CAPACITY 16
+//The reader stalls for up to SIM_STALL_US once every SIM_STALL_EVERY events
+#define SIM_STALL_EVERY 5000
+#define SIM_STALL_US 200
+//The publisher spins up to SIM_SPIN loops between events, about the pace of
+//the reader, so slots are often overwritten while they are copied out, and
+//yields once every SIM_YIELD_EVERY events on average for single core hosts
+#define SIM_SPIN 64
+#define SIM_YIELD_EVERY 8
+
+static uint32_t sim_seed = 1;
+
+static uint32_t sim_random(uint32_t range)
+{
+    sim_seed = sim_seed * 1103515245 + 12345;
+    return (sim_seed >> 8) % range;
+}
+
+//An event that tells its position, a torn copy mixes two positions
+static ButtonEvent sim_event(uint64_t pos)
+{
+    return {(uint32_t)pos, (uint16_t)pos, (int16_t)(pos ^ 0x5A5A)};
+}
+
+static bool sim_whole(const ButtonEvent& event)
+{
+    return event.button_id == (uint16_t)event.timestamp &&
+            event.sequence == (int16_t)(event.timestamp ^ 0x5A5A);
+}
+
+static bool sim_check(const char* what, bool ok)
+{
+    printf("%-36s %s\n", what, (ok) ? "ok" : "FAILED");
+    return ok;
+}
+
+//Mappings of the ring in this process
+static int sim_mappings(const char* name)
+{
+    FILE* maps = fopen("/proc/self/maps", "r");
+    if(!maps) {
+        return -1;
+    }
+    int count = 0;
+    char line[512];
+    while(fgets(line, sizeof(line), maps)) {
+        const char* path = strstr(line, name);
+        count += path && (path[strlen(name)] == '\n' ||
+                            path[strlen(name)] == ' ');
+    }
+    fclose(maps);
+    return count;
+}
+
+static bool run_begin(LinuxShmEventPublisher& publisher, const char* name,
+                        uint32_t capacity)
+{
+    bool ok = sim_check("begin", publisher.begin(name, capacity));
+    ok &= sim_check("begin again", publisher.begin(name, capacity));
+    ok &= sim_check("mapped once", sim_mappings(name) == 1);
+    ok &= sim_check("shrink refused", !publisher.begin(name, capacity / 2));
+    ok &= sim_check("grow", publisher.begin(name, capacity * 2));
+    ok &= sim_check("mapped once after grow", sim_mappings(name) == 1);
+
+    //the ring is still usable after the refused call
+    LinuxShmEventReader reader;
+    ButtonEvent event;
+    ok &= reader.open(name);
+    publisher.publish(sim_event(7));
+    ok &= sim_check("publish after begin", reader.next(event) &&
+                    event.timestamp == 7 && !reader.next(event));
+
+    //a reader attached across a rebuild loses what it had not read, then
+    //follows the new ring, also when it grew past the size it mapped
+    for(uint32_t grow = 1; grow <= 2; grow++) {
+        for(uint32_t i = 0; i < 5; i++) {
+            publisher.publish(sim_event(100 + i));
+        }
+        bool follows = reader.next(event) && event.timestamp == 100 &&
+                        reader.next(event) && event.timestamp == 101;
+        uint64_t lost = reader.lost();
+        follows &= publisher.begin(name, capacity * 2 * grow);
+        for(uint32_t i = 0; i < 3; i++) {
+            publisher.publish(sim_event(200 + i));
+        }
+        for(uint32_t i = 0; i < 3; i++) {
+            follows &= reader.next(event) && event.timestamp == 200 + i;
+        }
+        follows &= !reader.next(event) && reader.lost() == lost + 3;
+        ok &= sim_check((grow == 1) ? "reader across rebuild" :
+                        "reader across grow", follows);
+    }
+    return ok;
+}
+
+//Bursts published and read in turn, every lap is known in advance
+static bool run_laps(LinuxShmEventPublisher& publisher, const char* name,
+                        uint32_t capacity, uint64_t events)
+{
+    LinuxShmEventReader reader;
+    if(!publisher.begin(name, capacity) || !reader.open(name)) {
+        return sim_check("laps setup", false);
+    }
+    uint64_t written = 0;
+    uint64_t cursor = 0;
+    uint64_t lost = 0;
+    uint64_t mismatches = 0;
+    while(written < events) {
+        uint32_t burst = sim_random(3 * capacity);
+        for(uint32_t i = 0; i < burst; i++) {
+            publisher.publish(sim_event(written++));
+        }
+        uint32_t reads = sim_random(2 * capacity);
+        if(!reads) {
+            continue;
+        }
+        //a lapped reader skips to the oldest slot still in the ring
+        if(written - cursor > capacity) {
+            lost += written - cursor - capacity;
+            cursor = written - capacity;
+        }
+        for(uint32_t i = 0; i < reads; i++) {
+            ButtonEvent event;
+            bool got = reader.next(event);
+            if(got != (cursor < written)) {
+                mismatches++;
+                break;
+            }
+            if(!got) {
+                break;
+            }
+            mismatches += !sim_whole(event) ||
+                            event.timestamp != (uint32_t)cursor++;
+        }
+        mismatches += reader.lost() != lost;
+    }
+    printf("%llu events, lost %llu\n", (unsigned long long)written,
+            (unsigned long long)lost);
+    return sim_check("laps", !mismatches && lost > 0);
+}
+
+//The reader process, reads until the publisher is done and the ring drained
+static int reader_main(const char* name, int ready_fd, int done_fd,
+                        uint64_t events)
+{
+    LinuxShmEventReader reader;
+    if(!reader.open(name)) {
+        printf("reader open FAILED\n");
+        return 1;
+    }
+    fcntl(done_fd, F_SETFL, fcntl(done_fd, F_GETFL) | O_NONBLOCK);
+    char byte = 1;
+    if(write(ready_fd, &byte, 1) != 1) {
+        return 1;
+    }
+
+    uint64_t got = 0;
+    uint64_t torn = 0;
+    uint64_t misplaced = 0;
+    int64_t last = -1;
+    bool done = false;
+    for(;;) {
+        ButtonEvent event;
+        if(!reader.next(event)) {
+            if(done) {
+                break;
+            }
+            //one more pass after the publisher is done drains the ring
+            done = read(done_fd, &byte, 1) == 1;
+            sched_yield();
+            continue;
+        }
+        torn += !sim_whole(event);
+        misplaced += event.timestamp != (uint32_t)(got + reader.lost());
+        last = event.timestamp;
+        if(++got % SIM_STALL_EVERY == 0) {
+            usleep(sim_random(SIM_STALL_US));
+        }
+    }
+
+    printf("%llu events, read %llu, lost %llu\n", (unsigned long long)events,
+            (unsigned long long)got, (unsigned long long)reader.lost());
+    bool ok = sim_check("events whole", !torn);
+    ok &= sim_check("events at the cursor", !misplaced);
+    ok &= sim_check("events accounted", got + reader.lost() == events);
+    ok &= sim_check("lapped", reader.lost() > 0);
+    ok &= sim_check("last event read", last == (int64_t)(uint32_t)(events - 1));
+    return (ok) ? 0 : 1;
+}
+
+static bool run_wraparound(LinuxShmEventPublisher& publisher, const char* name,
+                            uint32_t capacity, uint64_t events)
+{
+    int ready[2], done[2];
+    if(!publisher.begin(name, capacity) || pipe(ready) < 0 ||
+            pipe(done) < 0) {
+        return sim_check("wraparound setup", false);
+    }
+    fflush(stdout);
+    pid_t pid = fork();
+    if(pid == 0) {
+        close(ready[0]);
+        close(done[1]);
+        sim_seed += 1;
+        int status = reader_main(name, ready[1], done[0], events);
+        fflush(stdout);
+        _exit(status);
+    }
+    close(ready[1]);
+    close(done[0]);
+
+    char byte;
+    bool ok = read(ready[0], &byte, 1) == 1;
+    for(uint64_t pos = 0; ok && pos < events; pos++) {
+        publisher.publish(sim_event(pos));
+        for(volatile uint32_t spin = sim_random(SIM_SPIN); spin; spin--) {}
+        if(!sim_random(SIM_YIELD_EVERY)) {
+            sched_yield();
+        }
+    }
+    byte = 1;
+    ok &= write(done[1], &byte, 1) == 1;
+    int status = 0;
+    waitpid(pid, &status, 0);
+    close(ready[0]);
+    close(done[1]);
+    return ok && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+int main(int argc, char** argv)
+{
+    uint64_t events = SIM_DEFAULT_EVENTS;
+    uint32_t capacity = SIM_DEFAULT_CAPACITY;
+
+    for(int i = 1; i < argc; i++) {
+        bool has_value = i + 1 < argc;
+        if(!strcmp(argv[i], "--events") && has_value) {
+            events = strtoull(argv[++i], NULL, 0);
+        }
+        else if(!strcmp(argv[i], "--capacity") && has_value) {
+            capacity = strtoul(argv[++i], NULL, 0);
+        }
+        else if(!strcmp(argv[i], "--seed") && has_value) {
+            sim_seed = strtoul(argv[++i], NULL, 0);
+        }
+        else {
+            fprintf(stderr, "usage: %s [--events n] [--capacity n] "
+                "[--seed n]\n", argv[0]);
+            return 2;
+        }
+    }
+    if(capacity < 2 || (capacity & (capacity - 1))) {
+        fprintf(stderr, "capacity must be a power of 2, at least 2\n");
+        return 2;
+    }
+
+    char name[64];
+    snprintf(name, sizeof(name), "/shm_sim_%d", (int)getpid());
+    bool ok = true;
+    {
+        LinuxShmEventPublisher publisher;
+        ok &= run_begin(publisher, name, capacity);
+        LinuxShmEventPublisher::unlink(name);
+    }
+    {
+        LinuxShmEventPublisher publisher;
+        ok &= run_laps(publisher, name, capacity, events);
+        LinuxShmEventPublisher::unlink(name);
+    }
+    {
+        LinuxShmEventPublisher publisher;
+        ok &= run_wraparound(publisher, name, capacity, events);
+        LinuxShmEventPublisher::unlink(name);
+    }
+    printf("%s\n", (ok) ? "ok" : "FAILED");
+    return (ok) ? 0 : 1;
+}
@@ -0,0 +1,290 @@
+/**
+ * @file poller_sim.cpp
+ * @author Ed Ablan
+ * @version 1.0
+ * @date 10/17/2026
+ *
+ * @brief Checks BudgetPoller on the host against poll_all() of the same
+ * buttons
+ *
+ * @details --buttons buttons are read through callbacks that each take
+ * SIM_READ_US of the fake clock, and BudgetPoller::poll() is called once per
+ * milli sec with --budget-us. Three runs:
+ *  - gestures: random gestures on every button, the poller must decode the
+ *    sequences of a registry polled with poll_all() every milli sec. A
+ *    budget that stretches the revisit interval toward the debounce interval
+ *    loses short presses, with the default 300 buttons below about 200 us
+ *  - starved: SIM_HELD buttons are held for the whole run, so the active pass
+ *    spends the budget of every call; the sweep must still visit every
+ *    button, at one check per call
+ *  - covered: a budget large enough for every button, each call must check
+ *    every button once, so the revisit interval is the loop period
+ * Every run also checks that no button is checked twice in one call, that no
+ * call runs past the budget by more than two checks and that the reported
+ * stats match what the callbacks counted. The POLL line of every run is
+ * printed, exits with 1 on a failed check.
+ *
+ * Build from the repository root:
+ *  g++ -O2 -std=c++14 -Itools/host -Isrc tools/host/host.cpp
+ *      src/Debounce.cpp src/ButtonSequence.cpp src/ButtonPrint.cpp
+ *      tools/poller/poller_sim.cpp -o poller_sim
+ *
+ * usage: poller_sim [--buttons n] [--budget-us us] [--seconds s] [--seed n]
+ *
+ * @copyright Copyright (c) 2020 Particle Industries, Inc.  All rights reserved.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "BudgetPoller.h"
+
+#define SIM_MAX_BUTTONS 512
+#define SIM_READ_US 2
+#define SIM_HELD 40
+//Shorter than the stuck interval, a stuck button is no longer active
+#define SIM_HELD_SECONDS 15
+#define SIM_DEFAULT_BUTTONS 300
+#define SIM_DEFAULT_BUDGET_US 200
+#define SIM_DEFAULT_SECONDS 60
+//Time played after the last gesture starts, so every sequence terminates
+#define SIM_TAIL_MS 10000
+
+class StdoutPrint : public Print {
+public:
+    size_t write(uint8_t c) override {
+        return fputc(c, stdout) == EOF ? 0 : 1;
+    }
+};
+
+struct SimEdge {
+    uint32_t time;      //milli secs
+    uint16_t button;
+    bool level;
+};
+
+static bool sim_levels[SIM_MAX_BUTTONS];
+//checks of each button in the current call and overall
+static uint32_t sim_call_checks[SIM_MAX_BUTTONS];
+static uint32_t sim_checks;
+static bool sim_twice;
+static size_t sim_buttons = SIM_DEFAULT_BUTTONS;
+
+static uint32_t sim_seed = 1;
+
+static uint32_t sim_random(uint32_t range)
+{
+    sim_seed = sim_seed * 1103515245 + 12345;
+    return (sim_seed >> 8) % range;
+}
+
+//A button of the poller, each read costs SIM_READ_US
+static int32_t sim_read(void* context)
+{
+    size_t button = (size_t)(uintptr_t)context;
+    host_advance_micros(SIM_READ_US);
+    if(++sim_call_checks[button] > 1) {
+        sim_twice = true;
+    }
+    sim_checks++;
+    return sim_levels[button];
+}
+
+//A button of the reference, free to read
+static int32_t sim_read_reference(void* context)
+{
+    return sim_levels[(size_t)(uintptr_t)context];
+}
+
+//Active low buttons: gestures of 1 to 3 clicks or a long press at random
+//times, every edge chatters 0 to 4 times over a few milli secs
+static std::vector<SimEdge> sim_pattern(uint32_t seconds)
+{
+    std::vector<SimEdge> edges;
+    for(uint16_t b = 0; b < sim_buttons; b++) {
+        uint32_t t = 100 + sim_random(10000);
+        auto settle = [&](bool level) {
+            uint32_t bounces = sim_random(5);
+            for(uint32_t i = 0; i < bounces; i++) {
+                edges.push_back({t, b, (i & 1) ? !level : level});
+                t += 1 + sim_random(3);
+            }
+            edges.push_back({t, b, level});
+        };
+        while(t < seconds * 1000) {
+            bool long_press = sim_random(4) == 0;
+            uint32_t clicks = long_press ? 1 : 1 + sim_random(3);
+            for(uint32_t c = 0; c < clicks; c++) {
+                settle(false);
+                t += long_press ? 5500 + sim_random(1000) :
+                                    100 + sim_random(130);
+                settle(true);
+                t += 150 + sim_random(200);
+            }
+            t += 5000 + sim_random(20000);
+        }
+    }
+    std::stable_sort(edges.begin(), edges.end(),
+        [](const SimEdge& a, const SimEdge& b) {return a.time < b.time;});
+    return edges;
+}
+
+static std::string sim_format(size_t button, int sequence)
+{
+    char line[32];
+    snprintf(line, sizeof(line), "%u %d", (unsigned)button, sequence);
+    return line;
+}
+
+//The poller checks buttons in a different order than poll_all(), compare
+//the sequences of each button
+static void sim_sort(std::vector<std::string>& sequences)
+{
+    std::stable_sort(sequences.begin(), sequences.end(),
+        [](const std::string& a, const std::string& b) {
+            return atoi(a.c_str()) < atoi(b.c_str());
+        });
+}
+
+static bool sim_check(const char* run, const char* what, bool ok)
+{
+    if(!ok) {
+        printf("%s: %s FAILED\n", run, what);
+    }
+    return ok;
+}
+
+//Plays the edges for seconds plus the tail
+static bool run(const char* name, const std::vector<SimEdge>& edges,
+                uint32_t seconds, uint32_t budget_us)
+{
+    std::unique_ptr<ButtonRegistry<SIM_MAX_BUTTONS>> registry(
+                                        new ButtonRegistry<SIM_MAX_BUTTONS>);
+    std::unique_ptr<ButtonRegistry<SIM_MAX_BUTTONS>> expected(
+                                        new ButtonRegistry<SIM_MAX_BUTTONS>);
+    std::vector<std::string> got, want;
+    StdoutPrint out;
+    bool ok = true;
+
+    host_set_micros(0);
+    for(size_t i = 0; i < sim_buttons; i++) {
+        sim_levels[i] = true;
+        registry->add(sim_read, (void*)(uintptr_t)i, ActiveLevel::LOW);
+        expected->add(sim_read_reference, (void*)(uintptr_t)i,
+                        ActiveLevel::LOW);
+    }
+    host_set_micros(0);
+    BudgetPoller<SIM_MAX_BUTTONS> poller(*registry);
+    sim_checks = 0;
+    sim_twice = false;
+
+    size_t next = 0;
+    uint32_t calls = 0;
+    uint32_t overruns = 0;
+    //the check that spent the budget and the sweep check made after it
+    uint32_t allowed = budget_us + 2 * SIM_READ_US;
+    for(uint32_t ms = 0; ms < seconds * 1000 + SIM_TAIL_MS; ms++) {
+        for(; next < edges.size() && edges[next].time <= ms; next++) {
+            sim_levels[edges[next].button] = edges[next].level;
+        }
+        //a call that ran past the milli sec delays the next one
+        if(micros() < ms * 1000) {
+            host_set_micros((uint64_t)ms * 1000);
+        }
+        uint32_t now = micros();
+        expected->poll_all([&](size_t index, int sequence) {
+            want.push_back(sim_format(index, sequence));
+        });
+
+        memset(sim_call_checks, 0, sizeof(sim_call_checks));
+        poller.poll(budget_us, [&](size_t index, int sequence) {
+            got.push_back(sim_format(index, sequence));
+        });
+        calls++;
+        overruns += micros() - now > allowed;
+    }
+
+    printf("%s\n", name);
+    poller.print(out);
+    BudgetPollerStats stats = poller.stats();
+    ok &= sim_check(name, "overrun", !overruns);
+    ok &= sim_check(name, "checked twice in one call", !sim_twice);
+    ok &= sim_check(name, "calls", stats.calls == calls);
+    ok &= sim_check(name, "checks", stats.checks == sim_checks);
+    ok &= sim_check(name, "max call", stats.max_call_us <= allowed);
+    ok &= sim_check(name, "sweeps", stats.sweeps > 0);
+
+    if(!strcmp(name, "gestures")) {
+        sim_sort(got);
+        sim_sort(want);
+        printf("%zu sequences, reference %zu\n", got.size(), want.size());
+        ok &= sim_check(name, "sequences", got == want && !want.empty());
+    }
+    else if(!strcmp(name, "starved")) {
+        //every call moves the sweep at least one button past the held ones
+        uint32_t bound = (sim_buttons + 1) * 1000 + budget_us;
+        ok &= sim_check(name, "priority checks",
+                        stats.priority_checks > calls / 2);
+        ok &= sim_check(name, "revisit bound", stats.max_revisit_us <= bound);
+        ok &= sim_check(name, "sweep bound", stats.sweep_us <= bound);
+    }
+    else {
+        ok &= sim_check(name, "coverage", poller.coverage() == 100);
+        ok &= sim_check(name, "revisit", stats.max_revisit_us == 1000);
+        ok &= sim_check(name, "sweep", stats.sweep_us == 1000);
+    }
+
+    printf("%s\n", (ok) ? "ok" : "FAILED");
+    return ok;
+}
+
+int main(int argc, char** argv)
+{
+    uint32_t budget_us = SIM_DEFAULT_BUDGET_US;
+    uint32_t seconds = SIM_DEFAULT_SECONDS;
+
+    for(int i = 1; i < argc; i++) {
+        bool has_value = i + 1 < argc;
+        if(!strcmp(argv[i], "--buttons") && has_value) {
+            sim_buttons = strtoul(argv[++i], NULL, 0);
+        }
+        else if(!strcmp(argv[i], "--budget-us") && has_value) {
+            budget_us = strtoul(argv[++i], NULL, 0);
+        }
+        else if(!strcmp(argv[i], "--seconds") && has_value) {
+            seconds = strtoul(argv[++i], NULL, 0);
+        }
+        else if(!strcmp(argv[i], "--seed") && has_value) {
+            sim_seed = strtoul(argv[++i], NULL, 0);
+        }
+        else {
+            fprintf(stderr, "usage: %s [--buttons n] [--budget-us us] "
+                "[--seconds s] [--seed n]\n", argv[0]);
+            return 2;
+        }
+    }
+    if(sim_buttons <= SIM_HELD || sim_buttons > SIM_MAX_BUTTONS) {
+        fprintf(stderr, "buttons must be above %d and at most %d\n",
+                SIM_HELD, SIM_MAX_BUTTONS);
+        return 2;
+    }
+
+    std::vector<SimEdge> edges = sim_pattern(seconds);
+    std::vector<SimEdge> held;
+    for(uint16_t b = 0; b < SIM_HELD; b++) {
+        held.push_back({0, b, false});
+    }
+    bool ok = true;
+    ok &= run("gestures", edges, seconds, budget_us);
+    //only the held buttons are pressed, and they stay active
+    ok &= run("starved", held, SIM_HELD_SECONDS, SIM_READ_US);
+    ok &= run("covered", std::vector<SimEdge>(), seconds,
+                sim_buttons * SIM_READ_US);
+    return (ok) ? 0 : 1;
+}
@@ -0,0 +1,186 @@
+/**
+ * @file press_sim.cpp
+ * @author Ed Ablan
+ * @version 1.0
+ * @date 10/17/2026
+ *
+ * @brief Checks the press callback of ButtonSequence on the host
+ *
+ * @details Scripted raw levels are played on a button checked every milli
+ * sec, both fed through check_button(state, now) and read from a fake pin
+ * by check_button(), and the phases passed to the press callback are logged
+ * with their times. A clean press must report TENTATIVE at its edge and
+ * CONFIRMED when the debounce interval has passed, a press that bounces
+ * before it confirms must do the same from its first edge, and a glitch
+ * shorter than the debounce interval must report TENTATIVE and then
+ * CANCELLED exactly once, at the settle time of the debounce. A press held
+ * past the stuck interval and chattering while stuck must not call back
+ * until it is released and pressed again. The glitch is also checked with
+ * the button only checked at its edges and next_deadline(). Exits with 1 on
+ * a failed check.
+ *
+ * Build from the repository root:
+ *  g++ -O2 -std=c++14 -Itools/host -Isrc tools/host/host.cpp
+ *      src/Debounce.cpp src/ButtonSequence.cpp tools/press/press_sim.cpp
+ *      -o press_sim
+ *
+ * usage: press_sim
+ *
+ * @copyright Copyright (c) 2020 Particle Industries, Inc.  All rights reserved.
+ */
+
+#include <stdio.h>
+
+#include <vector>
+
+#include "ButtonSequence.h"
+
+#define SIM_PIN 1
+//Stuck interval of the stuck case
+#define SIM_STUCK_MS 3000
+#define SIM_DEBOUNCE_MS DEFAULT_DEBOUNCE_MS
+
+struct SimEdge {
+    uint32_t time;      //milli secs
+    bool level;         //active low, false is pressed
+};
+
+struct SimPhase {
+    uint32_t time;
+    PressPhase phase;
+
+    bool operator==(const SimPhase& other) const {
+        return time == other.time && phase == other.phase;
+    }
+};
+
+//Time of the check in progress, for the log of the callback
+static uint32_t sim_now;
+static std::vector<SimPhase> sim_log;
+
+static void sim_press(void* context, PressPhase phase)
+{
+    (void)context;
+    sim_log.push_back({sim_now, phase});
+}
+
+static bool sim_check(const char* what, bool ok)
+{
+    printf("%-36s %s\n", what, (ok) ? "ok" : "FAILED");
+    return ok;
+}
+
+//Plays the edges up to end, checking every milli sec. fed passes the level
+//to check_button(state, now), otherwise check_button() reads the pin
+static std::vector<SimPhase> sim_play(const std::vector<SimEdge>& edges,
+                                        uint32_t end, bool fed)
+{
+    host_set_micros(0);
+    host_set_pin(SIM_PIN, 1);
+    ButtonSequence button(SIM_PIN, INPUT, ActiveLevel::LOW);
+    button.set_stuck_interval(SIM_STUCK_MS);
+    button.set_press_callback(sim_press);
+    sim_log.clear();
+
+    bool level = true;
+    size_t next = 0;
+    for(sim_now = 1; sim_now <= end; sim_now++) {
+        for(; next < edges.size() && edges[next].time <= sim_now; next++) {
+            level = edges[next].level;
+        }
+        host_set_micros((uint64_t)sim_now * 1000);
+        host_set_pin(SIM_PIN, level);
+        if(fed) {
+            button.check_button(level, sim_now);
+        }
+        else {
+            button.check_button();
+        }
+    }
+    return sim_log;
+}
+
+//Checks the button only at the edges and at next_deadline()
+static std::vector<SimPhase> sim_play_edges(const std::vector<SimEdge>& edges,
+                                            uint32_t end)
+{
+    ButtonSequence button(SIM_PIN, INPUT, ActiveLevel::LOW);
+    button.set_press_callback(sim_press);
+    sim_log.clear();
+
+    bool level = true;
+    size_t next = 0;
+    sim_now = 1;
+    while(sim_now <= end) {
+        for(; next < edges.size() && edges[next].time <= sim_now; next++) {
+            level = edges[next].level;
+        }
+        button.check_button(level, sim_now);
+        uint32_t wake = end + 1;
+        system_tick_t deadline;
+        if(button.next_deadline(deadline) &&
+                (int32_t)(deadline - sim_now) > 0) {
+            wake = deadline;
+        }
+        if(next < edges.size() && edges[next].time < wake) {
+            wake = edges[next].time;
+        }
+        sim_now = wake;
+    }
+    return sim_log;
+}
+
+static bool run_case(const char* what, const std::vector<SimEdge>& edges,
+                        uint32_t end, const std::vector<SimPhase>& want)
+{
+    bool ok = sim_play(edges, end, true) == want;
+    ok &= sim_play(edges, end, false) == want;
+    return sim_check(what, ok);
+}
+
+int main(int argc, char** argv)
+{
+    if(argc > 1) {
+        fprintf(stderr, "usage: %s\n", argv[0]);
+        return 2;
+    }
+
+    bool ok = run_case("clean press",
+        {{100, false}, {300, true}}, 2000,
+        {{100, PressPhase::TENTATIVE},
+         {100 + SIM_DEBOUNCE_MS, PressPhase::CONFIRMED}});
+
+    ok &= run_case("press bouncing before it confirms",
+        {{100, false}, {101, true}, {103, false}, {104, true}, {105, false},
+         {400, true}}, 2000,
+        {{100, PressPhase::TENTATIVE},
+         {105 + SIM_DEBOUNCE_MS, PressPhase::CONFIRMED}});
+
+    //the glitch settles back at its last edge plus the debounce interval
+    std::vector<SimEdge> glitch = {{100, false}, {102, true}, {103, false},
+                                    {104, true}};
+    std::vector<SimPhase> cancelled = {{100, PressPhase::TENTATIVE},
+                            {104 + SIM_DEBOUNCE_MS, PressPhase::CANCELLED}};
+    ok &= run_case("glitch cancelled once", glitch, 2000, cancelled);
+    ok &= sim_check("glitch at edges and deadlines",
+                    sim_play_edges(glitch, 2000) == cancelled);
+
+    //chatter while stuck reports nothing, the release ends the fault and the
+    //next press is reported again
+    std::vector<SimEdge> stuck = {{100, false}};
+    uint32_t chatter = 100 + SIM_STUCK_MS + 500;
+    for(uint32_t i = 0; i < 20; i++, chatter += 97) {
+        stuck.push_back({chatter, true});
+        stuck.push_back({chatter + 2, false});
+    }
+    stuck.push_back({chatter + 200, true});
+    stuck.push_back({chatter + 2000, false});
+    ok &= run_case("no callbacks while stuck", stuck, chatter + 3000,
+        {{100, PressPhase::TENTATIVE},
+         {100 + SIM_DEBOUNCE_MS, PressPhase::CONFIRMED},
+         {chatter + 2000, PressPhase::TENTATIVE},
+         {chatter + 2000 + SIM_DEBOUNCE_MS, PressPhase::CONFIRMED}});
+
+    printf("%s\n", (ok) ? "ok" : "FAILED");
+    return (ok) ? 0 : 1;
+}
@@ -0,0 +1,285 @@
+/**
+ * @file registry_sim.cpp
+ * @author Ed Ablan
+ * @version 1.0
+ * @date 10/17/2026
+ *
+ * @brief Checks ButtonRegistry on the host against one ButtonSequence per
+ * button
+ *
+ * @details SIM_BUTTONS buttons are added to a registry, half on fake pins and
+ * half with a read function and context, and random gestures with contact
+ * bounce are played on them for --seconds. poll_all() is called every milli
+ * sec and must report the sequences of a separate ButtonSequence per button,
+ * in order, with the index the button was added at. Also checks that add()
+ * stops at N, that at() follows the order of add(), that adding pin and
+ * read function buttons allocates nothing, that memory_reserved() covers the
+ * N buttons, that the destructor destroys every button that was added and
+ * that a copy of a button holds its own std::function callback. Exits with 1
+ * on a failed check.
+ *
+ * Build from the repository root:
+ *  g++ -O2 -std=c++14 -Itools/host -Isrc tools/host/host.cpp
+ *      src/Debounce.cpp src/ButtonSequence.cpp
+ *      tools/registry/registry_sim.cpp -o registry_sim
+ *
+ * usage: registry_sim [--seconds s] [--seed n]
+ *
+ * @copyright Copyright (c) 2020 Particle Industries, Inc.  All rights reserved.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+#include <memory>
+#include <new>
+#include <vector>
+
+#include "ButtonRegistry.h"
+
+#define SIM_BUTTONS 8
+#define SIM_FIRST_PIN 1
+#define SIM_DEFAULT_SECONDS 300
+//Time played after the last gesture starts, so every sequence terminates
+#define SIM_TAIL_MS 10000
+
+static_assert(ButtonRegistry<SIM_BUTTONS>::memory_reserved() >=
+                SIM_BUTTONS * sizeof(ButtonSequence),
+                "the registry must reserve every button");
+
+struct SimEdge {
+    uint32_t time;      //milli secs
+    uint8_t button;
+    bool level;
+};
+
+struct SimSequence {
+    uint32_t time;
+    size_t index;
+    int sequence;
+};
+
+//Allocations made through operator new, to check that add() makes none
+static size_t heap_allocations;
+
+void* operator new(size_t size)
+{
+    heap_allocations++;
+    void* ptr = malloc(size ? size : 1);
+    if(!ptr) {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+void operator delete(void* ptr) noexcept
+{
+    free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept
+{
+    free(ptr);
+}
+
+static bool sim_levels[SIM_BUTTONS];
+static uint32_t sim_seed = 1;
+
+static uint32_t sim_random(uint32_t range)
+{
+    sim_seed = sim_seed * 1103515245 + 12345;
+    return (sim_seed >> 8) % range;
+}
+
+//The upper half of the buttons is read through a read function, the context
+//is the level of the button
+static int32_t sim_read(void* context)
+{
+    return *static_cast<bool*>(context);
+}
+
+static void sim_set(uint8_t button, bool level)
+{
+    sim_levels[button] = level;
+    host_set_pin(SIM_FIRST_PIN + button, level);
+}
+
+template <size_t N>
+static ButtonSequence* sim_add(ButtonRegistry<N>& registry, uint8_t button)
+{
+    if(button < SIM_BUTTONS / 2) {
+        return registry.add(SIM_FIRST_PIN + button, INPUT, ActiveLevel::LOW);
+    }
+    return registry.add(sim_read, &sim_levels[button], ActiveLevel::LOW);
+}
+
+//Active low buttons: gestures of 1 to 3 clicks or a long press at random
+//times, every edge chatters 0 to 4 times over a few milli secs
+static std::vector<SimEdge> sim_pattern(uint32_t seconds)
+{
+    std::vector<SimEdge> edges;
+    for(uint8_t b = 0; b < SIM_BUTTONS; b++) {
+        uint32_t t = 100 + sim_random(5000);
+        auto settle = [&](bool level) {
+            uint32_t bounces = sim_random(5);
+            for(uint32_t i = 0; i < bounces; i++) {
+                edges.push_back({t, b, (i & 1) ? !level : level});
+                t += 1 + sim_random(3);
+            }
+            edges.push_back({t, b, level});
+        };
+        while(t < seconds * 1000) {
+            bool long_press = sim_random(4) == 0;
+            uint32_t clicks = long_press ? 1 : 1 + sim_random(3);
+            for(uint32_t c = 0; c < clicks; c++) {
+                settle(false);
+                t += long_press ? 5500 + sim_random(1000) :
+                                    100 + sim_random(130);
+                settle(true);
+                t += 150 + sim_random(200);
+            }
+            t += 2000 + sim_random(20000);
+        }
+    }
+    std::stable_sort(edges.begin(), edges.end(),
+        [](const SimEdge& a, const SimEdge& b) {return a.time < b.time;});
+    return edges;
+}
+
+static bool sim_check(const char* what, bool ok)
+{
+    printf("%-36s %s\n", what, (ok) ? "ok" : "FAILED");
+    return ok;
+}
+
+static bool run_slots()
+{
+    static ButtonRegistry<SIM_BUTTONS> registry;
+    std::vector<ButtonSequence*> added;
+
+    for(uint8_t b = 0; b < SIM_BUTTONS; b++) {
+        sim_set(b, true);
+    }
+    added.reserve(SIM_BUTTONS);
+    size_t before = heap_allocations;
+    for(uint8_t b = 0; b < SIM_BUTTONS; b++) {
+        added.push_back(sim_add(registry, b));
+    }
+    bool ok = sim_check("no allocation", heap_allocations == before);
+    ok &= sim_check("add past the limit", !sim_add(registry, 0));
+    ok &= sim_check("size", registry.size() == SIM_BUTTONS &&
+                    registry.capacity() == SIM_BUTTONS);
+
+    bool ordered = !registry.at(SIM_BUTTONS);
+    for(size_t i = 0; i < SIM_BUTTONS; i++) {
+        ordered &= added[i] && registry.at(i) == added[i];
+    }
+    ok &= sim_check("at() in the order added", ordered);
+    return ok;
+}
+
+//The destructor must destroy what add() constructed and nothing more
+static bool run_destroy()
+{
+    std::shared_ptr<int> token = std::make_shared<int>(1);
+    std::function<int32_t(void)> read = [token]() -> int32_t {
+        return *token;
+    };
+    long held = token.use_count();
+    bool copied = false;
+    {
+        std::unique_ptr<ButtonRegistry<SIM_BUTTONS>> registry(
+                                        new ButtonRegistry<SIM_BUTTONS>);
+        for(size_t i = 0; i < SIM_BUTTONS / 2; i++) {
+            registry->add(read, ActiveLevel::LOW);
+        }
+        held = token.use_count() - held;
+        //a copy holds its own callback and frees it, the button keeps its
+        long before = token.use_count();
+        {
+            ButtonSequence copy(*registry->at(0));
+            copy = *registry->at(1);
+            copied = token.use_count() - before == 1 &&
+                        copy.check_button() == 0;
+        }
+        copied &= token.use_count() == before &&
+                    registry->at(0)->check_button() == 0;
+    }
+    bool ok = sim_check("buttons hold their callbacks",
+                        held == SIM_BUTTONS / 2);
+    ok &= sim_check("copies hold their own callback", copied);
+    return ok & sim_check("destructor", token.use_count() == 2);
+}
+
+static bool run_gestures(uint32_t seconds)
+{
+    std::vector<SimEdge> edges = sim_pattern(seconds);
+    std::unique_ptr<ButtonRegistry<SIM_BUTTONS>> registry(
+                                        new ButtonRegistry<SIM_BUTTONS>);
+    std::vector<std::unique_ptr<ButtonSequence>> reference;
+    std::vector<SimSequence> got, want;
+
+    host_set_micros(0);
+    for(uint8_t b = 0; b < SIM_BUTTONS; b++) {
+        sim_set(b, true);
+        sim_add(*registry, b);
+        reference.emplace_back(new ButtonSequence(sim_read, &sim_levels[b],
+                                                    ActiveLevel::LOW));
+    }
+
+    size_t next = 0;
+    uint32_t end = seconds * 1000 + SIM_TAIL_MS;
+    int decoded = 0;
+    for(uint32_t ms = 1; ms <= end; ms++) {
+        host_set_micros((uint64_t)ms * 1000);
+        for(; next < edges.size() && edges[next].time <= ms; next++) {
+            sim_set(edges[next].button, edges[next].level);
+        }
+        for(size_t b = 0; b < SIM_BUTTONS; b++) {
+            int sequence = reference[b]->check_button();
+            if(sequence) {
+                want.push_back({ms, b, sequence});
+            }
+        }
+        decoded += registry->poll_all([&](size_t index, int sequence) {
+            got.push_back({ms, index, sequence});
+        });
+    }
+
+    bool same = got.size() == want.size();
+    for(size_t i = 0; same && i < got.size(); i++) {
+        same = got[i].time == want[i].time && got[i].index == want[i].index &&
+                got[i].sequence == want[i].sequence;
+    }
+    printf("%zu edges, %zu sequences, reference %zu\n", edges.size(),
+            got.size(), want.size());
+    bool ok = sim_check("decoded count", decoded == (int)got.size());
+    return ok & sim_check("sequences", !want.empty() && same);
+}
+
+int main(int argc, char** argv)
+{
+    uint32_t seconds = SIM_DEFAULT_SECONDS;
+
+    for(int i = 1; i < argc; i++) {
+        bool has_value = i + 1 < argc;
+        if(!strcmp(argv[i], "--seconds") && has_value) {
+            seconds = strtoul(argv[++i], NULL, 0);
+        }
+        else if(!strcmp(argv[i], "--seed") && has_value) {
+            sim_seed = strtoul(argv[++i], NULL, 0);
+        }
+        else {
+            fprintf(stderr, "usage: %s [--seconds s] [--seed n]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    bool ok = run_slots();
+    ok &= run_destroy();
+    ok &= run_gestures(seconds);
+    printf("%s\n", (ok) ? "ok" : "FAILED");
+    return (ok) ? 0 : 1;
+}
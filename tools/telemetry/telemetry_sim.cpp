@@ -0,0 +1,233 @@
+/**
+ * @file telemetry_sim.cpp
+ * @author Ed Ablan
+ * @version 1.0
+ * @date 10/17/2026
+ *
+ * @brief Round trips ButtonTelemetry blobs through tools/telemetry_decode.py
+ * on the host
+ *
+ * @details Random sequences of --events events are recorded at random times
+ * of the fake clock: short and long sequences past TELEMETRY_MAX_CLICKS,
+ * every button id, and gaps from 0 to hours so the delta varints take every
+ * length. Three intervals are run: one that fits the buffer, one that
+ * overflows it so events are dropped while the histograms keep counting, and
+ * one that starts shortly before millis() wraps. Each blob is serialized to
+ * a file and decoded with the Python tool, whose report must match the
+ * report expected from the recorded events line for line. Exits with 1 on a
+ * mismatch.
+ *
+ * Build from the repository root:
+ *  g++ -O2 -std=c++14 -Itools/host -Isrc tools/host/host.cpp
+ *      src/ButtonTelemetry.cpp tools/telemetry/telemetry_sim.cpp
+ *      -o telemetry_sim
+ *
+ * usage: telemetry_sim [--events n] [--seed n] [--decoder path]
+ *                      [--python command]
+ *
+ * @copyright Copyright (c) 2020 Particle Industries, Inc.  All rights reserved.
+ */
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <string>
+#include <vector>
+
+#include "ButtonTelemetry.h"
+
+#define SIM_DEFAULT_EVENTS 40
+#define SIM_DEFAULT_DECODER "tools/telemetry_decode.py"
+#define SIM_DEFAULT_PYTHON "python3"
+//Worst case header and histograms of a blob, plus the events
+#define SIM_BLOB_SIZE (1 + 4*5 + 1 + 2*TELEMETRY_MAX_CLICKS*5 + 5 + \
+                        TELEMETRY_BUFFER_SIZE)
+//Milli secs before the wrap of millis() the last interval starts at
+#define SIM_WRAP_LEAD_MS 5000
+
+static uint32_t sim_seed = 1;
+static const char* sim_decoder = SIM_DEFAULT_DECODER;
+static const char* sim_python = SIM_DEFAULT_PYTHON;
+
+static uint32_t sim_random(uint32_t range)
+{
+    sim_seed = sim_seed * 1103515245 + 12345;
+    return (sim_seed >> 8) % range;
+}
+
+static std::string sim_format(const char* format, ...)
+    __attribute__((format(printf, 1, 2)));
+
+static std::string sim_format(const char* format, ...)
+{
+    char line[128];
+    va_list args;
+    va_start(args, format);
+    vsnprintf(line, sizeof(line), format, args);
+    va_end(args);
+    return line;
+}
+
+//Gaps of every varint length, mostly short
+static uint32_t sim_gap()
+{
+    switch(sim_random(8)) {
+        case 0: return 0;
+        case 1: return 128 + sim_random(16384);
+        case 2: return 16384 + sim_random(2000000);
+        case 3: return 3000000 + sim_random(300000000);
+        default: return sim_random(128);
+    }
+}
+
+static int sim_sequence()
+{
+    int clicks = 1 + ((sim_random(4)) ? sim_random(3) :
+                                        sim_random(TELEMETRY_MAX_CLICKS + 4));
+    return (sim_random(3)) ? clicks : -clicks;
+}
+
+//The report of print_report() in tools/telemetry_decode.py
+static std::vector<std::string> sim_report(uint32_t start, uint32_t duration,
+        uint32_t count, uint32_t dropped, const uint32_t* short_hist,
+        const uint32_t* long_hist, const std::vector<std::string>& events)
+{
+    std::vector<std::string> lines;
+    lines.push_back(sim_format("interval start %lu ms, duration %lu ms",
+                    (unsigned long)start, (unsigned long)duration));
+    lines.push_back(sim_format("events %lu, dropped %lu",
+                    (unsigned long)count, (unsigned long)dropped));
+    lines.push_back("clicks   short    long");
+    for(int i = 0; i < TELEMETRY_MAX_CLICKS; i++) {
+        std::string label = sim_format("%d%s", i + 1,
+                                (i == TELEMETRY_MAX_CLICKS - 1) ? "+" : "");
+        lines.push_back(sim_format("%-6s %7lu %7lu", label.c_str(),
+                        (unsigned long)short_hist[i],
+                        (unsigned long)long_hist[i]));
+    }
+    lines.insert(lines.end(), events.begin(), events.end());
+    return lines;
+}
+
+//Decode a blob with the Python tool, one string per line of its report
+static bool sim_decode(const uint8_t* blob, size_t len,
+                        std::vector<std::string>& lines)
+{
+    char path[] = "/tmp/telemetry_sim_XXXXXX";
+    int fd = mkstemp(path);
+    if(fd < 0) {
+        perror("mkstemp");
+        return false;
+    }
+    bool ok = write(fd, blob, len) == (ssize_t)len;
+    close(fd);
+
+    std::string command = std::string(sim_python) + " " + sim_decoder + " " +
+                            path;
+    FILE* in = (ok) ? popen(command.c_str(), "r") : NULL;
+    if(in) {
+        char line[256];
+        while(fgets(line, sizeof(line), in)) {
+            line[strcspn(line, "\n")] = 0;
+            lines.push_back(line);
+        }
+        ok = pclose(in) == 0;
+    }
+    else {
+        ok = false;
+    }
+    unlink(path);
+    return ok;
+}
+
+//Records events from start_ms and checks the decoded report
+static bool run(const char* name, uint64_t start_ms, uint32_t events)
+{
+    static ButtonTelemetry telemetry;
+    uint32_t short_hist[TELEMETRY_MAX_CLICKS] = {};
+    uint32_t long_hist[TELEMETRY_MAX_CLICKS] = {};
+    std::vector<std::string> stored;
+    uint32_t dropped = 0;
+
+    host_set_micros(start_ms * 1000);
+    telemetry.reset();
+    for(uint32_t i = 0; i < events; i++) {
+        host_advance_micros((uint64_t)sim_gap() * 1000 + sim_random(1000));
+        uint8_t button = sim_random(256);
+        int sequence = sim_sequence();
+        uint32_t clicks = (sequence < 0) ? -sequence : sequence;
+        uint32_t bin = (clicks < TELEMETRY_MAX_CLICKS) ? clicks - 1 :
+                                                TELEMETRY_MAX_CLICKS - 1;
+        ((sequence < 0) ? long_hist : short_hist)[bin]++;
+        if(telemetry.record(button, sequence)) {
+            stored.push_back(sim_format("%10lu ms  button %3u  %s x%lu",
+                            (unsigned long)millis(), (unsigned)button,
+                            (sequence < 0) ? "long" : "short",
+                            (unsigned long)clicks));
+        }
+        else {
+            dropped++;
+        }
+    }
+    host_advance_micros((uint64_t)sim_gap() * 1000);
+
+    uint8_t blob[SIM_BLOB_SIZE];
+    size_t len = telemetry.serialize(blob, sizeof(blob));
+    std::vector<std::string> want = sim_report((uint32_t)start_ms,
+                            millis() - (uint32_t)start_ms, events, dropped,
+                            short_hist, long_hist, stored);
+    std::vector<std::string> got;
+    bool ok = len > 0 && sim_decode(blob, len, got);
+    ok &= telemetry.event_count() == events;
+    ok &= telemetry.dropped_count() == dropped;
+    ok &= got == want;
+
+    printf("%-8s %3lu events, %3lu dropped, %4zu bytes  %s\n", name,
+            (unsigned long)events, (unsigned long)dropped, len,
+            (ok) ? "ok" : "MISMATCH");
+    for(size_t i = 0; !ok && i < want.size() && i < got.size(); i++) {
+        if(got[i] != want[i]) {
+            printf("  expected: %s\n  decoded:  %s\n", want[i].c_str(),
+                    got[i].c_str());
+            break;
+        }
+    }
+    return ok;
+}
+
+int main(int argc, char** argv)
+{
+    uint32_t events = SIM_DEFAULT_EVENTS;
+
+    for(int i = 1; i < argc; i++) {
+        bool has_value = i + 1 < argc;
+        if(!strcmp(argv[i], "--events") && has_value) {
+            events = strtoul(argv[++i], NULL, 0);
+        }
+        else if(!strcmp(argv[i], "--seed") && has_value) {
+            sim_seed = strtoul(argv[++i], NULL, 0);
+        }
+        else if(!strcmp(argv[i], "--decoder") && has_value) {
+            sim_decoder = argv[++i];
+        }
+        else if(!strcmp(argv[i], "--python") && has_value) {
+            sim_python = argv[++i];
+        }
+        else {
+            fprintf(stderr, "usage: %s [--events n] [--seed n] "
+                "[--decoder path] [--python command]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    bool ok = true;
+    ok &= run("fits", 1000 + sim_random(100000), events);
+    //every event takes at least 3 bytes, this many cannot fit
+    ok &= run("full", sim_random(100000), TELEMETRY_BUFFER_SIZE / 3 + events);
+    ok &= run("wrap", 0x100000000ULL - SIM_WRAP_LEAD_MS, events);
+    printf("%s\n", (ok) ? "ok" : "MISMATCH");
+    return (ok) ? 0 : 1;
+}
@@ -0,0 +1,122 @@
+#!/usr/bin/env python3
+"""
+Decode a ButtonTelemetry blob produced by ButtonTelemetry::serialize().
+
+The blob can be given as a binary file, or as a hex or base64 string (as it
+is usually sent in a publish). See src/ButtonTelemetry.cpp for the layout.
+
+usage: telemetry_decode.py <file | hex | base64> [--json]
+"""
+
+import base64
+import binascii
+import json
+import os
+import sys
+
+FORMAT_VERSION = 1
+
+
+class Reader:
+    def __init__(self, data):
+        self.data = data
+        self.pos = 0
+
+    def byte(self):
+        if self.pos >= len(self.data):
+            raise ValueError("truncated blob at offset %d" % self.pos)
+        value = self.data[self.pos]
+        self.pos += 1
+        return value
+
+    def varint(self):
+        value = 0
+        shift = 0
+        while True:
+            b = self.byte()
+            value |= (b & 0x7F) << shift
+            if not b & 0x80:
+                return value
+            shift += 7
+            if shift > 35:
+                raise ValueError("varint too long at offset %d" % self.pos)
+
+
+def unzigzag(value):
+    return (value >> 1) ^ -(value & 1)
+
+
+def decode(data):
+    r = Reader(data)
+    version = r.byte()
+    if version != FORMAT_VERSION:
+        raise ValueError("unsupported format version %d" % version)
+
+    out = {
+        "start_ms": r.varint(),
+        "duration_ms": r.varint(),
+        "event_count": r.varint(),
+        "dropped": r.varint(),
+    }
+    bins = r.byte()
+    out["short_histogram"] = [r.varint() for _ in range(bins)]
+    out["long_histogram"] = [r.varint() for _ in range(bins)]
+
+    end = r.varint() + r.pos
+    if end > len(data):
+        raise ValueError("event section runs past end of blob")
+
+    events = []
+    timestamp = out["start_ms"]
+    while r.pos < end:
+        timestamp = (timestamp + r.varint()) & 0xFFFFFFFF
+        button = r.byte()
+        sequence = unzigzag(r.varint())
+        events.append({"time_ms": timestamp, "button": button,
+                       "sequence": sequence})
+    out["events"] = events
+    return out
+
+
+def load(arg):
+    if os.path.isfile(arg):
+        with open(arg, "rb") as f:
+            return f.read()
+    text = arg.strip()
+    try:
+        return binascii.unhexlify(text)
+    except (binascii.Error, ValueError):
+        return base64.b64decode(text, validate=True)
+
+
+def print_report(out):
+    print("interval start %d ms, duration %d ms" %
+          (out["start_ms"], out["duration_ms"]))
+    print("events %d, dropped %d" % (out["event_count"], out["dropped"]))
+    bins = len(out["short_histogram"])
+    print("clicks   short    long")
+    for i in range(bins):
+        label = "%d+" % (i + 1) if i == bins - 1 else "%d" % (i + 1)
+        print("%-6s %7d %7d" % (label, out["short_histogram"][i],
+                                out["long_histogram"][i]))
+    for e in out["events"]:
+        kind = "long" if e["sequence"] < 0 else "short"
+        print("%10d ms  button %3d  %s x%d" %
+              (e["time_ms"], e["button"], kind, abs(e["sequence"])))
+
+
+def main(argv):
+    args = [a for a in argv[1:] if not a.startswith("--")]
+    if len(args) != 1:
+        print(__doc__.strip(), file=sys.stderr)
+        return 2
+    out = decode(load(args[0]))
+    if "--json" in argv:
+        print(json.dumps(out, indent=2))
+    else:
+        print_report(out)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv))
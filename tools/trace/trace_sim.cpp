@@ -0,0 +1,295 @@
+/**
+ * @file trace_sim.cpp
+ * @author Ed Ablan
+ * @version 1.0
+ * @date 10/17/2026
+ *
+ * @brief Round trips button_trace_dump() through tools/trace_timeline.py on
+ * the host
+ *
+ * @details Random records of every trace id of ButtonTraceId and of user ids
+ * are written at random times of the fake clock, with random arguments and
+ * a few instances. Four dumps are run: an empty ring, one that fits the
+ * ring, one that overwrote older records and one across the wrap of
+ * micros(). Each dump is written to a file behind some serial noise, its
+ * size must be the 16 byte header plus 12 bytes per record, and it is
+ * rendered with the Python tool both as a timeline and with --csv. Both
+ * renderings must match the ones expected from the records written line for
+ * line, so the header, the record layout and the trace ids of the C++ and
+ * Python sides cannot drift apart. Exits with 1 on a mismatch.
+ *
+ * Build from the repository root:
+ *  g++ -O2 -std=c++14 -DBUTTON_TRACE_ENABLE -Itools/host -Isrc
+ *      tools/host/host.cpp src/ButtonTrace.cpp tools/trace/trace_sim.cpp
+ *      -o trace_sim
+ *
+ * usage: trace_sim [--seed n] [--timeline path] [--python command]
+ *
+ * @copyright Copyright (c) 2020 Particle Industries, Inc.  All rights reserved.
+ */
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "ButtonTrace.h"
+
+#ifndef BUTTON_TRACE_ENABLE
+#error "build trace_sim with -DBUTTON_TRACE_ENABLE"
+#endif
+
+#define SIM_DEFAULT_TIMELINE "tools/trace_timeline.py"
+#define SIM_DEFAULT_PYTHON "python3"
+//Size of the dump header, magic, version, count and overwritten
+#define SIM_HEADER_SIZE 16
+//Instances the records are spread over
+#define SIM_INSTANCES 3
+//Micro secs before the wrap of micros() the last dump starts at
+#define SIM_WRAP_LEAD_US 50000
+
+//Names of the trace ids in tools/trace_timeline.py
+struct SimTraceName {
+    uint16_t id;
+    const char* name;
+    const char* arg_name;       //NULL if arg0 is not shown
+};
+
+static const SimTraceName sim_names[] = {
+    {TRACE_DEBOUNCE_RAW, "debounce raw", "level"},
+    {TRACE_DEBOUNCE_STABLE, "debounce stable", "level"},
+    {TRACE_SEQUENCE_PRESS, "press", "clicks"},
+    {TRACE_SEQUENCE_RELEASE, "release", "clicks"},
+    {TRACE_SEQUENCE_SHORT, "short sequence", "clicks"},
+    {TRACE_SEQUENCE_LONG, "long sequence", "clicks"},
+    {TRACE_SEQUENCE_STUCK, "stuck", NULL},
+};
+
+#define SIM_NAMES (sizeof(sim_names) / sizeof(sim_names[0]))
+
+class FilePrint : public Print {
+public:
+    explicit FilePrint(int fd) : fd(fd) {}
+    size_t write(uint8_t c) override {
+        return write(&c, 1);
+    }
+    size_t write(const uint8_t* buffer, size_t size) override {
+        ssize_t written = ::write(fd, buffer, size);
+        ok &= written == (ssize_t)size;
+        bytes += size;
+        return size;
+    }
+    int fd;
+    size_t bytes = 0;
+    bool ok = true;
+};
+
+static uint32_t sim_seed = 1;
+static const char* sim_timeline = SIM_DEFAULT_TIMELINE;
+static const char* sim_python = SIM_DEFAULT_PYTHON;
+
+static uint32_t sim_random(uint32_t range)
+{
+    sim_seed = sim_seed * 1103515245 + 12345;
+    return (sim_seed >> 8) % range;
+}
+
+static std::string sim_format(const char* format, ...)
+    __attribute__((format(printf, 1, 2)));
+
+static std::string sim_format(const char* format, ...)
+{
+    char line[128];
+    va_list args;
+    va_start(args, format);
+    vsnprintf(line, sizeof(line), format, args);
+    va_end(args);
+    return line;
+}
+
+//Writes a random record and keeps it
+static void sim_trace(std::vector<ButtonTraceRecord>& written,
+                        const uint32_t* instances)
+{
+    //mostly short gaps, sometimes past a few secs
+    host_advance_micros((sim_random(8)) ? sim_random(2000) :
+                                            sim_random(5000000));
+    uint32_t pick = sim_random(SIM_NAMES + 2);
+    uint16_t id = (pick < SIM_NAMES) ? sim_names[pick].id :
+                                        TRACE_USER + sim_random(0x100);
+    uint16_t arg0 = (sim_random(4)) ? sim_random(8) : sim_random(0x10000);
+    uint32_t arg1 = (id < TRACE_USER) ? instances[sim_random(SIM_INSTANCES)] :
+                    (sim_seed * 2654435761U);
+    BUTTON_TRACE(id, arg0, arg1);
+    written.push_back({micros(), id, arg0, arg1});
+}
+
+//The output of render() in tools/trace_timeline.py
+static std::vector<std::string> sim_render(
+        const std::vector<ButtonTraceRecord>& records, uint32_t overwritten,
+        bool csv)
+{
+    std::vector<std::string> lines;
+    if(records.empty()) {
+        lines.push_back("empty trace");
+        return lines;
+    }
+    if(csv) {
+        lines.push_back("time_us,instance,event,arg0,arg1");
+    }
+    else if(overwritten) {
+        lines.push_back(sim_format("(%lu older records were overwritten)",
+                        (unsigned long)overwritten));
+    }
+    std::map<uint32_t, std::string> instances;
+    uint32_t base = records[0].timestamp;
+    uint32_t last = base;
+    for(const ButtonTraceRecord& record : records) {
+        uint32_t elapsed = record.timestamp - base;
+        uint32_t delta = record.timestamp - last;
+        last = record.timestamp;
+        std::string name, instance;
+        const char* arg_name = "arg0";
+        if(record.id >= TRACE_USER) {
+            name = sim_format("user %d", record.id - TRACE_USER);
+            instance = sim_format("0x%08lx", (unsigned long)record.arg1);
+        }
+        else {
+            for(size_t i = 0; i < SIM_NAMES; i++) {
+                if(sim_names[i].id == record.id) {
+                    name = sim_names[i].name;
+                    arg_name = sim_names[i].arg_name;
+                }
+            }
+            if(!instances.count(record.arg1)) {
+                size_t next = instances.size();
+                instances[record.arg1] = sim_format("btn%zu", next);
+            }
+            instance = instances[record.arg1];
+        }
+        if(csv) {
+            lines.push_back(sim_format("%lu,%s,%s,%u,%lu",
+                            (unsigned long)elapsed, instance.c_str(),
+                            name.c_str(), (unsigned)record.arg0,
+                            (unsigned long)record.arg1));
+            continue;
+        }
+        std::string detail = (arg_name) ?
+                    sim_format("%s=%u", arg_name, (unsigned)record.arg0) : "";
+        lines.push_back(sim_format("%12.3f ms  +%9.3f  %-8s %-16s %s",
+                        elapsed / 1000.0, delta / 1000.0, instance.c_str(),
+                        name.c_str(), detail.c_str()));
+    }
+    return lines;
+}
+
+//Renders a dump with the Python tool, one string per line of its output
+static bool sim_run_timeline(const char* path, bool csv,
+                                std::vector<std::string>& lines)
+{
+    std::string command = std::string(sim_python) + " " + sim_timeline + " " +
+                            path + ((csv) ? " --csv" : "");
+    FILE* in = popen(command.c_str(), "r");
+    if(!in) {
+        return false;
+    }
+    char line[256];
+    while(fgets(line, sizeof(line), in)) {
+        line[strcspn(line, "\n")] = 0;
+        lines.push_back(line);
+    }
+    return pclose(in) == 0;
+}
+
+//Writes records random records from start_us and checks the rendered dump
+static bool run(const char* name, uint64_t start_us, uint32_t records)
+{
+    //heap like addresses of the traced instances
+    uint32_t instances[SIM_INSTANCES];
+    for(uint32_t i = 0; i < SIM_INSTANCES; i++) {
+        instances[i] = 0x20000000 + sim_random(0x10000) * 8;
+    }
+    std::vector<ButtonTraceRecord> written;
+    host_set_micros(start_us);
+    button_trace_clear();
+    for(uint32_t i = 0; i < records; i++) {
+        sim_trace(written, instances);
+    }
+    uint32_t overwritten = (records > BUTTON_TRACE_SIZE) ?
+                                records - BUTTON_TRACE_SIZE : 0;
+    std::vector<ButtonTraceRecord> kept(written.begin() + overwritten,
+                                        written.end());
+
+    char path[] = "/tmp/trace_sim_XXXXXX";
+    int fd = mkstemp(path);
+    if(fd < 0) {
+        perror("mkstemp");
+        return false;
+    }
+    //the tool skips whatever the serial port caught before the header
+    FilePrint out(fd);
+    const char* noise = "\r\nboot ok\r\n";
+    out.write((const uint8_t*)noise, strlen(noise));
+    size_t before = out.bytes;
+    size_t count = button_trace_dump(out);
+    close(fd);
+    bool ok = out.ok && count == kept.size() &&
+            out.bytes - before == SIM_HEADER_SIZE +
+                                    kept.size() * sizeof(ButtonTraceRecord);
+
+    std::vector<std::string> timeline, csv;
+    ok &= sim_run_timeline(path, false, timeline);
+    ok &= sim_run_timeline(path, true, csv);
+    unlink(path);
+    std::vector<std::string> want_timeline = sim_render(kept, overwritten,
+                                                        false);
+    std::vector<std::string> want_csv = sim_render(kept, overwritten, true);
+    ok &= timeline == want_timeline && csv == want_csv;
+
+    printf("%-12s %4lu records, %4lu overwritten  %s\n", name,
+            (unsigned long)records, (unsigned long)overwritten,
+            (ok) ? "ok" : "MISMATCH");
+    for(size_t i = 0; !ok && i < want_timeline.size() &&
+                        i < timeline.size(); i++) {
+        if(timeline[i] != want_timeline[i]) {
+            printf("  expected: %s\n  rendered: %s\n",
+                    want_timeline[i].c_str(), timeline[i].c_str());
+            break;
+        }
+    }
+    return ok;
+}
+
+int main(int argc, char** argv)
+{
+    for(int i = 1; i < argc; i++) {
+        bool has_value = i + 1 < argc;
+        if(!strcmp(argv[i], "--seed") && has_value) {
+            sim_seed = strtoul(argv[++i], NULL, 0);
+        }
+        else if(!strcmp(argv[i], "--timeline") && has_value) {
+            sim_timeline = argv[++i];
+        }
+        else if(!strcmp(argv[i], "--python") && has_value) {
+            sim_python = argv[++i];
+        }
+        else {
+            fprintf(stderr, "usage: %s [--seed n] [--timeline path] "
+                "[--python command]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    bool ok = run("empty", sim_random(1000000), 0);
+    ok &= run("fits", sim_random(1000000), BUTTON_TRACE_SIZE / 2);
+    ok &= run("overwritten", sim_random(1000000),
+                BUTTON_TRACE_SIZE * 2 + sim_random(BUTTON_TRACE_SIZE));
+    ok &= run("wrap", 0x100000000ULL - SIM_WRAP_LEAD_US, BUTTON_TRACE_SIZE);
+    printf("%s\n", (ok) ? "ok" : "MISMATCH");
+    return (ok) ? 0 : 1;
+}
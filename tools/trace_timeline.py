@@ -0,0 +1,93 @@
+#!/usr/bin/env python3
+"""
+Render a button trace dump written by button_trace_dump() as a timeline.
+
+The dump can be a raw capture of the serial port; everything before the
+trace header is skipped. See src/ButtonTrace.h for the trace ids.
+
+usage: trace_timeline.py <dump file> [--csv]
+"""
+
+import struct
+import sys
+
+MAGIC = 0x43525442
+VERSION = 1
+HEADER = struct.Struct("<IIII")
+RECORD = struct.Struct("<IHHI")
+
+# keep in sync with ButtonTraceId in src/ButtonTrace.h
+TRACE_NAMES = {
+    1: ("debounce raw", "level"),
+    2: ("debounce stable", "level"),
+    3: ("press", "clicks"),
+    4: ("release", "clicks"),
+    5: ("short sequence", "clicks"),
+    6: ("long sequence", "clicks"),
+    7: ("stuck", None),
+}
+TRACE_USER = 0x100
+
+
+def parse(data):
+    start = data.find(struct.pack("<I", MAGIC))
+    if start < 0:
+        raise ValueError("no trace header found")
+    magic, version, count, overwritten = HEADER.unpack_from(data, start)
+    record_size = version >> 16
+    version &= 0xFFFF
+    if version != VERSION or record_size != RECORD.size:
+        raise ValueError("unsupported trace version %d / record size %d" %
+                         (version, record_size))
+    pos = start + HEADER.size
+    if pos + count * RECORD.size > len(data):
+        raise ValueError("dump truncated, %d records expected" % count)
+    records = [RECORD.unpack_from(data, pos + i * RECORD.size)
+               for i in range(count)]
+    return records, overwritten
+
+
+def render(records, overwritten, csv=False):
+    if not records:
+        print("empty trace")
+        return
+    instances = {}
+    base = records[0][0]
+    if csv:
+        print("time_us,instance,event,arg0,arg1")
+    elif overwritten:
+        print("(%d older records were overwritten)" % overwritten)
+    last = base
+    for timestamp, trace_id, arg0, arg1 in records:
+        # micros() wraps, keep the timeline increasing
+        elapsed = (timestamp - base) & 0xFFFFFFFF
+        delta = (timestamp - last) & 0xFFFFFFFF
+        last = timestamp
+        if trace_id >= TRACE_USER:
+            name, arg_name = "user %d" % (trace_id - TRACE_USER), "arg0"
+            instance = "0x%08x" % arg1
+        else:
+            name, arg_name = TRACE_NAMES.get(trace_id, ("id %d" % trace_id,
+                                                        "arg0"))
+            instance = instances.setdefault(arg1, "btn%d" % len(instances))
+        if csv:
+            print("%d,%s,%s,%d,%d" % (elapsed, instance, name, arg0, arg1))
+            continue
+        detail = "%s=%d" % (arg_name, arg0) if arg_name else ""
+        print("%12.3f ms  +%9.3f  %-8s %-16s %s" %
+              (elapsed / 1000.0, delta / 1000.0, instance, name, detail))
+
+
+def main(argv):
+    args = [a for a in argv[1:] if not a.startswith("--")]
+    if len(args) != 1:
+        print(__doc__.strip(), file=sys.stderr)
+        return 2
+    with open(args[0], "rb") as f:
+        records, overwritten = parse(f.read())
+    render(records, overwritten, "--csv" in argv)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv))